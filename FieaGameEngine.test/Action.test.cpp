@@ -21,11 +21,11 @@ namespace ActionTest
 
 		TEST_METHOD_INITIALIZE(Initialize)
 		{
-			TypeManager::add(GameObject::TypeIdClass(), GameObject::Signatures());
-			TypeManager::add(Action::TypeIdClass(), Action::Signatures());
-			TypeManager::add(ActionIncrement::TypeIdClass(), ActionIncrement::Signatures());
-			TypeManager::add(ActionList::TypeIdClass(), ActionList::Signatures());
-			TypeManager::add(ActionListWhile::TypeIdClass(), ActionListWhile::Signatures());
+			TypeManager::add<GameObject>();
+			TypeManager::add<Action>();
+			TypeManager::add<ActionIncrement>();
+			TypeManager::add<ActionList>();
+			TypeManager::add<ActionListWhile>();
 #if defined(DEBUG) || defined(_DEBUG)
 			_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF);
 			_CrtMemCheckpoint(&_startMemState);
@@ -298,6 +298,42 @@ namespace ActionTest
 			Assert::ExpectException<std::invalid_argument>([&Player, &time] { Player->Update(time); });
 		}
 
+		TEST_METHOD(ActionListWhileSleeps) {
+			// Without a Preamble the loop sleeps once its condition is zero, until the condition is set again
+			GameObject* object = new GameObject();
+			object->AppendAuxiliaryAttribute("Loops") = 3;
+			object->AppendAuxiliaryAttribute("Count") = 0;
+			ActionListWhile* loop = new ActionListWhile();
+			loop->SetCondition("Loops");
+			ActionIncrement* body = new ActionIncrement();
+			body->SetParent(object);
+			body->SetDatumKey("Count");
+			body->SetValue(1.0f);
+			loop->AppendScope("Actions").Adopt(*body, "Body");
+			object->AppendScope("Actions").Adopt(*loop, "Loop");
+
+			GameClock clock;
+			GameTime time = clock.Current();
+			object->Update(time);
+			Assert::AreEqual(object->Find("Count")->Get<int>(), 3);
+			Assert::IsTrue(loop->IsAsleep());
+			object->Update(time);
+			Assert::IsTrue(loop->IsAsleep());
+
+			*object->Find("Loops") = 2;
+			object->Update(time);
+			Assert::AreEqual(object->Find("Count")->Get<int>(), 5);
+			Assert::IsTrue(loop->IsAsleep());
+
+			// Setting the condition wakes it too
+			loop->SetCondition("Loops");
+			Assert::IsFalse(loop->IsAsleep());
+			object->Update(time);
+			Assert::AreEqual(object->Find("Count")->Get<int>(), 5);
+			Assert::IsTrue(loop->IsAsleep());
+			delete object;
+		}
+
 
 	private:
 		inline static _CrtMemState _startMemState;
@@ -0,0 +1,229 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "Benchmark.h"
+#include "AttributePath.h"
+#include "TestTypes.h"
+#include <chrono>
+#include <regex>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Fiea::GameEngine;
+
+namespace AttributePathTest
+{
+	TEST_CLASS(AttributePathTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(Initialize)
+		{
+#if defined(DEBUG) || defined(_DEBUG)
+			_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF);
+			_CrtMemCheckpoint(&_startMemState);
+#endif
+		}
+
+		TEST_METHOD_CLEANUP(Cleanup)
+		{
+#if defined(DEBUG) || defined(_DEBUG)
+			_CrtMemState endMemState, diffMemState;
+			_CrtMemCheckpoint(&endMemState);
+			if (_CrtMemDifference(&diffMemState, &_startMemState, &endMemState))
+			{
+				_CrtDumpMemoryLeaks();
+				_CrtMemDumpStatistics(&diffMemState);
+				Assert::Fail(L"Memory Leaks!");
+			}
+#endif
+		}
+
+		TEST_METHOD(Parse) {
+			AttributePath path("Stats[2].Health[1]");
+			Assert::AreEqual(path.Segments().size(), (size_t)2);
+			Assert::IsTrue(path.Segments()[0].Key == Symbol("Stats"));
+			Assert::AreEqual(path.Segments()[0].Index, (size_t)2);
+			Assert::IsTrue(path.Segments()[1].Key == Symbol("Health"));
+			Assert::AreEqual(path.Index(), (size_t)1);
+			Assert::AreEqual(path.ToString(), std::string("Stats[2].Health[1]"));
+
+			path.Parse("Health");
+			Assert::AreEqual(path.Segments().size(), (size_t)1);
+			Assert::AreEqual(path.Index(), (size_t)0);
+
+			path.Parse("");
+			Assert::IsTrue(path.Empty());
+
+			// Malformed paths throw and keep the previous path
+			path.Parse("Sword.Damage");
+			Assert::ExpectException<std::invalid_argument>([&path] { path.Parse("Array[gg]"); });
+			Assert::ExpectException<std::invalid_argument>([&path] { path.Parse("Array[]"); });
+			Assert::ExpectException<std::invalid_argument>([&path] { path.Parse("Array[1"); });
+			Assert::ExpectException<std::invalid_argument>([&path] { path.Parse("Array1]"); });
+			Assert::ExpectException<std::invalid_argument>([&path] { path.Parse("Array[1]x"); });
+			Assert::ExpectException<std::invalid_argument>([&path] { path.Parse("[1]"); });
+			Assert::ExpectException<std::invalid_argument>([&path] { path.Parse("Sword..Damage"); });
+			Assert::ExpectException<std::invalid_argument>([&path] { path.Parse("Sword."); });
+			Assert::ExpectException<std::invalid_argument>([&path] { path.Parse(".Damage"); });
+			Assert::AreEqual(path.ToString(), std::string("Sword.Damage"));
+		}
+
+		TEST_METHOD(Resolve) {
+			for (Scope::Storage storage : { Scope::Storage::Hashed, Scope::Storage::Flat }) {
+				Scope root(0, storage);
+				root.Append("Gravity") = 9.8f;
+				Scope& items = root.AppendScope("Items");
+				root.AppendScope("Items").Append("Name") = std::string("Shield");
+				items.Append("Name") = std::string("Potion");
+				Scope& stats = root.AppendScope("Stats");
+				Datum& health = stats.Append("Health");
+				health = 100;
+				health.Push(50);
+
+				AttributePath gravity("Gravity");
+				AttributePath shield("Items[1].Name");
+				AttributePath mana("Stats.Health[1]");
+				Assert::IsTrue(gravity.Resolve(root) == root.Find("Gravity"));
+				Assert::AreEqual(shield.Resolve(root)->GetString(), std::string("Shield"));
+				Assert::IsTrue(mana.Resolve(root) == &health);
+				Assert::AreEqual(mana.Index(), (size_t)1);
+
+				// First keys are Searched, so inherited attributes resolve too
+				Assert::IsTrue(gravity.Resolve(stats) == root.Find("Gravity"));
+
+				// Anything missing, or a key that names no nested Scope, is nullptr
+				Assert::IsNull(AttributePath("Stats.Mana").Resolve(root));
+				Assert::IsNull(AttributePath("Items[2].Name").Resolve(root));
+				Assert::IsNull(AttributePath("Gravity.Name").Resolve(root));
+				Assert::IsNull(AttributePath().Resolve(root));
+
+				// Named children inside wrapper Scopes, the way GameObjects keep theirs
+				Scope& sword = root.AppendScope("Children").AppendScope("Sword");
+				sword.Append("Damage") = 12;
+				AttributePath damage("Sword.Damage");
+				Assert::IsNull(damage.Resolve(root));
+				Assert::IsTrue(damage.Resolve(root, Symbol("Children")) == sword.Find("Damage"));
+			}
+		}
+
+		TEST_METHOD(Revalidation) {
+			Scope root;
+			root.Append("Gravity") = 9.8f;
+			Scope& stats = root.AppendScope("Stats");
+			stats.Append("Health") = 100;
+
+			AttributePath health("Stats.Health");
+			AttributePath gravity("Gravity");
+			Datum* found = health.Resolve(root);
+			Assert::IsTrue(gravity.Resolve(stats) == root.Find("Gravity"));
+
+			// Unchanged Scopes hand the same Datum back without any lookup
+			Scope::ResetSearchStats();
+			Assert::IsTrue(health.Resolve(root) == found);
+			Assert::IsTrue(gravity.Resolve(stats) == root.Find("Gravity"));
+			Assert::AreEqual(Scope::GetSearchStats().Hits + Scope::GetSearchStats().Misses, (size_t)0);
+
+			// A new key on the way walks the path again
+			stats.Append("Mana") = 20;
+			Assert::IsTrue(health.Resolve(root) == found);
+			Assert::AreEqual(Scope::GetSearchStats().Hits + Scope::GetSearchStats().Misses, (size_t)1);
+
+			// So does shadowing an inherited attribute
+			Datum& shadow = stats.Append("Gravity");
+			shadow = 1.6f;
+			Assert::IsTrue(gravity.Resolve(stats) == &shadow);
+
+			// Replacing the nested Scope
+			Scope* old = stats.Orphan();
+			Scope& replacement = root.AppendScope("Stats");
+			replacement.Append("Health") = 5;
+			Assert::AreEqual(health.Resolve(root)->GetInt(), 5);
+			Assert::IsTrue(gravity.Resolve(*old) == &shadow);
+			delete old;
+
+			// Writing through a resolved path after sharing copies the Datum first
+			Scope* clone = root.CloneShared();
+			int newHealth = 6;
+			float newGravity = 3.7f;
+			health.Resolve(root)->Set(0, newHealth);
+			gravity.Resolve(root)->Set(0, newGravity);
+			Assert::AreEqual(clone->Find("Stats")->GetScope()->Find("Health")->GetInt(), 5);
+			Assert::AreEqual(clone->Find("Gravity")->GetFloat(), 9.8f);
+			Assert::AreEqual(root.Find("Stats")->GetScope()->Find("Health")->GetInt(), 6);
+			Assert::AreEqual(health.Resolve(*clone)->GetInt(), 5);
+			delete clone;
+
+			// Another root, or a new path, starts over
+			Scope other;
+			other.AppendScope("Stats").Append("Health") = 1;
+			Assert::AreEqual(health.Resolve(other)->GetInt(), 1);
+			health.Parse("Gravity");
+			Assert::AreEqual(health.Resolve(other), (Datum*)nullptr);
+
+			// So does a Scope made where a resolved root used to be
+			alignas(Scope) unsigned char storage[sizeof(Scope)];
+			Scope* first = new(storage) Scope;
+			first->Append("Gravity") = 1.0f;
+			Assert::AreEqual(gravity.Resolve(*first)->GetFloat(), 1.0f);
+			first->~Scope();
+			Scope* second = new(storage) Scope;
+			second->Append("Wind") = 0.5f;
+			second->Append("Gravity") = 2.0f;
+			Assert::IsTrue(second == first);
+			Assert::IsTrue(gravity.Resolve(*second) == second->Find("Gravity"));
+			second->~Scope();
+			Scope::ResetSearchStats();
+		}
+
+		BENCHMARK_METHOD(Benchmark) {
+			// What ActionIncrement did per frame (parse the key with a regex, then Search) against a cached AttributePath
+			Scope root;
+			Scope& player = root.AppendScope("Player");
+			Datum& array = player.Append("IncrementArrayTest");
+			for (int i = 0; i < 4; ++i) {
+				array.Push(i);
+			}
+			player.AppendScope("Children").AppendScope("Sword").Append("Damage") = 12;
+			const Symbol children("Children");
+			const size_t frames = 10000;
+
+			const std::string key = "IncrementArrayTest[2]";
+			size_t sum = 0;
+			auto start = std::chrono::steady_clock::now();
+			for (size_t f = 0; f < frames; ++f) {
+				std::regex rgx("\\[(\\d+)\\]");
+				std::smatch match;
+				if (std::regex_search(key, match, rgx)) {
+					size_t idx = std::stoi(match[1].str());
+					sum += player.Search(std::string_view(key).substr(0, key.find_first_of("[")))->GetInt(idx);
+				}
+			}
+			auto parsed = std::chrono::steady_clock::now();
+			AttributePath path(key);
+			for (size_t f = 0; f < frames; ++f) {
+				sum += path.Resolve(player, children)->GetInt(path.Index());
+			}
+			auto resolved = std::chrono::steady_clock::now();
+
+			AttributePath dotted("Sword.Damage");
+			for (size_t f = 0; f < frames; ++f) {
+				sum += dotted.Resolve(player, children)->GetInt();
+			}
+			auto resolvedDotted = std::chrono::steady_clock::now();
+			for (size_t f = 0; f < frames; ++f) {
+				dotted.Invalidate();
+				sum += dotted.Resolve(player, children)->GetInt();
+			}
+			auto walked = std::chrono::steady_clock::now();
+			Assert::AreEqual(sum, frames * (2 + 2 + 12 + 12));
+			Scope::ResetSearchStats();
+
+			auto ms = [](auto from, auto to) { return std::to_string(std::chrono::duration<double, std::milli>(to - from).count()); };
+			std::string message = "10k frames: regex + Search " + ms(start, parsed) + " ms, AttributePath " + ms(parsed, resolved)
+				+ " ms, dotted AttributePath " + ms(resolved, resolvedDotted) + " ms, dotted uncached walk " + ms(resolvedDotted, walked) + " ms";
+			Logger::WriteMessage(message.c_str());
+		}
+
+	private:
+		inline static _CrtMemState _startMemState;
+	};
+}
@@ -14,7 +14,7 @@ namespace AttributedTest
 
 		TEST_METHOD_INITIALIZE(Initialize)
 		{
-			TypeManager::add(AttributedFoo::TypeIdClass(), AttributedFoo::Signatures());
+			TypeManager::add<AttributedFoo>();
 #if defined(DEBUG) || defined(_DEBUG)
 			_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF);
 			_CrtMemCheckpoint(&_startMemState);
@@ -146,6 +146,90 @@ namespace AttributedTest
 			Assert::IsTrue(Foo.IsAuxiliaryAttribute("AuxAttribute"));
 		}
 
+		TEST_METHOD(CompileTimeSignatures) {
+			// Types and element counts come from the members, the whole table is a constant
+			constexpr auto signatures = MakeSignatures({
+				SIGNATURE(AttributedFoo, externalString, "String"),
+				SIGNATURE(AttributedFoo, externalMatrixArray, "Matrices"),
+				{ "Table", Datum::DatumType::Table, 0, 0 }
+			});
+			static_assert(signatures.size() == 3);
+			static_assert(signatures[0].Type == Datum::DatumType::String && signatures[0].size == 1);
+			static_assert(signatures[1].Type == Datum::DatumType::Matrix && signatures[1].size == AttributedFoo::arraySize);
+			static_assert(signatures[1].Offset == offsetof(AttributedFoo, externalMatrixArray));
+			static_assert(signatures[2].Offset == 0);
+			// A repeated name, a member at offset 0 or an unsupported member type does not compile, e.g.
+			// MakeSignatures({ SIGNATURE(AttributedFoo, externalFloat, "A"), SIGNATURE(AttributedFoo, externalInteger, "A") })
+
+			// The registered table is the type's static one, not a copy
+			Assert::IsTrue(TypeManager::get(AttributedFoo::TypeIdClass()).data() == AttributedFoo::Signatures().data());
+			Assert::AreEqual(AttributedFoo::Signatures().size(), (size_t)10);
+			Assert::IsTrue(AttributedFoo::Signatures()[5].Name == "externalIntegerArray");
+			Assert::AreEqual(AttributedFoo::Signatures()[5].size, (uint32_t)AttributedFoo::arraySize);
+		}
+
+		TEST_METHOD(Layout) {
+			// Enough keys that the perfect hash has to try several multipliers and sizes
+			// Append interns the names, they only have to outlive it
+			std::vector<std::string> names;
+			for (int i = 0; i < 300; ++i) {
+				names.push_back("LayoutKey" + std::to_string(i));
+			}
+			std::vector<Signature> base;
+			for (const std::string& name : names) {
+				base.push_back({ name, Datum::DatumType::Int, 1, 0 });
+			}
+			std::vector<Signature> derived = {
+				{ "Derived", Datum::DatumType::Float, 1, 0 },
+				{ "LayoutKey7", Datum::DatumType::Float, 2, 16 },
+				{ "LayoutKey8", Datum::DatumType::String, 1, 0 }
+			};
+			AttributeLayout layout;
+			layout.Append(base, 1);
+			layout.Append(derived, 2);
+			layout.Seal();
+
+			Assert::AreEqual(layout.Size(), (size_t)301);
+			for (int i = 0; i < 300; ++i) {
+				Assert::IsTrue(layout.Contains(Symbol("LayoutKey" + std::to_string(i))));
+			}
+			Assert::IsTrue(layout.Contains(Symbol("Derived")));
+			Assert::IsFalse(layout.Contains(Symbol("NotInLayout")));
+			Assert::IsFalse(layout.Contains(Symbol()));
+			Assert::IsTrue(layout.Covers(1) && layout.Covers(2));
+			Assert::IsFalse(layout.Covers(3));
+
+			// A redeclared key keeps its place, moves into the object, but never back into the Scope
+			const AttributeLayout::Entry& moved = layout.Entries()[7];
+			Assert::IsTrue(moved.Key == Symbol("LayoutKey7"));
+			Assert::AreEqual(moved.Offset, (size_t)16);
+			Assert::AreEqual(moved.Size, (std::uint32_t)2);
+			Assert::IsTrue(layout.Entries()[8].Type == Datum::DatumType::Int);
+			Assert::IsTrue(layout.Entries()[300].Key == Symbol("Derived"));
+
+			// The TypeManager compiles the layout when the type is registered
+			Assert::IsTrue(TypeManager::layout(AttributedFoo::TypeIdClass()).Contains(Symbol("externalInteger")));
+			Assert::AreEqual(TypeManager::layout(AttributedFoo::TypeIdClass()).Size(), AttributedFoo::Signatures().size());
+
+			// A runtime registration keeps its own copy of the signatures and of their names
+			const size_t runtimeType = 0xF00D;
+			{
+				std::vector<Signature> temporary;
+				for (int i = 0; i < 3; ++i) {
+					std::string name = "RuntimeKey" + std::to_string(i);
+					temporary.push_back({ name, Datum::DatumType::Float, 1, 0 });
+				}
+				TypeManager::add(runtimeType, temporary);
+			}
+			std::span<const Signature> registered = TypeManager::get(runtimeType);
+			Assert::AreEqual(registered.size(), (size_t)3);
+			Assert::IsTrue(registered[2].Name == "RuntimeKey2");
+			Assert::IsTrue(TypeManager::layout(runtimeType).Contains(Symbol("RuntimeKey0")));
+			// Back to what Initialize registered, for the leak check
+			TypeManager::Clear();
+			TypeManager::add<AttributedFoo>();
+		}
+
 
 		
 	private:
@@ -0,0 +1,19 @@
+#pragma once
+#include "CppUnitTest.h"
+
+// Timing tests only log their results, so they sit in the Benchmark category and are ignored
+// unless the test project is built with FIEA_BENCHMARKS defined
+#ifdef FIEA_BENCHMARKS
+#define BENCHMARK_METHOD(methodName) \
+	BEGIN_TEST_METHOD_ATTRIBUTE(methodName) \
+		TEST_METHOD_ATTRIBUTE(L"TestCategory", L"Benchmark") \
+	END_TEST_METHOD_ATTRIBUTE() \
+	TEST_METHOD(methodName)
+#else
+#define BENCHMARK_METHOD(methodName) \
+	BEGIN_TEST_METHOD_ATTRIBUTE(methodName) \
+		TEST_METHOD_ATTRIBUTE(L"TestCategory", L"Benchmark") \
+		TEST_IGNORE() \
+	END_TEST_METHOD_ATTRIBUTE() \
+	TEST_METHOD(methodName)
+#endif
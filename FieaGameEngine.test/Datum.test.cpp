@@ -1,7 +1,11 @@
 #include "pch.h"
 #include "CppUnitTest.h"
+#include "Benchmark.h"
 #include "Datum.h"
 #include "TestTypes.h"
+#include "HeapResource.h"
+#include <chrono>
+#include <limits>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace Fiea::GameEngine;
@@ -1314,6 +1318,29 @@ namespace DatumTest
 			Assert::ExpectException<std::runtime_error>([&dMat, &m] { dMat.SetStorage(m, 1); });
 		}
 
+		TEST_METHOD(Owned) {
+			// Plain copies of external storage view it, owned ones keep the values they were made with
+			string s[2] = { "Hey", "There" };
+			Datum external;
+			external.SetStorage(s, 2);
+			Datum view = external;
+			Datum owned = external.Owned();
+			s[1] = "Wait";
+			Assert::AreEqual(view.Get<string>(1), string("Wait"));
+			Assert::AreEqual(owned.Get<string>(1), string("There"));
+			Assert::IsTrue(owned != external);
+			owned.Set(1, s[1]);
+			Assert::IsTrue(owned == external);
+
+			Datum pooled;
+			pooled.Push(std::string_view("Pooled"));
+			pooled.Push(std::string_view("Strings"));
+			Datum copy = pooled.Owned();
+			Assert::IsTrue(copy == pooled);
+			Datum empty;
+			Assert::IsTrue(empty.Owned() == empty);
+		}
+
 		TEST_METHOD(Equality_Operator) {
 			// Int
 			Datum dInt1(4);
@@ -1357,6 +1384,498 @@ namespace DatumTest
 
 			Assert::AreEqual(dInt.Get<int>(), 4);
 			Assert::AreEqual(dInt.Get<int>(1), 8);
+
+			// Unordered removal moves the last element into the gap
+			Datum dString("a");
+			dString.Push("b");
+			dString.Push("c");
+			dString.RemoveAtUnordered(0);
+			Assert::AreEqual(dString.Size(), (size_t)2);
+			Assert::AreEqual(dString.Get<std::string>(0), std::string("c"));
+			Assert::AreEqual(dString.Get<std::string>(1), std::string("b"));
+			dString.RemoveAtUnordered(1);
+			Assert::AreEqual(dString.Get<std::string>(0), std::string("c"));
+			Assert::ExpectException<std::out_of_range>([&dString] { dString.RemoveAtUnordered(1); });
+		}
+
+		TEST_METHOD(SmallBufferAllocations) {
+#if defined(DEBUG) || defined(_DEBUG)
+			{
+				// One element of any type fits inside the Datum
+				AllocationCounter counter;
+				Datum dInt(7);
+				Datum dFloat(4.5f);
+				Datum dString("Kaloob");
+				Datum dVec(Vec4(1, 2, 3, 4));
+				Datum dMat(Mat4(1.0f));
+				Datum assigned;
+				assigned = 3;
+				Datum copy(dString);
+				Datum moved(std::move(dVec));
+				Assert::AreEqual((size_t)0, counter.Count());
+
+				Assert::AreEqual(copy.GetString(), string("Kaloob"));
+				Assert::AreEqual(moved.GetVector(), Vec4(1, 2, 3, 4));
+				Assert::AreEqual(dMat.GetMatrix(), Mat4(1.0f));
+			}
+			{
+				// Growing past the inline buffer spills to the heap and keeps the elements
+				Datum dString("Short");
+				AllocationCounter counter;
+				dString.Push(string("Second"));
+				dString.Push(string("Third"));
+				Assert::IsTrue(counter.Count() > 0);
+				Assert::AreEqual(dString.GetString(0), string("Short"));
+				Assert::AreEqual(dString.GetString(2), string("Third"));
+
+				Datum moved(std::move(dString));
+				Assert::AreEqual(moved.GetString(1), string("Second"));
+				Assert::AreEqual(dString.Size(), (size_t)0);
+			}
+			{
+				// Shrinking back down moves the elements into the inline buffer
+				Datum dInt(1);
+				for (int i = 2; i <= 20; ++i) {
+					dInt.Push(i);
+				}
+				dInt.Resize(3);
+				AllocationCounter counter;
+				Datum copy(dInt);
+				Assert::AreEqual((size_t)0, counter.Count());
+				Assert::AreEqual(copy.GetInt(2), 3);
+			}
+#endif
+		}
+
+		BENCHMARK_METHOD(PushBenchmark) {
+			// Cost of growing by Push, dominated by relocating the elements every time capacity runs out
+			auto report = [](const char* name, auto from, auto to) {
+				double ms = std::chrono::duration<double, std::milli>(to - from).count();
+				std::string message = std::string("Datum::Push ") + name + ": " + std::to_string(ms) + " ms";
+				Logger::WriteMessage(message.c_str());
+			};
+			{
+				const size_t count = 1000000;
+				auto start = std::chrono::steady_clock::now();
+				Datum d;
+				for (size_t i = 0; i < count; ++i) {
+					d.Push((int)i);
+				}
+				report("1M ints", start, std::chrono::steady_clock::now());
+				Assert::AreEqual(d.Size(), count);
+				Assert::AreEqual(d.GetInt(count - 1), (int)(count - 1));
+			}
+			{
+				const size_t count = 1000000;
+				auto start = std::chrono::steady_clock::now();
+				Datum d;
+				for (size_t i = 0; i < count; ++i) {
+					d.Push(Vec4((float)i));
+				}
+				report("1M vec4", start, std::chrono::steady_clock::now());
+				Assert::AreEqual(d.Size(), count);
+				Assert::AreEqual(d.GetVector(count - 1), Vec4((float)(count - 1)));
+			}
+			{
+				const size_t count = 100000;
+				const string value("A string long enough to live on the heap");
+				auto start = std::chrono::steady_clock::now();
+				Datum d;
+				for (size_t i = 0; i < count; ++i) {
+					d.Push(value);
+				}
+				report("100k strings", start, std::chrono::steady_clock::now());
+				Assert::AreEqual(d.Size(), count);
+				Assert::AreEqual(d.GetString(count - 1), value);
+			}
+		}
+
+		TEST_METHOD(ElementOperations) {
+			// Floats compare by value, not by bits
+			Datum zeros(0.0f);
+			Datum negativeZeros(-0.0f);
+			Assert::IsTrue(zeros == negativeZeros);
+			Datum nan(std::numeric_limits<float>::quiet_NaN());
+			Datum nanCopy(nan);
+			Assert::IsFalse(nan == nanCopy);
+
+			// Pointers compare through RTTI::Equals
+			Scope* s = new Scope();
+			RTTI* r = s;
+			Datum dRTTI1(r);
+			Datum dRTTI2(r);
+			Assert::IsTrue(dRTTI1 == dRTTI2);
+			delete s;
+
+			// Pop and RemoveAt work the same for every type
+			Scope* scopes[3] = { new Scope(), new Scope(), new Scope() };
+			Datum dScope(scopes[0]);
+			dScope.Push(scopes[1]);
+			dScope.Push(scopes[2]);
+			dScope.RemoveAt(0);
+			Assert::AreEqual(dScope.Size(), (size_t)2);
+			Assert::IsTrue(dScope.GetScope(0) == scopes[1]);
+			dScope.Pop();
+			Assert::AreEqual(dScope.Size(), (size_t)1);
+			for (Scope* scope : scopes) {
+				delete scope;
+			}
+
+			Datum dString("A string long enough to live on the heap");
+			dString.Push("Second");
+			dString.Push("Third");
+			dString.RemoveAt(1);
+			Assert::AreEqual(dString.Size(), (size_t)2);
+			Assert::AreEqual(dString.GetString(1), string("Third"));
+		}
+
+		TEST_METHOD(BulkInsertion) {
+			// Reserve keeps the size and never shrinks
+			Datum dInt(1);
+			dInt.Reserve(100);
+			Assert::AreEqual(dInt.Size(), (size_t)1);
+			Assert::AreEqual(dInt.Capacity(), (size_t)100);
+			dInt.Reserve(10);
+			Assert::AreEqual(dInt.Capacity(), (size_t)100);
+			Datum dEmpty;
+			Assert::ExpectException<std::runtime_error>([&dEmpty] { dEmpty.Reserve(10); });
+
+			// Append types an empty Datum and copies everything after the current elements
+			const int ints[] = { 2, 3, 4, 5 };
+			dInt.Append(ints, 4);
+			Assert::AreEqual(dInt.Size(), (size_t)5);
+			Assert::AreEqual(dInt.GetInt(4), 5);
+			Datum dFloat;
+			const float floats[] = { 1.5f, 2.5f };
+			dFloat.Append(floats, 2);
+			Assert::IsTrue(dFloat.CheckType(Datum::Float));
+			Assert::AreEqual(dFloat.GetFloat(1), 2.5f);
+			Assert::ExpectException<std::runtime_error>([&dFloat, &ints] { dFloat.Append(ints, 4); });
+
+			// Assign replaces the contents, leaving the Datum alone on a type mismatch
+			std::vector<string> strings = { "Charge", "A string long enough to live on the heap" };
+			Datum dString("Old");
+			dString.Assign(std::span<const string>(strings));
+			Assert::AreEqual(dString.Size(), (size_t)2);
+			Assert::AreEqual(dString.GetString(1), strings[1]);
+			Assert::ExpectException<std::runtime_error>([&dString, &ints] { dString.Assign(std::span<const int>(ints)); });
+			Assert::AreEqual(dString.Size(), (size_t)2);
+
+			// Range constructor allocates exactly the length of the range
+			std::vector<Vec4> vectors(20, Vec4(1.0f));
+			Datum dVec(vectors.begin(), vectors.end());
+			Assert::AreEqual(dVec.Size(), (size_t)20);
+			Assert::AreEqual(dVec.Capacity(), (size_t)20);
+			Assert::AreEqual(dVec.GetVector(19), Vec4(1.0f));
+
+			// External storage can't be appended to
+			int external[] = { 1, 2 };
+			Datum dExternal;
+			dExternal.SetStorage(external, 2);
+			Assert::ExpectException<std::runtime_error>([&dExternal, &ints] { dExternal.Append(ints, 4); });
+		}
+
+		TEST_METHOD(Spans) {
+			Datum dFloat(1.0f);
+			dFloat.Push(2.0f);
+			dFloat.Push(3.0f);
+			std::span<float> floats = dFloat.AsSpan<float>();
+			Assert::AreEqual(floats.size(), (size_t)3);
+			float sum = 0.0f;
+			for (float f : floats) {
+				sum += f;
+			}
+			Assert::AreEqual(sum, 6.0f);
+
+			// Writes through the span land in the Datum
+			floats[1] = 5.0f;
+			Assert::AreEqual(dFloat.GetFloat(1), 5.0f);
+
+			const Datum& constFloat = dFloat;
+			Assert::AreEqual(constFloat.AsSpan<float>()[1], 5.0f);
+			Assert::AreEqual(dFloat.AsConstSpan<float>().size(), (size_t)3);
+
+			// Wrong or missing type throws
+			Assert::ExpectException<std::runtime_error>([&dFloat] { dFloat.AsSpan<int>(); });
+			Datum dEmpty;
+			Assert::ExpectException<std::runtime_error>([&dEmpty] { dEmpty.AsConstSpan<glm::vec4>(); });
+
+			// External storage is viewed in place
+			Mat4 matrices[2] = { Mat4(1.0f), Mat4(2.0f) };
+			Datum dExternal;
+			dExternal.SetStorage(matrices, 2);
+			Assert::IsTrue(dExternal.AsSpan<Mat4>().data() == matrices);
+
+			Scope* s = new Scope();
+			Datum dScope(s);
+			Assert::IsTrue(dScope.AsSpan<Scope*>()[0] == s);
+			delete s;
+		}
+
+		TEST_METHOD(MemoryResources) {
+			CountingResource resource;
+			CountingResource otherResource;
+			{
+				Datum dInt(std::allocator_arg, Datum::allocator_type(&resource));
+				Assert::IsTrue(dInt.GetResource() == &resource);
+				// Small Datums stay in the inline buffer, growing past it allocates from the resource
+				for (int i = 0; i < 4; ++i) {
+					dInt.Push(i);
+				}
+				Assert::AreEqual(resource.Allocations(), (size_t)0);
+				for (int i = 4; i < 100; ++i) {
+					dInt.Push(i);
+				}
+				Assert::IsTrue(resource.Allocations() > 0);
+				Assert::IsTrue(resource.BytesInUse() >= 100 * sizeof(int));
+
+				// Plain copies go to the heap, allocator copies to the allocator's resource
+				Datum heapCopy(dInt);
+				Assert::IsNull(heapCopy.GetResource());
+				size_t used = otherResource.BytesInUse();
+				Datum otherCopy(std::allocator_arg, Datum::allocator_type(&otherResource), dInt);
+				Assert::IsTrue(otherCopy.GetResource() == &otherResource);
+				Assert::IsTrue(otherResource.BytesInUse() > used);
+				Assert::IsTrue(otherCopy == dInt);
+
+				// Moving keeps the storage and the resource it came from
+				Datum moved(std::move(dInt));
+				Assert::IsTrue(moved.GetResource() == &resource);
+				Assert::AreEqual(moved.Get<int>(99), 99);
+
+				// Moving into a Datum on another resource moves the elements over
+				size_t inUse = resource.BytesInUse();
+				Datum relocated(std::allocator_arg, Datum::allocator_type(&otherResource), std::move(moved));
+				Assert::IsTrue(resource.BytesInUse() < inUse);
+				Assert::AreEqual(relocated.Get<int>(99), 99);
+				Assert::AreEqual(relocated.Size(), (size_t)100);
+
+				Datum assigned(std::allocator_arg, Datum::allocator_type(&resource));
+				assigned = std::move(relocated);
+				Assert::IsTrue(assigned.GetResource() == &resource);
+				Assert::AreEqual(assigned.Get<int>(50), 50);
+
+				// Strings and shrinking through Resize hand back the sizes they were allocated with
+				Datum dString(std::allocator_arg, Datum::allocator_type(&resource));
+				for (int i = 0; i < 20; ++i) {
+					dString.Push(std::to_string(i));
+				}
+				dString.Resize(5);
+				Assert::AreEqual(dString.GetString(4), std::string("4"));
+				dString.Resize(5);
+				Assert::AreEqual(dString.Capacity(), (size_t)5);
+
+				// External storage is never allocated
+				int external[40] = {};
+				size_t allocations = resource.Allocations();
+				Datum dExternal(std::allocator_arg, Datum::allocator_type(&resource));
+				dExternal.SetStorage(external, 40);
+				Assert::AreEqual(resource.Allocations(), allocations);
+			}
+			Assert::AreEqual(resource.BytesInUse(), (size_t)0);
+			Assert::AreEqual(otherResource.BytesInUse(), (size_t)0);
+		}
+
+		TEST_METHOD(PooledStrings) {
+			// Pushing string_views makes a PooledString Datum
+			Datum names(std::string_view("Kaloob"));
+			Assert::IsTrue(names.CheckType(Datum::PooledString));
+			Assert::AreEqual(names.GetType(), string("PooledString"));
+			names.Push(std::string_view("Anubis"));
+			names.Push(std::string_view(""));
+			names.Push(std::string_view("A name long enough to live on the heap as a std::string"));
+			Assert::AreEqual(names.Size(), (size_t)4);
+			Assert::IsTrue(names.GetStringView(0) == "Kaloob");
+			Assert::IsTrue(names.GetStringView(2).empty());
+			Assert::AreEqual(names.GetAsString(3), string("A name long enough to live on the heap as a std::string"));
+			Assert::ExpectException<std::runtime_error>([&names] { names.GetString(0); });
+			Assert::ExpectException<std::runtime_error>([&names] { names.Push(5); });
+			Assert::ExpectException<std::runtime_error>([&names] { names.Push(string("Not a view")); });
+			Assert::ExpectException<std::out_of_range>([&names] { names.GetStringView(4); });
+
+			// Shorter strings are overwritten in place, longer ones and views into the Datum itself are copied
+			names.SetString(0, "Kal");
+			names.SetString(1, "Anubis the Jackal");
+			names.SetString(2, names.GetStringView(1));
+			names.Push(names.GetStringView(3));
+			Assert::IsTrue(names.GetStringView(0) == "Kal");
+			Assert::IsTrue(names.GetStringView(1) == "Anubis the Jackal");
+			Assert::IsTrue(names.GetStringView(2) == "Anubis the Jackal");
+			Assert::IsTrue(names.GetStringView(4) == names.GetStringView(3));
+			names.SetFromString(4, "Parsed");
+			names.SetFromString(5, "Pushed");
+			Assert::IsTrue(names.GetStringView(4) == "Parsed");
+			Assert::IsTrue(names.GetStringView(5) == "Pushed");
+
+			// Growing keeps every string, including past the inline entries
+			for (int i = 0; i < 100; ++i) {
+				names.Push(std::string_view(std::to_string(i)));
+			}
+			Assert::IsTrue(names.GetStringView(105) == "99");
+			Assert::IsTrue(names.GetStringView(1) == "Anubis the Jackal");
+			names.RemoveAt(1);
+			Assert::IsTrue(names.GetStringView(1) == "Anubis the Jackal");
+			Assert::IsTrue(names.GetStringView(2) == "A name long enough to live on the heap as a std::string");
+			names.Pop();
+			Assert::IsTrue(names.GetStringView(names.Size() - 1) == "98");
+
+			// Copies and moves compare by characters
+			Datum copy(names);
+			Assert::IsTrue(copy == names);
+			copy.SetString(0, "Kam");
+			Assert::IsTrue(copy != names);
+			Datum assigned;
+			assigned = names;
+			Assert::IsTrue(assigned == names);
+			Datum moved(std::move(assigned));
+			Assert::IsTrue(moved == names);
+			Assert::AreEqual(assigned.Size(), (size_t)0);
+
+			// Bulk insertion copies every view's characters
+			std::string_view views[] = { "Fire", "Water", "Earth" };
+			Datum elements;
+			elements.Append(views, 3);
+			elements.Append(views, 3);
+			Assert::AreEqual(elements.Size(), (size_t)6);
+			Assert::IsTrue(elements.GetStringView(4) == "Water");
+			Datum ranged(std::begin(views), std::end(views));
+			Assert::IsTrue(ranged.GetStringView(2) == "Earth");
+			elements.Clear();
+			Assert::IsTrue(elements.Empty());
+			elements.Push(std::string_view("Air"));
+			Assert::IsTrue(elements.GetStringView(0) == "Air");
+
+			// Set and the sized constructor pool the characters too
+			Datum greeting(std::string_view("hello"), 4);
+			Assert::AreEqual(greeting.Size(), (size_t)1);
+			Assert::IsTrue(greeting.Capacity() >= 4);
+			Assert::IsTrue(greeting.GetStringView(0) == "hello");
+			greeting.Push(std::string_view("world"));
+			std::string temporary = "there, a longer replacement";
+			std::string_view replacement = temporary;
+			greeting.Set(0, replacement);
+			temporary.assign(temporary.size(), '#');
+			Assert::IsTrue(greeting.GetStringView(0) == "there, a longer replacement");
+			Assert::IsTrue(greeting.GetStringView(1) == "world");
+			const std::string_view shorter = "hi";
+			greeting.Set(1, shorter);
+			Assert::IsTrue(greeting.GetStringView(1) == "hi");
+			Assert::IsTrue(greeting.GetStringView(0) == "there, a longer replacement");
+
+			// String Datums read and write through the same calls
+			Datum dString("Kaloob");
+			dString.SetString(0, "Anubis");
+			dString.Push(std::string_view("Ra"));
+			Assert::IsTrue(dString.GetStringView(0) == "Anubis");
+			Assert::AreEqual(dString.GetString(1), string("Ra"));
+
+			// Entries and characters both come from the Datum's resource
+			CountingResource resource;
+			{
+				Datum pooled(std::allocator_arg, Datum::allocator_type(&resource));
+				for (int i = 0; i < 50; ++i) {
+					pooled.Push(std::string_view("Pooled string number " + std::to_string(i)));
+				}
+				Assert::IsTrue(resource.BytesInUse() > 0);
+				Datum relocated(std::allocator_arg, Datum::allocator_type(HeapResource::Get()), std::move(pooled));
+				Assert::AreEqual(resource.BytesInUse(), (size_t)0);
+				Assert::IsTrue(relocated.GetStringView(49) == "Pooled string number 49");
+				Datum copied(std::allocator_arg, Datum::allocator_type(&resource), relocated);
+				Assert::IsTrue(copied == relocated);
+			}
+			Assert::AreEqual(resource.BytesInUse(), (size_t)0);
+		}
+
+		BENCHMARK_METHOD(PooledStringBenchmark) {
+			// Building and copying arrays of names as std::strings against pooled characters
+			auto measure = [](const char* name, auto&& work) {
+#if defined(DEBUG) || defined(_DEBUG)
+				AllocationCounter counter;
+#endif
+				auto start = std::chrono::steady_clock::now();
+				work();
+				double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+				std::string message = std::string("Datum ") + name + ": " + std::to_string(ms) + " ms";
+#if defined(DEBUG) || defined(_DEBUG)
+				message += ", " + std::to_string(counter.Count()) + " allocations";
+#endif
+				Logger::WriteMessage(message.c_str());
+			};
+			const size_t count = 100000;
+			const int repeats = 20;
+			std::vector<string> names;
+			for (size_t i = 0; i < count; ++i) {
+				names.push_back("Content name long enough for the heap #" + std::to_string(i));
+			}
+
+			Datum strings;
+			measure("push 100k String", [&] {
+				for (const string& name : names) {
+					strings.Push(name);
+				}
+			});
+			Datum pooled;
+			measure("push 100k PooledString", [&] {
+				for (const string& name : names) {
+					pooled.Push(std::string_view(name));
+				}
+			});
+			measure("copy 100k String x20", [&] {
+				for (int r = 0; r < repeats; ++r) {
+					Datum copy(strings);
+					Assert::AreEqual(copy.Size(), count);
+				}
+			});
+			measure("copy 100k PooledString x20", [&] {
+				for (int r = 0; r < repeats; ++r) {
+					Datum copy(pooled);
+					Assert::AreEqual(copy.Size(), count);
+				}
+			});
+			for (size_t i = 0; i < count; i += 997) {
+				Assert::IsTrue(pooled.GetStringView(i) == strings.GetString(i));
+			}
+		}
+
+		BENCHMARK_METHOD(CompareBenchmark) {
+			// Copying and comparing large numeric Datums, bulk memcpy/memcmp or vectorized loops per type
+			auto report = [](const char* name, auto from, auto to) {
+				double ms = std::chrono::duration<double, std::milli>(to - from).count();
+				std::string message = std::string("Datum ") + name + ": " + std::to_string(ms) + " ms";
+				Logger::WriteMessage(message.c_str());
+			};
+			const size_t count = 1000000;
+			const int repeats = 20;
+			Datum ints(0, count);
+			Datum floats(0.0f, count);
+			for (size_t i = 1; i < count; ++i) {
+				ints.Push((int)i);
+				floats.Push((float)i);
+			}
+			{
+				auto start = std::chrono::steady_clock::now();
+				for (int i = 0; i < repeats; ++i) {
+					Datum copy(ints);
+					Assert::AreEqual(copy.Size(), count);
+				}
+				report("copy 1M ints x20", start, std::chrono::steady_clock::now());
+			}
+			Datum intsCopy(ints);
+			Datum floatsCopy(floats);
+			{
+				auto start = std::chrono::steady_clock::now();
+				for (int i = 0; i < repeats; ++i) {
+					Assert::IsTrue(ints == intsCopy);
+				}
+				report("compare 1M ints x20", start, std::chrono::steady_clock::now());
+			}
+			{
+				auto start = std::chrono::steady_clock::now();
+				for (int i = 0; i < repeats; ++i) {
+					Assert::IsTrue(floats == floatsCopy);
+				}
+				report("compare 1M floats x20", start, std::chrono::steady_clock::now());
+			}
 		}
 
 	private:
@@ -0,0 +1,238 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "Benchmark.h"
+#include "DatumMath.h"
+#include "Scope.h"
+#include "TestTypes.h"
+#include <chrono>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Fiea::GameEngine;
+
+typedef glm::vec4 Vec4;
+typedef glm::mat4 Mat4;
+
+namespace DatumMathTest
+{
+	TEST_CLASS(DatumMathTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(Initialize)
+		{
+#if defined(DEBUG) || defined(_DEBUG)
+			_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF);
+			_CrtMemCheckpoint(&_startMemState);
+#endif
+		}
+
+		TEST_METHOD_CLEANUP(Cleanup)
+		{
+#if defined(DEBUG) || defined(_DEBUG)
+			_CrtMemState endMemState, diffMemState;
+			_CrtMemCheckpoint(&endMemState);
+			if (_CrtMemDifference(&diffMemState, &_startMemState, &endMemState))
+			{
+				_CrtDumpMemoryLeaks();
+				_CrtMemDumpStatistics(&diffMemState);
+				Assert::Fail(L"Memory Leaks!");
+			}
+#endif
+		}
+
+		TEST_METHOD(ScalarOperations) {
+			// 11 floats, enough for full lanes and a leftover tail
+			Datum dFloat;
+			for (int i = 0; i < 11; ++i) {
+				dFloat.Push((float)i);
+			}
+			DatumMath::Add(dFloat, 1.5f);
+			Assert::AreEqual(dFloat.GetFloat(0), 1.5f);
+			Assert::AreEqual(dFloat.GetFloat(10), 11.5f);
+			DatumMath::Multiply(dFloat, 2.0f);
+			Assert::AreEqual(dFloat.GetFloat(10), 23.0f);
+			DatumMath::MultiplyAdd(dFloat, 0.5f, -1.0f);
+			Assert::AreEqual(dFloat.GetFloat(0), 0.5f);
+			Assert::AreEqual(dFloat.GetFloat(10), 10.5f);
+			DatumMath::Clamp(dFloat, 2.0f, 8.0f);
+			Assert::AreEqual(dFloat.GetFloat(0), 2.0f);
+			Assert::AreEqual(dFloat.GetFloat(5), 5.5f);
+			Assert::AreEqual(dFloat.GetFloat(10), 8.0f);
+			Assert::ExpectException<std::invalid_argument>([&dFloat] { DatumMath::Clamp(dFloat, 3.0f, 1.0f); });
+
+			// Ints truncate the scalar like ActionIncrement does
+			Datum dInt(1);
+			dInt.Push(5);
+			dInt.Push(-3);
+			DatumMath::Add(dInt, 2.9f);
+			Assert::AreEqual(dInt.GetInt(0), 3);
+			DatumMath::Multiply(dInt, 3.0f);
+			Assert::AreEqual(dInt.GetInt(1), 21);
+			DatumMath::Clamp(dInt, 0.0f, 10.0f);
+			Assert::AreEqual(dInt.GetInt(1), 10);
+			Assert::AreEqual(dInt.GetInt(2), 0);
+
+			// Vectors and Matrices are updated component wise
+			Datum dVec(Vec4(1, 2, 3, 4));
+			DatumMath::Add(dVec, 1.0f);
+			Assert::AreEqual(dVec.GetVector(), Vec4(2, 3, 4, 5));
+			Datum dMat(Mat4(1.0f));
+			DatumMath::Multiply(dMat, 3.0f);
+			Assert::AreEqual(dMat.GetMatrix(), Mat4(3.0f));
+
+			// Non numeric Datums throw
+			Datum dString("Not a number");
+			Assert::ExpectException<std::runtime_error>([&dString] { DatumMath::Add(dString, 1.0f); });
+			Datum dEmpty;
+			Assert::ExpectException<std::runtime_error>([&dEmpty] { DatumMath::Multiply(dEmpty, 1.0f); });
+		}
+
+		TEST_METHOD(DatumOperations) {
+			Datum positions;
+			Datum velocities;
+			for (int i = 0; i < 9; ++i) {
+				positions.Push(Vec4((float)i));
+				velocities.Push(Vec4(1.0f, 2.0f, 0.0f, -1.0f));
+			}
+			DatumMath::MultiplyAdd(positions, velocities, 0.5f);
+			Assert::AreEqual(positions.GetVector(0), Vec4(0.5f, 1.0f, 0.0f, -0.5f));
+			Assert::AreEqual(positions.GetVector(8), Vec4(8.5f, 9.0f, 8.0f, 7.5f));
+
+			DatumMath::Add(positions, velocities);
+			Assert::AreEqual(positions.GetVector(8), Vec4(9.5f, 11.0f, 8.0f, 6.5f));
+			DatumMath::Multiply(positions, velocities);
+			Assert::AreEqual(positions.GetVector(8), Vec4(9.5f, 22.0f, 0.0f, -6.5f));
+
+			Datum dFloat(0.0f);
+			dFloat.Push(10.0f);
+			Datum dTarget(10.0f);
+			dTarget.Push(20.0f);
+			DatumMath::Lerp(dFloat, dTarget, 0.25f);
+			Assert::AreEqual(dFloat.GetFloat(0), 2.5f);
+			Assert::AreEqual(dFloat.GetFloat(1), 12.5f);
+
+			Datum dInt(1);
+			dInt.Push(2);
+			Datum dIntOther(10);
+			dIntOther.Push(20);
+			DatumMath::MultiplyAdd(dInt, dIntOther, 2.0f);
+			Assert::AreEqual(dInt.GetInt(1), 42);
+			Assert::ExpectException<std::runtime_error>([&dInt, &dIntOther] { DatumMath::Lerp(dInt, dIntOther, 0.5f); });
+
+			// Operands have to match in type and size
+			Assert::ExpectException<std::runtime_error>([&dFloat, &dInt] { DatumMath::Add(dFloat, dInt); });
+			dTarget.Push(30.0f);
+			Assert::ExpectException<std::invalid_argument>([&dFloat, &dTarget] { DatumMath::Add(dFloat, dTarget); });
+		}
+
+		TEST_METHOD(Transforms) {
+			// Small integers keep every product exact so results compare equal to glm's
+			Mat4 transform(Vec4(0, 1, 0, 0), Vec4(-1, 0, 0, 0), Vec4(0, 0, 2, 0), Vec4(1, 2, 3, 1));
+
+			Datum dVec;
+			for (int i = 0; i < 5; ++i) {
+				dVec.Push(Vec4((float)i, 1.0f, -2.0f, 1.0f));
+			}
+			DatumMath::Transform(dVec, transform);
+			for (int i = 0; i < 5; ++i) {
+				Assert::AreEqual(dVec.GetVector(i), transform * Vec4((float)i, 1.0f, -2.0f, 1.0f));
+			}
+
+			Mat4 original(2.0f);
+			original[3] = Vec4(4, 5, 6, 1);
+			Datum dMat(original);
+			DatumMath::Transform(dMat, transform);
+			Assert::AreEqual(dMat.GetMatrix(), transform * original);
+
+			Datum dFloat(1.0f);
+			Assert::ExpectException<std::runtime_error>([&dFloat, &transform] { DatumMath::Transform(dFloat, transform); });
+
+			// External storage is updated in place
+			float external[3] = { 1.0f, 2.0f, 3.0f };
+			Datum dExternal;
+			dExternal.SetStorage(external, 3);
+			DatumMath::Add(dExternal, 1.0f);
+			Assert::AreEqual(external[2], 4.0f);
+		}
+
+		BENCHMARK_METHOD(Benchmark) {
+			// One bulk call against the per element Get/Set loop ActionIncrement uses and against a plain loop
+			auto report = [](const char* name, auto from, auto to) {
+				double ms = std::chrono::duration<double, std::milli>(to - from).count();
+				std::string message = std::string("DatumMath ") + name + ": " + std::to_string(ms) + " ms";
+				Logger::WriteMessage(message.c_str());
+			};
+			const size_t count = 100000;
+			const int repeats = 100;
+			Datum values(0.0f, count);
+			Datum velocities(1.0f, count);
+			for (size_t i = 1; i < count; ++i) {
+				values.Push((float)i);
+				velocities.Push(1.0f);
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			for (int r = 0; r < repeats; ++r) {
+				for (size_t i = 0; i < count; ++i) {
+					float result = values.Get<float>(i) + 0.5f;
+					values.Set(i, result);
+				}
+			}
+			report("add 100k floats x100 (Get/Set)", start, std::chrono::steady_clock::now());
+
+			start = std::chrono::steady_clock::now();
+			for (int r = 0; r < repeats; ++r) {
+				for (float& value : values.AsSpan<float>()) {
+					value += 0.5f;
+				}
+			}
+			report("add 100k floats x100 (scalar loop)", start, std::chrono::steady_clock::now());
+
+			start = std::chrono::steady_clock::now();
+			for (int r = 0; r < repeats; ++r) {
+				DatumMath::Add(values, 0.5f);
+			}
+			report("add 100k floats x100 (DatumMath)", start, std::chrono::steady_clock::now());
+			Assert::AreEqual(values.GetFloat(0), 150.0f);
+
+			start = std::chrono::steady_clock::now();
+			for (int r = 0; r < repeats; ++r) {
+				std::span<float> lhs = values.AsSpan<float>();
+				std::span<const float> rhs = velocities.AsConstSpan<float>();
+				for (size_t i = 0; i < count; ++i) {
+					lhs[i] += rhs[i] * 0.016f;
+				}
+			}
+			report("multiply add 100k floats x100 (scalar loop)", start, std::chrono::steady_clock::now());
+
+			start = std::chrono::steady_clock::now();
+			for (int r = 0; r < repeats; ++r) {
+				DatumMath::MultiplyAdd(values, velocities, 0.016f);
+			}
+			report("multiply add 100k floats x100 (DatumMath)", start, std::chrono::steady_clock::now());
+
+			Datum vectors(Vec4(1.0f), count);
+			for (size_t i = 1; i < count; ++i) {
+				vectors.Push(Vec4((float)i, 1.0f, 0.0f, 1.0f));
+			}
+			Mat4 transform(Vec4(1, 0, 0, 0), Vec4(0, 1, 0, 0), Vec4(0, 0, 1, 0), Vec4(0.5f, 0, 0, 1));
+
+			start = std::chrono::steady_clock::now();
+			for (int r = 0; r < repeats; ++r) {
+				for (Vec4& v : vectors.AsSpan<Vec4>()) {
+					v = transform * v;
+				}
+			}
+			report("transform 100k vec4 x100 (glm loop)", start, std::chrono::steady_clock::now());
+
+			start = std::chrono::steady_clock::now();
+			for (int r = 0; r < repeats; ++r) {
+				DatumMath::Transform(vectors, transform);
+			}
+			report("transform 100k vec4 x100 (DatumMath)", start, std::chrono::steady_clock::now());
+		}
+
+	private:
+		inline static _CrtMemState _startMemState;
+	};
+}
@@ -0,0 +1,267 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "Benchmark.h"
+#include "EntityStore.h"
+#include "TransformSystem.h"
+#include "GameObject.h"
+#include "Hero.h"
+#include "TestTypes.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Fiea::GameEngine;
+
+namespace EntityStoreTest
+{
+	TEST_CLASS(EntityStoreTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(Initialize)
+		{
+			TypeManager::add<GameObject>();
+			TypeManager::add<Hero>();
+#if defined(DEBUG) || defined(_DEBUG)
+			_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF);
+			_CrtMemCheckpoint(&_startMemState);
+#endif
+		}
+
+		TEST_METHOD_CLEANUP(Cleanup)
+		{
+#if defined(DEBUG) || defined(_DEBUG)
+			_CrtMemState endMemState, diffMemState;
+			_CrtMemCheckpoint(&endMemState);
+			if (_CrtMemDifference(&diffMemState, &_startMemState, &endMemState))
+			{
+				_CrtDumpMemoryLeaks();
+				_CrtMemDumpStatistics(&diffMemState);
+				Assert::Fail(L"Memory Leaks!");
+			}
+#endif
+			TypeManager::Clear();
+		}
+
+		TEST_METHOD(AttributesViewColumns) {
+			EntityStore store;
+			GameObject objects[3];
+			for (int idx = 0; idx < 3; ++idx) {
+				objects[idx].Name = "Object" + std::to_string(idx);
+				objects[idx].ObjTransform.Position = glm::vec4(float(idx));
+				store.Add(objects[idx]);
+			}
+			store.Add(objects[1]);
+			Assert::AreEqual(store.Size(), std::size_t(3));
+			Assert::IsTrue(store.Contains(objects[2]));
+
+			// One archetype per type, one column per prescribed attribute kept in a member
+			EntityStore::Archetype* archetype = store.Find(GameObject::TypeIdClass());
+			Assert::IsNotNull(archetype);
+			Assert::AreEqual(archetype->Size(), std::size_t(3));
+			Assert::IsTrue(archetype->HasColumn(GameObject::PositionKey));
+			Assert::IsFalse(archetype->HasColumn(GameObject::ChildrenKey));
+			Assert::IsNull(store.Find(Hero::TypeIdClass()));
+			std::span<glm::vec4> positions = archetype->Column<glm::vec4>(GameObject::PositionKey);
+			Assert::AreEqual(positions.size(), std::size_t(3));
+			Assert::AreEqual(positions[2], glm::vec4(2.0f));
+			Assert::AreEqual(archetype->Column<std::string>(Symbol("Name"))[1], string("Object1"));
+			Assert::ExpectException<std::runtime_error>([archetype]() { archetype->Column<float>(GameObject::PositionKey); });
+			Assert::ExpectException<std::invalid_argument>([archetype]() { archetype->Column<float>(GameObject::ChildrenKey); });
+
+			// Writes through either side show on the other, the members fall behind until Sync
+			positions[0] = glm::vec4(5.0f);
+			Assert::AreEqual(objects[0].Find(GameObject::PositionKey)->Get<glm::vec4>(), glm::vec4(5.0f));
+			Assert::AreEqual(objects[0].GetTransform().Position, glm::vec4(5.0f));
+			Assert::AreEqual(objects[0].ObjTransform.Position, glm::vec4(0.0f));
+			objects[1].Find("Name")->Get<std::string>() = "Renamed";
+			Assert::AreEqual(archetype->Column<std::string>(Symbol("Name"))[1], string("Renamed"));
+			Transform transform = objects[2].GetTransform();
+			transform.Scale = glm::vec4(3.0f);
+			objects[2].SetTransform(transform);
+			Assert::AreEqual(archetype->Column<glm::vec4>(GameObject::ScaleKey)[2], glm::vec4(3.0f));
+			store.Sync();
+			Assert::AreEqual(objects[0].ObjTransform.Position, glm::vec4(5.0f));
+			Assert::AreEqual(objects[1].Name, string("Renamed"));
+
+			// Subtypes get their own archetype, with the base type's columns too
+			Hero hero;
+			hero.HeroName = "Barry";
+			store.Add(hero);
+			EntityStore::Archetype* heroes = store.Find(Hero::TypeIdClass());
+			Assert::IsNotNull(heroes);
+			Assert::AreEqual(heroes->Column<std::string>(Symbol("HeroName"))[0], string("Barry"));
+			Assert::IsTrue(heroes->HasColumn(GameObject::PositionKey));
+			Assert::AreEqual(archetype->Size(), std::size_t(3));
+		}
+
+		TEST_METHOD(RemoveAndDestroy) {
+			EntityStore store;
+			store.Reserve(GameObject::TypeIdClass(), 2);
+			std::vector<GameObject*> objects;
+			for (int idx = 0; idx < 40; ++idx) {
+				GameObject* object = new GameObject();
+				object->ObjTransform.Position = glm::vec4(float(idx));
+				objects.push_back(object);
+				// Growing the columns past the reserved rows moves them, every attribute follows
+				store.Add(*object);
+			}
+			EntityStore::Archetype& archetype = *store.Find(GameObject::TypeIdClass());
+			for (int idx = 0; idx < 40; ++idx) {
+				Assert::AreEqual(objects[idx]->Find(GameObject::PositionKey)->Get<glm::vec4>(), glm::vec4(float(idx)));
+			}
+
+			// Removing hands the row back to the members, the last row fills the gap
+			objects[3]->Find(GameObject::PositionKey)->Get<glm::vec4>() = glm::vec4(-3.0f);
+			store.Remove(*objects[3]);
+			Assert::IsFalse(store.Contains(*objects[3]));
+			Assert::AreEqual(objects[3]->ObjTransform.Position, glm::vec4(-3.0f));
+			objects[3]->ObjTransform.Position = glm::vec4(7.0f);
+			Assert::AreEqual(objects[3]->Find(GameObject::PositionKey)->Get<glm::vec4>(), glm::vec4(7.0f));
+			Assert::ExpectException<std::invalid_argument>([&store, &objects]() { store.Remove(*objects[3]); });
+			Assert::IsTrue(archetype.Objects()[3] == objects[39]);
+			Assert::AreEqual(archetype.Column<glm::vec4>(GameObject::PositionKey)[3], glm::vec4(39.0f));
+
+			// Deleting a stored object drops its row
+			delete objects[5];
+			Assert::AreEqual(store.Size(), std::size_t(38));
+			Assert::AreEqual(objects[38]->Find(GameObject::PositionKey)->Get<glm::vec4>(), glm::vec4(38.0f));
+			Assert::IsTrue(archetype.Objects()[5] == objects[38]);
+
+			// Clearing hands every row back
+			objects[38]->Find(GameObject::PositionKey)->Get<glm::vec4>() = glm::vec4(100.0f);
+			store.Clear();
+			Assert::AreEqual(store.Size(), std::size_t(0));
+			Assert::AreEqual(objects[38]->ObjTransform.Position, glm::vec4(100.0f));
+			objects.erase(objects.begin() + 5);
+			for (GameObject* object : objects) {
+				Assert::IsNull(object->GetEntityStore());
+				delete object;
+			}
+		}
+
+		TEST_METHOD(CopiesAndMoves) {
+			EntityStore store;
+			GameObject original;
+			original.Name = "Original";
+			store.Add(original);
+			original.Find("Name")->Get<std::string>() = "Stored";
+			original.Find(GameObject::PositionKey)->Get<glm::vec4>() = glm::vec4(2.0f);
+
+			// Copies take the current values and are not stored
+			GameObject copy(original);
+			Assert::IsNull(copy.GetEntityStore());
+			Assert::AreEqual(copy.Name, string("Stored"));
+			Assert::AreEqual(copy.Find(GameObject::PositionKey)->Get<glm::vec4>(), glm::vec4(2.0f));
+			copy.Name = "Copy";
+			Assert::AreEqual(original.Find("Name")->Get<std::string>(), string("Stored"));
+
+			// Assigning to a stored object takes it out of the store
+			GameObject other;
+			store.Add(other);
+			other = copy;
+			Assert::IsNull(other.GetEntityStore());
+			Assert::AreEqual(other.Find("Name")->Get<std::string>(), string("Copy"));
+			Assert::AreEqual(store.Size(), std::size_t(1));
+
+			// So does moving one
+			GameObject moved(std::move(original));
+			Assert::IsNull(original.GetEntityStore());
+			Assert::IsNull(moved.GetEntityStore());
+			Assert::AreEqual(moved.Name, string("Stored"));
+			Assert::AreEqual(moved.GetTransform().Position, glm::vec4(2.0f));
+			Assert::AreEqual(store.Size(), std::size_t(0));
+
+			// A store going first hands its objects their attributes back
+			{
+				EntityStore scoped;
+				scoped.Add(moved);
+				moved.Find(GameObject::PositionKey)->Get<glm::vec4>() = glm::vec4(4.0f);
+			}
+			Assert::AreEqual(moved.ObjTransform.Position, glm::vec4(4.0f));
+			Assert::AreEqual(moved.Find(GameObject::PositionKey)->Get<glm::vec4>(), glm::vec4(4.0f));
+		}
+
+		TEST_METHOD(TransformSystemExclusive) {
+			EntityStore store;
+			TransformSystem transforms;
+			GameObject stored;
+			GameObject managed;
+			store.Add(stored);
+			transforms.Add(managed);
+			Assert::ExpectException<std::runtime_error>([&transforms, &stored]() { transforms.Add(stored); });
+			Assert::ExpectException<std::runtime_error>([&store, &managed]() { store.Add(managed); });
+			EntityStore another;
+			Assert::ExpectException<std::runtime_error>([&another, &stored]() { another.Add(stored); });
+		}
+
+		BENCHMARK_METHOD(ColumnBenchmark) {
+			// Moving 100k GameObjects by a velocity: through their attributes, through their members (the per-object
+			// layout at its best), and down the Position column of their archetype
+			const std::size_t count = 100000;
+			std::vector<GameObject*> objects;
+			objects.reserve(count);
+			for (std::size_t idx = 0; idx < count; ++idx) {
+				objects.push_back(new GameObject());
+			}
+			// Objects of a live world are reached in no particular order
+			std::vector<GameObject*> shuffled = objects;
+			std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(7));
+			const glm::vec4 velocity(1.0f, 0.5f, 0.25f, 0.0f);
+			const int frames = 10;
+			auto ms = [](auto from) { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - from).count() / frames; };
+
+			auto start = std::chrono::steady_clock::now();
+			for (int frame = 0; frame < frames; ++frame) {
+				for (GameObject* object : shuffled) {
+					object->Find(GameObject::PositionKey)->Get<glm::vec4>() += velocity;
+				}
+			}
+			const double attributeMs = ms(start);
+			start = std::chrono::steady_clock::now();
+			for (int frame = 0; frame < frames; ++frame) {
+				for (GameObject* object : shuffled) {
+					object->ObjTransform.Position += velocity;
+				}
+			}
+			const double memberMs = ms(start);
+			start = std::chrono::steady_clock::now();
+			for (int frame = 0; frame < frames; ++frame) {
+				for (GameObject* object : objects) {
+					object->ObjTransform.Position += velocity;
+				}
+			}
+			const double orderedMs = ms(start);
+
+			EntityStore store;
+			store.Reserve(GameObject::TypeIdClass(), count);
+			start = std::chrono::steady_clock::now();
+			for (GameObject* object : objects) {
+				store.Add(*object);
+			}
+			const double addMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			std::span<glm::vec4> positions = store.Find(GameObject::TypeIdClass())->Column<glm::vec4>(GameObject::PositionKey);
+			start = std::chrono::steady_clock::now();
+			for (int frame = 0; frame < frames; ++frame) {
+				for (glm::vec4& position : positions) {
+					position += velocity;
+				}
+			}
+			const double columnMs = ms(start);
+			Assert::AreEqual(shuffled[0]->GetTransform().Position, velocity * float(4 * frames));
+
+			std::string message = "100k GameObjects, ms per pass moving every Position: attribute lookups " + std::to_string(attributeMs)
+				+ ", members " + std::to_string(memberMs) + ", members in allocation order " + std::to_string(orderedMs)
+				+ ", archetype column " + std::to_string(columnMs) + " (storing them all " + std::to_string(addMs) + " ms)";
+			Logger::WriteMessage(message.c_str());
+			store.Clear();
+			for (GameObject* object : objects) {
+				delete object;
+			}
+		}
+
+	private:
+		inline static _CrtMemState _startMemState;
+	};
+}
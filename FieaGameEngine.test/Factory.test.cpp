@@ -19,7 +19,7 @@ namespace FactoryTest
 
 		TEST_METHOD_INITIALIZE(Initialize)
 		{
-			TypeManager::add(AttributedFoo::TypeIdClass(), AttributedFoo::Signatures());
+			TypeManager::add<AttributedFoo>();
 #if defined(DEBUG) || defined(_DEBUG)
 			_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF);
 			_CrtMemCheckpoint(&_startMemState);
@@ -1,25 +1,46 @@
 #include "pch.h"
 #include "CppUnitTest.h"
+#include "Benchmark.h"
 #include "GameObject.h"
 #include "Hero.h"
 #include "Factory.h"
 #include "TableHelper.h"
 #include "ParseCoordinator.h"
+#include "ActionList.h"
+#include "ActionIncrement.h"
 #include "TestTypes.h"
+#include "JobSystem.h"
+#include <chrono>
+#include <random>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace Fiea::GameEngine;
 
 namespace GameObjectTest
 {
+	// Gives object an ActionIncrement adding value to key every Update
+	ActionIncrement* AddIncrement(GameObject& object, const std::string& key, float value) {
+		Datum* actions = object.Find(GameObject::ActionsKey);
+		Scope& list = actions->Size() == 0 ? object.AppendScope("Actions") : *actions->GetScope();
+		ActionIncrement* increment = new ActionIncrement();
+		list.Adopt(*increment, "Increment" + key);
+		increment->SetParent(&object);
+		increment->SetDatumKey(key);
+		increment->SetValue(value);
+		return increment;
+	}
+
 	TEST_CLASS(GameObjectTest)
 	{
 	public:
 
 		TEST_METHOD_INITIALIZE(Initialize)
 		{
-			TypeManager::add(GameObject::TypeIdClass(), GameObject::Signatures());
-			TypeManager::add(Hero::TypeIdClass(), Hero::Signatures());
+			TypeManager::add<GameObject>();
+			TypeManager::add<Hero>();
+			TypeManager::add<Action>();
+			TypeManager::add<ActionList>();
+			TypeManager::add<ActionIncrement>();
 #if defined(DEBUG) || defined(_DEBUG)
 			_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF);
 			_CrtMemCheckpoint(&_startMemState);
@@ -41,6 +62,94 @@ namespace GameObjectTest
 			TypeManager::Clear();
 		}
 
+		TEST_METHOD(InheritedLayout) {
+			// Hero's layout holds GameObject's attributes too
+			const AttributeLayout& layout = TypeManager::layout(Hero::TypeIdClass());
+			Assert::AreEqual(layout.Size(), GameObject::Signatures().size() + Hero::Signatures().size());
+			Assert::IsTrue(layout.Covers(GameObject::TypeIdClass()));
+
+			Hero hero;
+			hero.Name = "Arthur";
+			hero.HeroName = "King";
+			Assert::AreEqual(hero.Find("Name")->Get<string>(), string("Arthur"));
+			Assert::AreEqual(hero.Find("HeroName")->Get<string>(), string("King"));
+			Assert::IsTrue(hero.IsPrescribedAttribute("Name"));
+			Assert::IsTrue(hero.IsPrescribedAttribute("PassiveName"));
+			Assert::IsTrue(hero.IsPrescribedAttribute(GameObject::ChildrenKey));
+			Assert::IsFalse(hero.IsPrescribedAttribute("This"));
+			Assert::AreEqual(hero.GetSize(), layout.Size() + 1);
+			hero.AppendAuxiliaryAttribute("Title") = string("Pendragon");
+			Assert::IsTrue(hero.IsAuxiliaryAttribute("Title"));
+			Assert::IsFalse(hero.IsAuxiliaryAttribute("Name"));
+
+			// Attributes come in the order they were declared, base classes first
+			Assert::IsTrue(hero[1].Get<string>() == "Arthur");
+		}
+
+		TEST_METHOD(PrototypeConstruction) {
+			// Heroes start as copies of the layout's prototype, This and their prescribed attributes are stored in each Hero
+			const Scope& prototype = TypeManager::layout(Hero::TypeIdClass()).Prototype();
+			Hero first;
+			Hero second;
+			first.HeroName = "Arthur";
+			second.HeroName = "Mordred";
+			Assert::AreEqual(first.GetSize(), prototype.GetSize());
+			Assert::IsTrue(static_cast<const void*>(first.Find(Attributed::ThisKey)->AsConstSpan<RTTI*>().data()) == &first);
+			Assert::IsTrue(static_cast<const void*>(second.Find(Attributed::ThisKey)->AsConstSpan<RTTI*>().data()) == &second);
+			Assert::AreEqual(first.Find("HeroName")->Get<string>(), string("Arthur"));
+			Assert::AreEqual(second.Find("HeroName")->Get<string>(), string("Mordred"));
+			first.ObjTransform.Position = Vec4(1.0f, 2.0f, 3.0f, 4.0f);
+			Assert::AreEqual(first.Find("Position")->Get<Vec4>(), Vec4(1.0f, 2.0f, 3.0f, 4.0f));
+			Assert::AreEqual(second.Find("Position")->Get<Vec4>(), Vec4());
+
+			// Children and auxiliary attributes are each Hero's own
+			first.AddChild(new GameObject());
+			first.AppendAuxiliaryAttribute("Title") = string("Pendragon");
+			Assert::AreEqual(first.Find(GameObject::ChildrenKey)->Size(), (size_t)1);
+			Assert::AreEqual(second.Find(GameObject::ChildrenKey)->Size(), (size_t)0);
+			Assert::AreEqual(prototype.Find(GameObject::ChildrenKey)->Size(), (size_t)0);
+			Assert::IsNull(second.Find("Title"));
+			Assert::IsNull(prototype.Find("Title"));
+
+			// Copies point at themselves too
+			Hero copy(first);
+			Assert::IsTrue(static_cast<const void*>(copy.Find(Attributed::ThisKey)->AsConstSpan<RTTI*>().data()) == &copy);
+			Assert::AreEqual(copy.Find("HeroName")->Get<string>(), string("Arthur"));
+			Assert::AreEqual(copy.Find(GameObject::ChildrenKey)->Size(), (size_t)1);
+		}
+
+		BENCHMARK_METHOD(HeroConstructionBenchmark) {
+			const size_t count = 100000;
+			std::vector<Hero*> heroes;
+			heroes.reserve(count);
+			auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < count; ++i) {
+				heroes.push_back(new Hero);
+			}
+			auto constructed = std::chrono::steady_clock::now();
+			size_t prescribed = 0;
+			for (Hero* hero : heroes) {
+				prescribed += hero->IsPrescribedAttribute(GameObject::ChildrenKey);
+			}
+			auto checked = std::chrono::steady_clock::now();
+			for (Hero* hero : heroes) {
+				delete hero;
+			}
+			Assert::AreEqual(prescribed, count);
+
+			// Spawning and destroying one at a time reuses the same memory, so this is the construction work without page faults
+			auto churnStart = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < count; ++i) {
+				delete new Hero;
+			}
+			auto churned = std::chrono::steady_clock::now();
+
+			auto ms = [](auto from, auto to) { return std::to_string(std::chrono::duration<double, std::milli>(to - from).count()); };
+			std::string message = "100k Heroes: construct " + ms(start, constructed) + " ms, IsPrescribedAttribute " + ms(constructed, checked)
+				+ " ms, construct and destroy one at a time " + ms(churnStart, churned) + " ms";
+			Logger::WriteMessage(message.c_str());
+		}
+
 		TEST_METHOD(Constructor) {
 			GameObject* Monster = new GameObject();
 			Monster->Name = "Beast";
@@ -138,6 +247,369 @@ namespace GameObjectTest
 			delete Player;
 		}
 
+		TEST_METHOD(UpdateList) {
+			GameObject* root = new GameObject();
+			GameObject* first = new GameObject();
+			GameObject* second = new GameObject();
+			first->Name = "First";
+			second->Name = "Second";
+			root->AppendAuxiliaryAttribute("Count") = 0;
+			root->AddChild(first);
+			AddIncrement(*first, "Count", 1.0f);
+			GameClock clock;
+			GameTime time = clock.Current();
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 1);
+
+			// Children added after the list was made are updated, in any ancestor's list
+			first->AddChild(second);
+			AddIncrement(*second, "Count", 10.0f);
+			root->Update(time);
+			Assert::IsTrue(second->Updated);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 12);
+			first->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 23);
+
+			// Removed and deleted ones are not
+			Assert::IsTrue(first->RemoveChild(second));
+			second->Updated = false;
+			root->Update(time);
+			Assert::IsFalse(second->Updated);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 24);
+			root->AddChild(second);
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 35);
+			delete second;
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 36);
+
+			// So are deleted Actions
+			delete first->Actions(0)->GetScope();
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 36);
+
+			// Actions and Children adopted through the Scope API are picked up too
+			ActionIncrement* extra = new ActionIncrement();
+			first->Find(GameObject::ActionsKey)->GetScope()->Adopt(*extra, "Extra");
+			extra->SetParent(first);
+			extra->SetDatumKey("Count");
+			extra->SetValue(100.0f);
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 136);
+			GameObject* third = new GameObject();
+			third->Name = "Third";
+			first->AppendScope("Children").Adopt(*third, third->Name);
+			root->Update(time);
+			Assert::IsTrue(third->Updated);
+			AddIncrement(*third, "Count", 1000.0f);
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 1336);
+			third->Orphan();
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 1436);
+			delete third;
+			delete root;
+		}
+
+		BENCHMARK_METHOD(UpdateListBenchmark) {
+			// 10k GameObjects, a spine 100 deep with 99 leaves on every level, every 10th one has an ActionIncrement
+			GameObject* root = new GameObject();
+			GameObject* spine = root;
+			std::size_t count = 1;
+			for (int level = 0; level < 100; ++level) {
+				for (int leaf = 0; leaf < 99; ++leaf) {
+					GameObject* object = new GameObject();
+					object->Name = "Leaf" + std::to_string(leaf);
+					object->AppendAuxiliaryAttribute("Health") = 0;
+					if (count++ % 10 == 0) {
+						AddIncrement(*object, "Health", 1.0f);
+					}
+					spine->AddChild(object);
+				}
+				GameObject* next = new GameObject();
+				next->Name = "Spine";
+				spine->AddChild(next);
+				spine = next;
+				++count;
+			}
+
+			GameClock clock;
+			GameTime time = clock.Current();
+			JobSystem recursive(0);
+			const int frames = 20;
+			auto ms = [](auto from) { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - from).count() / frames; };
+			root->Update(time);
+			auto start = std::chrono::steady_clock::now();
+			for (int frame = 0; frame < frames; ++frame) {
+				root->Update(time, recursive);
+			}
+			double recursiveMs = ms(start);
+			start = std::chrono::steady_clock::now();
+			for (int frame = 0; frame < frames; ++frame) {
+				root->Update(time);
+			}
+			double listMs = ms(start);
+			// Every frame made again after a change
+			start = std::chrono::steady_clock::now();
+			for (int frame = 0; frame < frames; ++frame) {
+				spine->InvalidateUpdateList();
+				root->Update(time);
+			}
+			double rebuiltMs = ms(start);
+			Assert::IsTrue(spine->Updated);
+
+			std::string message = std::to_string(count) + " GameObjects 100 deep, ms per Update: recursive walk " + std::to_string(recursiveMs)
+				+ ", Update list " + std::to_string(listMs) + ", Update list made again every frame " + std::to_string(rebuiltMs);
+			Logger::WriteMessage(message.c_str());
+			delete root;
+		}
+
+		TEST_METHOD(ParallelUpdate) {
+			// Every child counts itself and its children in their own Health, and all of them in the root's Count
+			GameObject* root = new GameObject();
+			root->AppendAuxiliaryAttribute("Count") = 0;
+			std::vector<GameObject*> objects;
+			for (int child = 0; child < 100; ++child) {
+				GameObject* object = new GameObject();
+				object->Name = "Child" + std::to_string(child);
+				object->AppendAuxiliaryAttribute("Health") = 0;
+				root->AddChild(object);
+				objects.push_back(object);
+				for (int grandchild = 0; grandchild < 5; ++grandchild) {
+					GameObject* leaf = new GameObject();
+					leaf->Name = "Leaf" + std::to_string(grandchild);
+					leaf->AppendAuxiliaryAttribute("Health") = 0;
+					object->AddChild(leaf);
+					objects.push_back(leaf);
+					AddIncrement(*leaf, "Health", 1.0f);
+				}
+				Assert::IsTrue(AddIncrement(*object, "Health", 1.0f)->GetReach() == Action::Reach::Subtree);
+				Assert::IsTrue(AddIncrement(*object, "Count", 1.0f)->GetReach() == Action::Reach::Ancestors);
+			}
+
+			// Count is the root's, those increments wait for the parallel pass and don't race
+			JobSystem jobs(3);
+			GameClock clock;
+			GameTime time = clock.Current();
+			const int frames = 10;
+			for (int frame = 0; frame < frames; ++frame) {
+				root->Update(time, jobs);
+			}
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 100 * frames);
+			for (GameObject* object : objects) {
+				Assert::AreEqual(object->Find("Health")->Get<int>(), frames);
+				Assert::IsTrue(object->Updated);
+			}
+
+			// The serial Update reaches every child too
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 100 * (frames + 1));
+			Assert::AreEqual(objects.back()->Find("Health")->Get<int>(), frames + 1);
+
+			// Lists reach as far as their widest action
+			ActionList* list = new ActionList();
+			objects.front()->Find(GameObject::ActionsKey)->GetScope()->Adopt(*list, "List");
+			list->SetParent(objects.front());
+			Assert::IsTrue(list->GetReach() == Action::Reach::Subtree);
+			ActionIncrement* inner = new ActionIncrement();
+			inner->SetName("Inner");
+			list->AppendScope("Actions");
+			list->AddAction(inner);
+			inner->SetParent(objects.front());
+			inner->SetDatumKey("Count");
+			inner->SetValue(1.0f);
+			Assert::IsTrue(list->GetReach() == Action::Reach::Ancestors);
+			root->Update(time, jobs);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 100 * (frames + 1) + 101);
+			delete root;
+		}
+
+		BENCHMARK_METHOD(ParallelUpdateBenchmark) {
+			// 50k GameObjects (50 branches of 20 groups of 49 leaves), each incrementing its own Health every Update
+			GameObject* root = new GameObject();
+			std::size_t count = 1;
+			auto make = [&count](GameObject& parent, const std::string& name) {
+				GameObject* object = new GameObject();
+				object->Name = name;
+				object->AppendAuxiliaryAttribute("Health") = 0;
+				AddIncrement(*object, "Health", 1.0f);
+				parent.AddChild(object);
+				++count;
+				return object;
+			};
+			for (int branch = 0; branch < 50; ++branch) {
+				GameObject* middle = make(*root, "Branch" + std::to_string(branch));
+				for (int group = 0; group < 20; ++group) {
+					GameObject* parent = make(*middle, "Group" + std::to_string(group));
+					for (int leaf = 0; leaf < 49; ++leaf) {
+						make(*parent, "Leaf" + std::to_string(leaf));
+					}
+				}
+			}
+
+			GameClock clock;
+			GameTime time = clock.Current();
+			const int frames = 5;
+			auto ms = [](auto from) { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - from).count(); };
+			auto start = std::chrono::steady_clock::now();
+			for (int frame = 0; frame < frames; ++frame) {
+				root->Update(time);
+			}
+			std::string message = std::to_string(count) + " GameObjects, ms per Update: serial " + std::to_string(ms(start) / frames);
+
+			// 1 thread is the calling one with no workers, up to every hardware thread
+			const std::size_t hardware = std::max<std::size_t>(JobSystem::DefaultWorkers() + 1, 2);
+			int updates = frames;
+			for (std::size_t threads = 1; threads <= hardware; threads *= 2) {
+				JobSystem jobs(threads - 1);
+				root->Update(time, jobs);
+				start = std::chrono::steady_clock::now();
+				for (int frame = 0; frame < frames; ++frame) {
+					root->Update(time, jobs);
+				}
+				message += ", " + std::to_string(threads) + " threads " + std::to_string(ms(start) / frames);
+				updates += frames + 1;
+			}
+			const GameObject* leaf = (*(*(*root->Find(GameObject::ChildrenKey)->GetScope())[0].GetScope()->Find(GameObject::ChildrenKey)->GetScope())[0].GetScope()->Find(GameObject::ChildrenKey)->GetScope())[0].GetScope()->As<GameObject>();
+			Assert::AreEqual(leaf->Find("Health")->Get<int>(), updates);
+			Logger::WriteMessage(message.c_str());
+			delete root;
+		}
+
+		TEST_METHOD(Sleeping) {
+			GameObject* root = new GameObject();
+			GameObject* child = new GameObject();
+			GameObject* grandchild = new GameObject();
+			child->Name = "Child";
+			grandchild->Name = "Grandchild";
+			root->AppendAuxiliaryAttribute("Count") = 0;
+			root->AddChild(child);
+			child->AddChild(grandchild);
+			ActionIncrement* increment = AddIncrement(*root, "Count", 1.0f);
+			AddIncrement(*child, "Count", 10.0f);
+			AddIncrement(*grandchild, "Count", 100.0f);
+			auto now = std::chrono::high_resolution_clock::now();
+			GameClock clock([&now]() { return now; });
+			GameTime time = clock.Current();
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 111);
+
+			// Sleeping Actions are skipped until woken
+			increment->Sleep();
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 221);
+			increment->Wake();
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 332);
+
+			// Sleeping GameObjects with their subtree
+			child->Sleep();
+			child->Updated = false;
+			grandchild->Updated = false;
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 333);
+			Assert::IsFalse(child->Updated);
+			Assert::IsFalse(grandchild->Updated);
+			JobSystem jobs(2);
+			root->Update(time, jobs);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 334);
+			child->Wake();
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 445);
+			Assert::IsTrue(grandchild->Updated);
+
+			// Timers wake them on the first Update at or after the time
+			child->SleepFor(100, time);
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 446);
+			now += std::chrono::milliseconds(99);
+			clock.Update(time);
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 447);
+			now += std::chrono::milliseconds(1);
+			clock.Update(time);
+			root->Update(time, jobs);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 558);
+			Assert::IsFalse(child->IsAsleep());
+
+			// So do writes to a watched attribute, also one kept outside the Scope
+			grandchild->AppendAuxiliaryAttribute("Health") = 0;
+			grandchild->SleepUntilChanged(*grandchild->Find("Health"));
+			root->Update(time);
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 580);
+			*grandchild->Find("Health") = 5;
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 691);
+			child->SleepUntilChanged(*child->Find("Name"));
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 692);
+			child->Name = "Renamed";
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 803);
+
+			// Deleting a sleeper is fine, its subtree is gone with it
+			child->SleepUntilChanged(*child->Find("Name"));
+			root->Update(time);
+			delete child;
+			root->Update(time);
+			Assert::AreEqual(root->Find("Count")->Get<int>(), 805);
+			delete root;
+		}
+
+		BENCHMARK_METHOD(SleepingBenchmark) {
+			// 10k GameObjects with an ActionIncrement each, in 100 groups of 100, all but one group asleep
+			GameObject* root = new GameObject();
+			std::vector<GameObject*> groups;
+			for (int group = 0; group < 100; ++group) {
+				GameObject* parent = new GameObject();
+				parent->Name = "Group" + std::to_string(group);
+				for (int member = 0; member < 100; ++member) {
+					GameObject* object = new GameObject();
+					object->Name = "Member" + std::to_string(member);
+					object->AppendAuxiliaryAttribute("Health") = 0;
+					AddIncrement(*object, "Health", 1.0f);
+					parent->AddChild(object);
+				}
+				root->AddChild(parent);
+				groups.push_back(parent);
+			}
+
+			GameClock clock;
+			GameTime time = clock.Current();
+			const int frames = 20;
+			auto ms = [](auto from) { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - from).count() / frames; };
+			root->Update(time);
+			auto start = std::chrono::steady_clock::now();
+			for (int frame = 0; frame < frames; ++frame) {
+				root->Update(time);
+			}
+			const double awakeMs = ms(start);
+			for (std::size_t group = 1; group < groups.size(); ++group) {
+				groups[group]->Sleep();
+			}
+			root->Update(time);
+			start = std::chrono::steady_clock::now();
+			for (int frame = 0; frame < frames; ++frame) {
+				root->Update(time);
+			}
+			const double sleepingMs = ms(start);
+			// A group wakes and another one sleeps every frame, the active list is made again each time
+			start = std::chrono::steady_clock::now();
+			for (int frame = 0; frame < frames; ++frame) {
+				groups[frame % 10 + 1]->Wake();
+				groups[frame % 10]->Sleep();
+				root->Update(time);
+			}
+			const double changingMs = ms(start);
+			Assert::AreEqual(groups[0]->Find(GameObject::ChildrenKey)->GetScope()->Find("Member0")->GetScope()->Find("Health")->Get<int>(), 2 * frames + 2);
+
+			std::string message = "10100 GameObjects, ms per Update: all awake " + std::to_string(awakeMs) + ", 99% asleep "
+				+ std::to_string(sleepingMs) + ", 99% asleep changing every frame " + std::to_string(changingMs);
+			Logger::WriteMessage(message.c_str());
+			delete root;
+		}
+
 		TEST_METHOD(ParsingFromJson) {
 			Scope MainChar;
 			TableHelper::TableWrapper Twrapper(MainChar);
@@ -185,6 +657,221 @@ namespace GameObjectTest
 		}
 
 
+		TEST_METHOD(ConstructionAllocations) {
+#if defined(DEBUG) || defined(_DEBUG)
+			// A typical content object: prescribed attributes plus a handful of single value auxiliaries
+			auto build = []() {
+				GameObject* sword = new GameObject();
+				sword->Name = "Excalibur";
+				sword->AppendAuxiliaryAttribute("Damage") = 25;
+				sword->AppendAuxiliaryAttribute("Range") = 5;
+				sword->AppendAuxiliaryAttribute("Durability") = 99.9f;
+				sword->AppendAuxiliaryAttribute("Subclass") = std::string("Longsword");
+				sword->AppendAuxiliaryAttribute("Tint") = Vec4(1.0f, 0.8f, 0.2f, 1.0f);
+				return sword;
+			};
+			// Interns the keys so the symbol table doesn't show up in the counts
+			delete build();
+
+			GameObject* sword = nullptr;
+			size_t constructed = 0;
+			{
+				AllocationCounter counter;
+				sword = build();
+				constructed = counter.Count();
+			}
+			GameObject* copy = nullptr;
+			size_t cloned = 0;
+			{
+				AllocationCounter counter;
+				copy = sword->Clone();
+				cloned = counter.Count();
+			}
+			Assert::AreEqual(copy->Find("Subclass")->Get<string>(), string("Longsword"));
+			Assert::AreEqual(copy->Find("Damage")->Get<int>(), 25);
+
+			// Single values live inside their Datum, only the attribute entries themselves hit the heap
+			{
+				AllocationCounter counter;
+				(*sword)["Damage"] = 30;
+				(*sword)["Durability"] = 50.0f;
+				(*sword)["Subclass"] = std::string("Claymore");
+				(*sword)["Tint"] = Vec4(0.0f, 0.0f, 1.0f, 1.0f);
+				Assert::AreEqual((size_t)0, counter.Count());
+			}
+
+			std::string message = "GameObject construction: " + std::to_string(constructed) + " allocations, clone: " + std::to_string(cloned) + " allocations";
+			Logger::WriteMessage(message.c_str());
+			delete copy;
+			delete sword;
+#endif
+		}
+
+		BENCHMARK_METHOD(CloneSharedBenchmark) {
+			// An archetype of 50 attributes: the 6 prescribed ones plus 44 auxiliaries, a few of them large arrays,
+			// and an ActionList holding ActionIncrements
+			GameObject* prototype = new GameObject();
+			prototype->Name = "Grunt";
+			for (int i = 0; i < 20; ++i) {
+				prototype->AppendAuxiliaryAttribute("Stat" + std::to_string(i)) = i;
+			}
+			for (int i = 0; i < 10; ++i) {
+				prototype->AppendAuxiliaryAttribute("Modifier" + std::to_string(i)) = (float)i * 0.5f;
+			}
+			for (int i = 0; i < 8; ++i) {
+				prototype->AppendAuxiliaryAttribute("Tag" + std::to_string(i)) = std::string("grunt tag number ") + std::to_string(i);
+			}
+			for (int i = 0; i < 4; ++i) {
+				Datum& waypoints = prototype->AppendAuxiliaryAttribute("Waypoints" + std::to_string(i));
+				for (int j = 0; j < 64; ++j) {
+					waypoints.Push(Vec4((float)j, (float)i, 0.0f, 1.0f));
+				}
+			}
+			for (int i = 0; i < 2; ++i) {
+				Datum& table = prototype->AppendAuxiliaryAttribute("LootTable" + std::to_string(i));
+				for (int j = 0; j < 256; ++j) {
+					table.Push(j);
+				}
+			}
+			Scope& actions = prototype->AppendScope("Actions");
+			ActionList* behaviour = new ActionList();
+			behaviour->SetName("Behaviour");
+			behaviour->SetParent(prototype);
+			actions.Adopt(*behaviour, "Behaviour");
+			Scope& steps = behaviour->AppendScope("Actions");
+			for (int i = 0; i < 4; ++i) {
+				ActionIncrement* increment = new ActionIncrement();
+				increment->SetName("Step" + std::to_string(i));
+				increment->SetParent(prototype);
+				increment->SetValue(1.0f);
+				steps.Adopt(*increment, increment->GetName());
+			}
+
+			auto elapsed = [](auto from) {
+				return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - from).count();
+			};
+			const size_t count = 10000;
+			std::vector<Scope*> clones;
+			clones.reserve(count);
+
+			size_t deepAllocations = 0;
+			double deepMs = 0.0;
+			{
+#if defined(DEBUG) || defined(_DEBUG)
+				AllocationCounter counter;
+#endif
+				auto start = std::chrono::steady_clock::now();
+				for (size_t i = 0; i < count; ++i) {
+					clones.push_back(prototype->Clone());
+				}
+				deepMs = elapsed(start);
+#if defined(DEBUG) || defined(_DEBUG)
+				deepAllocations = counter.Count();
+#endif
+			}
+			for (Scope* clone : clones) {
+				delete clone;
+			}
+			clones.clear();
+
+			size_t sharedAllocations = 0;
+			double sharedMs = 0.0;
+			{
+#if defined(DEBUG) || defined(_DEBUG)
+				AllocationCounter counter;
+#endif
+				auto start = std::chrono::steady_clock::now();
+				for (size_t i = 0; i < count; ++i) {
+					clones.push_back(prototype->CloneShared());
+				}
+				sharedMs = elapsed(start);
+#if defined(DEBUG) || defined(_DEBUG)
+				sharedAllocations = counter.Count();
+#endif
+			}
+
+			// Every spawn moves and gets its own stats, the shared arrays stay untouched
+			auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < count; ++i) {
+				GameObject* clone = clones[i]->As<GameObject>();
+				clone->ObjTransform.Position = Vec4((float)i, 0.0f, 0.0f, 1.0f);
+				(*clone)["Stat0"] = (int)i;
+			}
+			double touchMs = elapsed(start);
+
+			// Half of them diverge from the archetype in an array and in their Actions
+			start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < count; i += 2) {
+				clones[i]->Find("Waypoints0")->GetVector(0) = Vec4(-1.0f);
+				clones[i]->Find(GameObject::ActionsKey)->GetScope()->Find("Behaviour")->GetScope()->As<ActionList>()->SetName("Diverged");
+			}
+			double divergeMs = elapsed(start);
+
+			const GameObject& first = *clones[0]->As<GameObject>();
+			const GameObject& second = *clones[1]->As<GameObject>();
+			Assert::AreEqual(first.Find("Waypoints0")->GetVector(0), Vec4(-1.0f));
+			Assert::AreEqual(second.Find("Waypoints0")->GetVector(0), Vec4(0.0f, 0.0f, 0.0f, 1.0f));
+			Assert::AreEqual(second.Find("Stat0")->GetInt(), 1);
+			// Nested Scopes like the Actions are cloned per spawn, only their leaf arrays are shared
+			Assert::IsTrue(second.Find(GameObject::ActionsKey)->GetScope() != &actions);
+			Assert::IsTrue(second.Find(GameObject::ActionsKey)->GetScope()->GetParent() == &second);
+			Assert::AreEqual(prototype->Find("Waypoints0")->GetVector(0), Vec4(0.0f, 0.0f, 0.0f, 1.0f));
+			Assert::AreEqual(behaviour->GetName(), std::string("Behaviour"));
+
+			std::string message = "Spawn 10k 50 attribute GameObjects: Clone " + std::to_string(deepMs) + " ms (" + std::to_string(deepAllocations)
+				+ " allocations), CloneShared " + std::to_string(sharedMs) + " ms (" + std::to_string(sharedAllocations) + " allocations), "
+				+ "first writes " + std::to_string(touchMs) + " ms, diverging half " + std::to_string(divergeMs) + " ms";
+			Logger::WriteMessage(message.c_str());
+
+			delete prototype;
+			for (Scope* clone : clones) {
+				delete clone;
+			}
+		}
+
+		BENCHMARK_METHOD(DespawnBenchmark) {
+			// Despawns 10k children of one GameObject in random order, as a level would
+			const size_t count = 10000;
+			GameObject* level = new GameObject();
+			std::vector<GameObject*> children;
+			children.reserve(count);
+			for (size_t i = 0; i < count; ++i) {
+				GameObject* child = new GameObject();
+				child->Name = "Enemy" + std::to_string(i);
+				Assert::IsTrue(level->AddChild(child));
+				children.push_back(child);
+			}
+			std::shuffle(children.begin(), children.end(), std::mt19937(12345));
+
+			auto start = std::chrono::steady_clock::now();
+			for (GameObject* child : children) {
+				Assert::IsTrue(level->RemoveChild(child));
+				delete child;
+			}
+			double removeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			GameObject stranger;
+			Assert::IsFalse(level->RemoveChild(&stranger));
+
+			// The same through plain Scopes, deleting a child orphans it
+			Scope parent;
+			std::vector<Scope*> scopes;
+			scopes.reserve(count);
+			for (size_t i = 0; i < count; ++i) {
+				scopes.push_back(&parent.AppendScope("Enemies"));
+			}
+			std::shuffle(scopes.begin(), scopes.end(), std::mt19937(12345));
+			start = std::chrono::steady_clock::now();
+			for (Scope* scope : scopes) {
+				delete scope;
+			}
+			double deleteMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			Assert::AreEqual(parent.Find("Enemies")->Size(), (size_t)0);
+
+			std::string message = "Despawn 10k children: GameObject::RemoveChild " + std::to_string(removeMs) + " ms, delete from one Table "
+				+ std::to_string(deleteMs) + " ms";
+			Logger::WriteMessage(message.c_str());
+			delete level;
+		}
 
 	private:
 		inline static _CrtMemState _startMemState;
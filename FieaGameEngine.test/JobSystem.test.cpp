@@ -0,0 +1,107 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "JobSystem.h"
+#include <atomic>
+#include <stdexcept>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Fiea::GameEngine;
+
+namespace JobSystemTest
+{
+	// Sums [first, last) splitting it in jobs down to 64 numbers
+	long long Sum(JobSystem& jobs, long long first, long long last) {
+		if (last - first <= 64) {
+			long long total = 0;
+			for (long long value = first; value < last; ++value) {
+				total += value;
+			}
+			return total;
+		}
+		const long long middle = first + (last - first) / 2;
+		long long left = 0;
+		JobSystem::Group group;
+		jobs.Run(group, [&jobs, &left, first, middle]() { left = Sum(jobs, first, middle); });
+		const long long right = Sum(jobs, middle, last);
+		jobs.Wait(group);
+		return left + right;
+	}
+
+	TEST_CLASS(JobSystemTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(Initialize)
+		{
+#if defined(DEBUG) || defined(_DEBUG)
+			_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF);
+			_CrtMemCheckpoint(&_startMemState);
+#endif
+		}
+
+		TEST_METHOD_CLEANUP(Cleanup)
+		{
+#if defined(DEBUG) || defined(_DEBUG)
+			_CrtMemState endMemState, diffMemState;
+			_CrtMemCheckpoint(&endMemState);
+			if (_CrtMemDifference(&diffMemState, &_startMemState, &endMemState))
+			{
+				_CrtDumpMemoryLeaks();
+				_CrtMemDumpStatistics(&diffMemState);
+				Assert::Fail(L"Memory Leaks!");
+			}
+#endif
+		}
+
+		TEST_METHOD(RunAndWait) {
+			// Without workers the waiting thread runs everything
+			for (std::size_t workers : { std::size_t(0), std::size_t(3) }) {
+				JobSystem jobs(workers);
+				Assert::AreEqual(jobs.WorkerCount(), workers);
+				std::atomic<int> count = 0;
+				JobSystem::Group group;
+				for (int idx = 0; idx < 1000; ++idx) {
+					jobs.Run(group, [&count]() { count.fetch_add(1); });
+				}
+				jobs.Wait(group);
+				Assert::IsTrue(group.Done());
+				Assert::AreEqual(count.load(), 1000);
+
+				// An empty group is done right away
+				JobSystem::Group empty;
+				jobs.Wait(empty);
+			}
+		}
+
+		TEST_METHOD(NestedJobs) {
+			// Jobs fork jobs and wait for them, waiting workers keep running jobs so nothing stalls
+			JobSystem jobs(3);
+			Assert::AreEqual(Sum(jobs, 0, 100000), 100000LL * 99999LL / 2);
+			JobSystem serial(0);
+			Assert::AreEqual(Sum(serial, 0, 10000), 10000LL * 9999LL / 2);
+		}
+
+		TEST_METHOD(Exceptions) {
+			JobSystem jobs(2);
+			std::atomic<int> count = 0;
+			JobSystem::Group group;
+			for (int idx = 0; idx < 100; ++idx) {
+				jobs.Run(group, [&count, idx]() {
+					if (idx % 10 == 0) {
+						throw std::runtime_error("job failed");
+					}
+					count.fetch_add(1);
+				});
+			}
+			// Every job still runs, the first exception comes back once
+			Assert::ExpectException<std::runtime_error>([&jobs, &group]() { jobs.Wait(group); });
+			Assert::AreEqual(count.load(), 90);
+			jobs.Run(group, [&count]() { count.fetch_add(1); });
+			jobs.Wait(group);
+			Assert::AreEqual(count.load(), 91);
+		}
+
+	private:
+		inline static _CrtMemState _startMemState;
+	};
+}
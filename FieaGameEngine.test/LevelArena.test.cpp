@@ -0,0 +1,111 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "LevelArena.h"
+#include "TableHelper.h"
+#include "ParseCoordinator.h"
+#include "TestTypes.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Fiea::GameEngine;
+
+namespace LevelArenaTest
+{
+	TEST_CLASS(LevelArenaTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(Initialize)
+		{
+#if defined(DEBUG) || defined(_DEBUG)
+			_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF);
+			_CrtMemCheckpoint(&_startMemState);
+#endif
+		}
+
+		TEST_METHOD_CLEANUP(Cleanup)
+		{
+#if defined(DEBUG) || defined(_DEBUG)
+			_CrtMemState endMemState, diffMemState;
+			_CrtMemCheckpoint(&endMemState);
+			if (_CrtMemDifference(&diffMemState, &_startMemState, &endMemState))
+			{
+				_CrtDumpMemoryLeaks();
+				_CrtMemDumpStatistics(&diffMemState);
+				Assert::Fail(L"Memory Leaks!");
+			}
+#endif
+		}
+
+		TEST_METHOD(Constructor) {
+			LevelArena level;
+			Assert::IsTrue(level.Root().GetResource() == level.Resource());
+			Assert::IsTrue(level.Root().GetStorage() == Scope::Storage::Hashed);
+			Assert::IsNull(level.Root().GetParent());
+			Assert::IsTrue(level.Root().isEmpty());
+
+			LevelArena flatLevel(1024, Scope::Storage::Flat);
+			Assert::IsTrue(flatLevel.Root().GetStorage() == Scope::Storage::Flat);
+		}
+
+		TEST_METHOD(BuildAndReset) {
+			LevelArena level;
+			for (int i = 0; i < 100; ++i) {
+				Scope& object = level.Root().AppendScope("Objects");
+				object.Append("Health") = i;
+				object.Append("Name") = std::string("A name too long for the small string buffer ") + std::to_string(i);
+				Datum& path = object.Append("Path");
+				for (int j = 0; j < 20; ++j) {
+					path.Push(glm::vec4((float)j));
+				}
+				Assert::IsTrue(object.GetResource() == level.Resource());
+			}
+			Datum& objects = level.Root()["Objects"];
+			Assert::AreEqual(objects.Size(), (size_t)100);
+			Assert::AreEqual(objects[99]["Health"].GetInt(), 99);
+			Assert::AreEqual(objects[42]["Path"].Get<glm::vec4>(19), glm::vec4(19.0f));
+
+			// A heap Scope adopted into the level is deleted with it
+			Scope* heapScope = new Scope();
+			heapScope->Append("Heap") = 1;
+			level.Root().Adopt(*heapScope, "Adopted");
+
+			level.Reset();
+			Assert::IsTrue(level.Root().isEmpty());
+			Assert::IsNull(level.Root().Find("Objects"));
+
+			// The arena is reusable after a Reset
+			Scope& next = level.Root().AppendScope("NextLevel");
+			next.Append("Health") = 5;
+			Assert::AreEqual(level.Root()["NextLevel"][0]["Health"].GetInt(), 5);
+		}
+
+		TEST_METHOD(ParseIntoArena) {
+			std::string json = R"({
+				"Health": 500,
+				"Buffs": [2.5, 5.0],
+				"Club" : {
+					"Damage": 25,
+					"Name": "Stone Club"
+				}
+			})";
+			LevelArena level;
+			TableHelper::TableWrapper wrapper(level.Root());
+			ParseCoordinator parser(wrapper);
+			TableHelper* handler = new TableHelper();
+			parser.AddHandler(handler);
+			Assert::IsTrue(parser.DeserializeObject(json));
+
+			Scope& root = level.Root();
+			Assert::AreEqual(root["Health"].GetInt(), 500);
+			Assert::AreEqual(root["Buffs"].GetFloat(1), 5.0f);
+			Scope* club = root["Club"].GetScope();
+			Assert::IsTrue(club->GetResource() == level.Resource());
+			Assert::AreEqual((*club)["Damage"].GetInt(), 25);
+			Assert::AreEqual((*club)["Name"].GetString(), std::string("Stone Club"));
+			parser.RemoveHandler(handler);
+		}
+
+	private:
+		inline static _CrtMemState _startMemState;
+	};
+}
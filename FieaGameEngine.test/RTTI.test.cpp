@@ -1,16 +1,43 @@
 #include "pch.h"
 #include "CppUnitTest.h"
+#include "Benchmark.h"
 #include "RTTI.h"
 #include "Foo.h"
 #include "FooChild.h"
 #include "Empty.h"
 #include "TestTypes.h"
+#include <chrono>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace Fiea::GameEngine;
 
 namespace RTTITest
 {
+	// Five RTTI levels deep: Foo, FooChild, Level3, Level4, Level5
+	class Level3 : public FooChild {
+		RTTI_DECLARATIONS(Level3, FooChild);
+	};
+	class Level4 : public Level3 {
+		RTTI_DECLARATIONS(Level4, Level3);
+	};
+	class Level5 : public Level4 {
+		RTTI_DECLARATIONS(Level5, Level4);
+	};
+
+	// A polymorphic first base, so the RTTI part of Mixed does not start at its address
+	struct Payload {
+		virtual ~Payload() = default;
+		std::int64_t Bytes[4] = {};
+	};
+	class Mixed : public Payload, public Foo {
+		RTTI_DECLARATIONS(Mixed, Foo);
+	};
+
+	RTTI_DEFINITIONS(Level3);
+	RTTI_DEFINITIONS(Level4);
+	RTTI_DEFINITIONS(Level5);
+	RTTI_DEFINITIONS(Mixed);
+
 	TEST_CLASS(RTTITest)
 	{
 	public:
@@ -65,6 +92,78 @@ namespace RTTITest
 			Assert::IsFalse(foo.Is(empt.TypeIdClass()));
 			Assert::IsFalse(child.Is(empt.TypeIdClass()));
 
+			// Every ancestor sits at its depth
+			Level5 deep;
+			Assert::AreEqual(Level5::TypeDepth, (size_t)5);
+			Assert::IsTrue(deep.Is(Foo::TypeIdClass()));
+			Assert::IsTrue(deep.Is(Level3::TypeIdClass()));
+			Assert::IsTrue(deep.Is<Level5>());
+			Assert::IsTrue(deep.Is<RTTI>());
+			Assert::IsFalse(deep.Is<Empty>());
+			Level3 shallow;
+			Assert::IsFalse(shallow.Is<Level4>());
+			Assert::IsFalse(shallow.Is(Level5::TypeIdClass()));
+			RTTI::Ancestry ancestry = deep.AncestryInstance();
+			Assert::AreEqual(ancestry.Depth, (size_t)5);
+			Assert::IsTrue(ancestry.Ids[0] == Foo::TypeIdAddress());
+			Assert::AreEqual(*ancestry.Ids[4], Level5::TypeIdClass());
+		}
+
+		TEST_METHOD(AsDeepHierarchy) {
+			Level5 deep;
+			RTTI* rtti = &deep;
+			Assert::IsTrue(rtti->As<Foo>() == &deep);
+			Assert::IsTrue(rtti->As<FooChild>() == &deep);
+			Assert::IsTrue(rtti->As<Level4>() == &deep);
+			Assert::IsTrue(rtti->As<Level5>() == &deep);
+			Assert::IsNull(rtti->As<Empty>());
+			const RTTI* constRtti = rtti;
+			Assert::IsTrue(constRtti->As<Level3>() == &deep);
+
+			Level3 shallow;
+			Assert::IsNull(shallow.As<Level4>());
+
+			// With another base in front As has to adjust the pointer, not reinterpret it
+			Mixed mixed;
+			rtti = &mixed;
+			Assert::IsTrue((void*)rtti != (void*)&mixed);
+			Assert::IsTrue(rtti->As<Mixed>() == &mixed);
+			Assert::IsTrue(rtti->As<Foo>() == &mixed);
+			Assert::IsNull(rtti->As<FooChild>());
+		}
+
+		BENCHMARK_METHOD(Benchmark) {
+			// As<> through RTTI pointers on a mix of depths, hits at every level and misses
+			std::vector<RTTI*> objects;
+			for (int i = 0; i < 256; ++i) {
+				switch (i % 4) {
+				case 0: objects.push_back(new Level5); break;
+				case 1: objects.push_back(new Level3); break;
+				case 2: objects.push_back(new Foo); break;
+				default: objects.push_back(new Empty); break;
+				}
+			}
+			const size_t repeats = 40000;
+
+			size_t found = 0;
+			auto start = std::chrono::steady_clock::now();
+			for (size_t r = 0; r < repeats; ++r) {
+				for (RTTI* object : objects) {
+					found += object->As<Foo>() != nullptr;
+					found += object->As<Level3>() != nullptr;
+					found += object->As<Level5>() != nullptr;
+					found += object->As<Empty>() != nullptr;
+				}
+			}
+			auto finished = std::chrono::steady_clock::now();
+			Assert::AreEqual(found, repeats * 7 * 64);
+			for (RTTI* object : objects) {
+				delete object;
+			}
+
+			double ms = std::chrono::duration<double, std::milli>(finished - start).count();
+			std::string message = "41M As<> calls on 1 to 5 deep hierarchies: " + std::to_string(ms) + " ms";
+			Logger::WriteMessage(message.c_str());
 		}
 
 	private:
@@ -1,7 +1,10 @@
 #include "pch.h"
 #include "CppUnitTest.h"
+#include "Benchmark.h"
 #include "Scope.h"
 #include "TestTypes.h"
+#include <chrono>
+#include <utility>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace Fiea::GameEngine;
@@ -144,6 +147,94 @@ namespace ScopeTest
 			Assert::AreEqual(*d, *d2);
 		}
 
+		TEST_METHOD(SearchCache) {
+			for (Scope::Storage storage : { Scope::Storage::Hashed, Scope::Storage::Flat }) {
+				Scope root(0, storage);
+				root.Append("Gravity") = 9.8f;
+				Scope& level = root.AppendScope("Level");
+				Scope& enemy = level.AppendScope("Enemies");
+				Scope& weapon = enemy.AppendScope("Weapon");
+
+				// The first Search walks up, the second one is answered from the cache
+				Scope::ResetSearchStats();
+				const Scope* owner = nullptr;
+				Assert::IsTrue(std::as_const(weapon).Search("Gravity", &owner) == root.Find("Gravity"));
+				Assert::IsTrue(owner == &root);
+				owner = nullptr;
+				Assert::IsTrue(std::as_const(weapon).Search("Gravity", &owner) == root.Find("Gravity"));
+				Assert::IsTrue(owner == &root);
+				const Symbol friction("Friction");
+				Assert::IsNull(weapon.Search(friction));
+				Assert::IsNull(weapon.Search(friction));
+				Assert::AreEqual(Scope::GetSearchStats().Hits, (size_t)2);
+				Assert::AreEqual(Scope::GetSearchStats().Misses, (size_t)2);
+
+				// A key appended on the way up hides the ancestor's, also for cached misses
+				level.Append("Gravity") = 1.6f;
+				enemy.Append("Friction") = 0.5f;
+				Assert::AreEqual(weapon.Search("Gravity")->GetFloat(), 1.6f);
+				Assert::AreEqual(weapon.Search("Friction")->GetFloat(), 0.5f);
+				Assert::AreEqual(Scope::GetSearchStats().Misses, (size_t)4);
+
+				// Appending to an existing key keeps the results
+				level.Append("Gravity") = 1.0f;
+				Assert::AreEqual(weapon.Search("Gravity")->GetFloat(), 1.0f);
+				Assert::AreEqual(Scope::GetSearchStats().Hits, (size_t)3);
+
+				// Moving a Scope in the hierarchy drops its results and its descendants'
+				Scope& ship = root.AppendScope("Ship");
+				ship.Append("Gravity") = 0.0f;
+				ship.Adopt(enemy, "Crew");
+				Assert::AreEqual(weapon.Search("Gravity")->GetFloat(), 0.0f);
+				Assert::IsTrue(enemy.Orphan() == &enemy);
+				Assert::IsNull(weapon.Search("Gravity"));
+				delete &enemy;
+			}
+			Scope::ResetSearchStats();
+			Assert::AreEqual(Scope::GetSearchStats().Hits, (size_t)0);
+		}
+
+		BENCHMARK_METHOD(SearchBenchmark) {
+			// Inherited attributes eight levels up, looked up the way Actions do every frame
+			Scope root;
+			root.Append("Gravity") = 9.8f;
+			Scope* leaf = &root;
+			for (int i = 0; i < 8; ++i) {
+				leaf->Append("Depth") = i;
+				leaf = &leaf->AppendScope("Child");
+			}
+			const Symbol key("Gravity");
+			const size_t repeats = 1000000;
+
+			auto start = std::chrono::steady_clock::now();
+			size_t found = 0;
+			for (size_t r = 0; r < repeats; ++r) {
+				// The uncached walk Search used to do
+				for (const Scope* current = leaf; current != nullptr; current = current->GetParent()) {
+					if (current->Find(key) != nullptr) {
+						++found;
+						break;
+					}
+				}
+			}
+			auto walked = std::chrono::steady_clock::now();
+			Scope::ResetSearchStats();
+			for (size_t r = 0; r < repeats; ++r) {
+				if (leaf->Search(key) != nullptr) {
+					++found;
+				}
+			}
+			auto searched = std::chrono::steady_clock::now();
+
+			Assert::AreEqual(found, repeats * 2);
+			Assert::AreEqual(Scope::GetSearchStats().Misses, (size_t)1);
+			Assert::AreEqual(Scope::GetSearchStats().Hits, repeats - 1);
+			Scope::ResetSearchStats();
+			auto ms = [](auto from, auto to) { return std::to_string(std::chrono::duration<double, std::milli>(to - from).count()); };
+			std::string message = "1M Searches 8 levels up: walking " + ms(start, walked) + " ms, cached " + ms(walked, searched) + " ms";
+			Logger::WriteMessage(message.c_str());
+		}
+
 		TEST_METHOD(Orphan) {
 			Scope s1;
 
@@ -155,6 +246,30 @@ namespace ScopeTest
 			Assert::IsTrue(s2.GetParent() == nullptr);
 			// Since s2 is orphaned it does not destruct itself
 			delete ss;
+
+			// The last sibling takes the orphan's slot and still knows where it is
+			Scope& s4 = s1.AppendScope("C");
+			Scope& s5 = s1.AppendScope("C");
+			Assert::IsTrue(s3.Orphan() == &s3);
+			delete &s3;
+			Datum* d = s1.Find("C");
+			Assert::AreEqual(d->Size(), (size_t)2);
+			Assert::IsTrue(d->GetScope(0) == &s5);
+			uint32_t idx = 7;
+			Assert::IsTrue(s5.FindContainingDatum(idx) == d);
+			Assert::AreEqual((size_t)idx, (size_t)0);
+			Assert::AreEqual(&s5, s5.Orphan());
+			delete &s5;
+			Assert::IsTrue(d->GetScope(0) == &s4);
+
+			// Pointers pushed straight into a Table are still found
+			Scope* pushed = new Scope;
+			d->Push(pushed);
+			pushed->SetParent(&s1);
+			Assert::IsTrue(pushed->FindContainingDatum(idx) == d);
+			Assert::AreEqual((size_t)idx, (size_t)1);
+			delete pushed;
+			Assert::AreEqual(d->Size(), (size_t)1);
 		}
 
 		TEST_METHOD(Adopt) {
@@ -192,6 +307,361 @@ namespace ScopeTest
 			Assert::AreEqual(ds2->GetScope(t), &s2);
 		}
 
+		TEST_METHOD(FindStringView) {
+			Scope s;
+			s.Append("Health") = 10;
+
+			std::string_view key = "Health";
+			Datum* d = s.Find(key);
+			Assert::IsFalse(d == nullptr);
+			Assert::AreEqual(d->Get<int>(), 10);
+
+			// Views into a larger buffer only match on the viewed characters
+			const char buffer[] = "HealthBar";
+			Assert::IsTrue(s.Find(std::string_view(buffer, 6)) == d);
+			Assert::IsTrue(s.Find(std::string_view(buffer)) == nullptr);
+
+			const Scope& cs = s;
+			Assert::IsTrue(cs.Find(key) == d);
+		}
+
+		BENCHMARK_METHOD(FindBenchmark) {
+			// Lookup cost should stay flat as the number of attributes grows
+			const size_t lookups = 200000;
+			for (size_t count : { 4, 16, 64, 256 }) {
+				Scope s;
+				std::vector<std::string> keys;
+				for (size_t i = 0; i < count; ++i) {
+					keys.push_back("Attribute" + std::to_string(i));
+					s.Append(keys.back()) = (int)i;
+				}
+
+				size_t found = 0;
+				auto start = std::chrono::steady_clock::now();
+				for (size_t i = 0; i < lookups; ++i) {
+					std::string_view key = keys[i % count];
+					if (s.Find(key) != nullptr) ++found;
+				}
+				auto end = std::chrono::steady_clock::now();
+
+				Assert::AreEqual(found, lookups);
+				double ns = std::chrono::duration<double, std::nano>(end - start).count() / lookups;
+				std::string message = "Scope::Find with " + std::to_string(count) + " attributes: " + std::to_string(ns) + " ns/lookup";
+				Logger::WriteMessage(message.c_str());
+			}
+		}
+
+		TEST_METHOD(FlatStorage) {
+			Scope s(2, Scope::Storage::Flat);
+			Assert::IsTrue(s.GetStorage() == Scope::Storage::Flat);
+			// Grow well past the initial capacity so several segments and rehashes happen
+			Datum& first = s.Append("Attribute0");
+			first = 0;
+			for (int i = 1; i < 100; ++i) {
+				s.Append("Attribute" + std::to_string(i)) = i;
+			}
+			Assert::AreEqual((size_t)100, s.GetSize());
+			Assert::IsTrue(&first == s.Find("Attribute0"));
+			Assert::AreEqual(&s.Append("Attribute50"), s.Find("Attribute50"));
+			Assert::AreEqual((size_t)100, s.GetSize());
+			for (std::uint32_t i = 0; i < 100; ++i) {
+				Assert::AreEqual((int)i, s[i].GetInt());
+			}
+			Assert::IsNull(s.Find("NotAnAttribute"));
+
+			// An invalid key is in no Scope, whatever the storage and even when it is empty
+			for (Scope::Storage storage : { Scope::Storage::Hashed, Scope::Storage::Flat }) {
+				Scope other(0, storage);
+				Assert::IsNull(other.Find(Symbol()));
+				other.Append("Attribute0") = 0;
+				Assert::IsNull(other.Find(Symbol()));
+				Assert::IsNull(std::as_const(other).Find(Symbol()));
+				other.Clear();
+				Assert::IsNull(other.Find(Symbol()));
+			}
+			Assert::IsNull(s.Find(Symbol()));
+
+			Scope& child = s.AppendScope("Child");
+			child.Append("Health") = 10;
+			Assert::IsNotNull(child.Search("Attribute99"));
+
+			Scope copy(s);
+			Assert::IsTrue(copy.GetStorage() == Scope::Storage::Flat);
+			Assert::IsTrue(copy == s);
+			Assert::IsTrue(copy.Find("Child")->GetScope() != &child);
+			Assert::IsTrue(copy.Find("Child")->GetScope()->GetParent() == &copy);
+
+			Scope* clone = s.Clone();
+			Assert::IsTrue(*clone == s);
+			delete clone;
+
+			Scope moved(std::move(copy));
+			Assert::IsTrue(moved == s);
+			Assert::IsTrue(moved.Find("Child")->GetScope()->GetParent() == &moved);
+
+			Assert::IsTrue(child.Orphan() == &child);
+			Assert::AreEqual((size_t)0, s.Find("Child")->Size());
+			delete &child;
+		}
+
+		TEST_METHOD(MemoryResources) {
+			CountingResource resource;
+			CountingResource otherResource;
+			for (Scope::Storage storage : { Scope::Storage::Hashed, Scope::Storage::Flat }) {
+				{
+					Scope root(0, storage, &resource);
+					Assert::IsTrue(root.GetResource() == &resource);
+					for (int i = 0; i < 20; ++i) {
+						root.Append("Attribute" + std::to_string(i)) = i;
+					}
+					Datum& numbers = root.Append("Numbers");
+					for (int i = 0; i < 100; ++i) {
+						numbers.Push(i);
+					}
+					Assert::IsTrue(numbers.GetResource() == &resource);
+
+					// Children made by AppendScope share the resource, grandchildren too
+					Scope& child = root.AppendScope("Child");
+					Assert::IsTrue(child.GetResource() == &resource);
+					Scope& grandChild = child.AppendScope("GrandChild");
+					grandChild.Append("Health") = 10;
+					Assert::IsTrue(grandChild.GetResource() == &resource);
+					Assert::IsTrue(resource.BytesInUse() > 0);
+
+					// Clones are ordinary heap Scopes
+					Scope* clone = root.Clone();
+					Assert::IsTrue(*clone == root);
+					Assert::IsNull(clone->GetResource());
+					Assert::IsNull(clone->Find("Child")->GetScope()->GetResource());
+					delete clone;
+
+					// Moving into a Scope on another resource keeps order, contents and parents
+					Scope copy(root);
+					Scope other(0, storage, &otherResource);
+					other = std::move(copy);
+					Assert::IsTrue(other == root);
+					Assert::IsTrue(other.Find("Child")->GetScope()->GetParent() == &other);
+					Assert::AreEqual(other[0].GetInt(), 0);
+					Assert::AreEqual(other[19].GetInt(), 19);
+					Assert::IsTrue(other.Find("Numbers")->GetResource() == &otherResource);
+					Assert::IsTrue(otherResource.BytesInUse() > 0);
+					other.Clear();
+
+					// Scopes placed in a resource are released with Destroy
+					Assert::IsTrue(grandChild.Orphan() == &grandChild);
+					Scope::Destroy(&grandChild);
+				}
+				Assert::AreEqual(resource.BytesInUse(), (size_t)0);
+				Assert::AreEqual(otherResource.BytesInUse(), (size_t)0);
+			}
+		}
+
+		TEST_METHOD(CloneShared) {
+			for (Scope::Storage storage : { Scope::Storage::Hashed, Scope::Storage::Flat }) {
+				Scope* prototype = new Scope(0, storage);
+				prototype->Append("Health") = 100;
+				Datum& path = prototype->Append("Path");
+				for (int i = 0; i < 50; ++i) {
+					path.Push(glm::vec4((float)i));
+				}
+				Scope& weapon = prototype->AppendScope("Weapon");
+				weapon.Append("Damage") = 25;
+				weapon.AppendScope("Enchantment").Append("Element") = std::string("Fire");
+
+				// Spans and references into the prototype stay valid, cloning never moves its elements
+				std::span<glm::vec4> pathSpan = path.AsSpan<glm::vec4>();
+				int& health = prototype->Find("Health")->Get<int>();
+
+				Scope* clone = prototype->CloneShared();
+				Scope* other = prototype->CloneShared();
+				Assert::IsTrue(pathSpan.data() == std::as_const(path).AsConstSpan<glm::vec4>().data());
+				Assert::IsTrue(&health == &std::as_const(*prototype).Find("Health")->GetInt());
+				Assert::AreEqual(pathSpan[49], glm::vec4(49.0f));
+				Assert::IsTrue(clone->GetStorage() == storage);
+				Assert::IsTrue(*clone == *prototype);
+				Assert::IsTrue(*other == *prototype);
+
+				// Clones share leaf Datums with each other, const reads don't copy them. Nested Scopes are cloned right
+				// away and parented to the clone
+				const Scope& constClone = *clone;
+				Assert::IsTrue(constClone.Find("Path")->AsConstSpan<glm::vec4>().data() == std::as_const(*other).Find("Path")->AsConstSpan<glm::vec4>().data());
+				Assert::IsTrue(constClone.Find("Path")->AsConstSpan<glm::vec4>().data() != pathSpan.data());
+				const Scope* clonedWeapon = constClone.Find("Weapon")->GetScope();
+				Assert::IsTrue(clonedWeapon != &weapon);
+				Assert::IsTrue(clonedWeapon->GetParent() == clone);
+				Assert::IsTrue(weapon.GetParent() == prototype);
+				Assert::IsTrue(clonedWeapon->Find("Enchantment")->GetScope()->GetParent() == clonedWeapon);
+
+				// Inherited attributes resolve against the clone
+				clone->Find("Health")->Get<int>() = 50;
+				Assert::AreEqual(clonedWeapon->Search("Health")->GetInt(), 50);
+				Assert::AreEqual(weapon.Search("Health")->GetInt(), 100);
+
+				// Mutable access copies just that Datum
+				int damage = 40;
+				clone->Find("Weapon")->GetScope()->Find("Damage")->Set(0, damage);
+				Assert::AreEqual(weapon.Find("Damage")->GetInt(), 25);
+				Assert::AreEqual(clonedWeapon->Find("Damage")->GetInt(), 40);
+
+				clone->Find("Path")->GetVector(3) = glm::vec4(-1.0f);
+				Assert::AreEqual(path.GetVector(3), glm::vec4(3.0f));
+				Assert::AreEqual(other->Find("Path")->GetVector(3), glm::vec4(3.0f));
+				Assert::AreEqual(clone->Find("Path")->GetVector(3), glm::vec4(-1.0f));
+				Assert::IsTrue(*clone != *prototype);
+
+				// Writes through the old span stay in the prototype
+				pathSpan[0] = glm::vec4(7.0f);
+				Assert::AreEqual(path.GetVector(0), glm::vec4(7.0f));
+				Assert::AreEqual(std::as_const(*other).Find("Path")->GetVector(0), glm::vec4(0.0f));
+
+				// A Table Datum held from before the clone only changes the prototype
+				Datum* weapons = prototype->Find("Weapon");
+				Scope* extra = new Scope;
+				weapons->Push(extra);
+				Assert::AreEqual(weapons->Size(), (size_t)2);
+				Assert::AreEqual(std::as_const(*other).Find("Weapon")->Size(), (size_t)1);
+				Assert::IsTrue(std::as_const(*other).Find("Weapon")->GetScope() != &weapon);
+				weapons->Pop();
+				delete extra;
+
+				// Orphaning from the prototype leaves the clones their own Scope, the orphan can be adopted elsewhere
+				const Scope* otherWeapon = std::as_const(*other).Find("Weapon")->GetScope();
+				Scope* orphan = weapon.Orphan();
+				Assert::IsTrue(orphan == &weapon);
+				Assert::AreEqual(prototype->Find("Weapon")->Size(), (size_t)0);
+				Assert::IsTrue(std::as_const(*other).Find("Weapon")->GetScope() == otherWeapon);
+				Scope adopter;
+				adopter.Adopt(*orphan, "Weapon");
+				Assert::IsTrue(orphan->GetParent() == &adopter);
+
+				// The prototype can go first
+				delete prototype;
+				Assert::AreEqual(other->Find("Path")->GetVector(49), glm::vec4(49.0f));
+				Assert::AreEqual(other->Find("Weapon")->GetScope()->Find("Damage")->GetInt(), 25);
+
+				// Clones of clones share leaf Datums too
+				Scope* grandClone = other->CloneShared();
+				Scope* secondGrandClone = other->CloneShared();
+				Assert::IsTrue(std::as_const(*grandClone).Find("Path")->AsConstSpan<glm::vec4>().data() == std::as_const(*secondGrandClone).Find("Path")->AsConstSpan<glm::vec4>().data());
+				delete other;
+				delete secondGrandClone;
+				Assert::AreEqual(std::as_const(*grandClone).Find("Path")->GetVector(49), glm::vec4(49.0f));
+				Scope* grandWeapon = grandClone->Find("Weapon")->GetScope();
+				Assert::IsTrue(grandWeapon->Orphan() == grandWeapon);
+				Assert::AreEqual(grandClone->Find("Weapon")->Size(), (size_t)0);
+				delete grandWeapon;
+
+				delete grandClone;
+				delete clone;
+			}
+		}
+
+		TEST_METHOD(CopyScaling) {
+			// Copies have to keep the attribute order, and cost the same per attribute however many there are
+			for (size_t count : { 10, 100, 1000 }) {
+				Scope prototype;
+				for (size_t i = 0; i < count; ++i) {
+					std::string key = "Attribute" + std::to_string(i);
+					if (i % 10 == 9) {
+						prototype.AppendScope(key).Append("Value") = (int)i;
+					}
+					else {
+						prototype.Append(key) = (int)i;
+					}
+				}
+				// Adopting into an existing Table lists it in the order again
+				prototype.Adopt(*new Scope, "Attribute9");
+
+				const size_t repeats = 20000 / count;
+				auto start = std::chrono::steady_clock::now();
+				for (size_t r = 0; r < repeats; ++r) {
+					Scope* clone = prototype.Clone();
+					delete clone;
+				}
+				auto cloned = std::chrono::steady_clock::now();
+				Scope assigned;
+				for (size_t r = 0; r < repeats; ++r) {
+					assigned = prototype;
+				}
+				auto copied = std::chrono::steady_clock::now();
+
+				Scope* clone = prototype.Clone();
+				Assert::AreEqual(clone->GetSize(), prototype.GetSize());
+				Assert::AreEqual(assigned.GetSize(), prototype.GetSize());
+				for (std::uint32_t i = 0; i < (std::uint32_t)count; ++i) {
+					Assert::AreEqual((*clone)[i].Size(), prototype[i].Size());
+					if (i % 10 != 9) {
+						Assert::IsTrue((*clone)[i] == prototype[i]);
+					}
+				}
+				Assert::AreEqual((*clone)[(std::uint32_t)count - 1].GetScope()->Find("Value")->GetInt(), (int)count - 1);
+				Assert::IsTrue((*clone)[9].GetScope(1)->GetParent() == clone);
+				Assert::IsTrue(&(*clone)[9] == &(*clone)[(std::uint32_t)count]);
+				Assert::IsTrue(assigned == prototype);
+				delete clone;
+
+				auto ns = [count, repeats](auto from, auto to) {
+					return std::to_string(std::chrono::duration<double, std::nano>(to - from).count() / (double)(count * repeats));
+				};
+				std::string message = std::to_string(count) + " attributes: clone " + ns(start, cloned) + " ns, copy assign "
+					+ ns(cloned, copied) + " ns per attribute";
+				Logger::WriteMessage(message.c_str());
+			}
+		}
+
+		BENCHMARK_METHOD(StorageBenchmark) {
+			// Compares the node based and flat layouts on the operations games do the most
+			const size_t count = 32;
+			const size_t repeats = 2000;
+			std::vector<Symbol> keys;
+			for (size_t i = 0; i < count; ++i) {
+				keys.emplace_back("Attribute" + std::to_string(i));
+			}
+
+			for (Scope::Storage storage : { Scope::Storage::Hashed, Scope::Storage::Flat }) {
+				const char* name = storage == Scope::Storage::Flat ? "Flat" : "Hashed";
+				auto start = std::chrono::steady_clock::now();
+				for (size_t r = 0; r < repeats; ++r) {
+					Scope s((std::uint32_t)count, storage);
+					for (size_t i = 0; i < count; ++i) {
+						s.Append(keys[i]) = (int)i;
+					}
+				}
+				auto constructed = std::chrono::steady_clock::now();
+
+				Scope prototype((std::uint32_t)count, storage);
+				for (size_t i = 0; i < count; ++i) {
+					prototype.Append(keys[i]) = (int)i;
+				}
+				for (size_t r = 0; r < repeats; ++r) {
+					Scope* clone = prototype.Clone();
+					delete clone;
+				}
+				auto cloned = std::chrono::steady_clock::now();
+
+				size_t found = 0;
+				for (size_t r = 0; r < repeats * 10; ++r) {
+					if (prototype.Find(keys[r % count]) != nullptr) ++found;
+				}
+				auto searched = std::chrono::steady_clock::now();
+
+				int sum = 0;
+				for (size_t r = 0; r < repeats; ++r) {
+					for (std::uint32_t i = 0; i < count; ++i) {
+						sum += prototype[i].GetInt();
+					}
+				}
+				auto iterated = std::chrono::steady_clock::now();
+
+				Assert::AreEqual(repeats * 10, found);
+				Assert::AreEqual((int)(repeats * (count * (count - 1) / 2)), sum);
+				auto us = [](auto from, auto to) { return std::to_string(std::chrono::duration<double, std::micro>(to - from).count()); };
+				std::string message = std::string(name) + " storage: construct " + us(start, constructed) + " us, clone " + us(constructed, cloned)
+					+ " us, find " + us(cloned, searched) + " us, iterate " + us(searched, iterated) + " us";
+				Logger::WriteMessage(message.c_str());
+			}
+		}
+
 	private:
 		inline static _CrtMemState _startMemState;
 	};
@@ -0,0 +1,87 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "Symbol.h"
+#include "Scope.h"
+#include "TestTypes.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Fiea::GameEngine;
+
+namespace SymbolTest
+{
+	TEST_CLASS(SymbolTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(Initialize)
+		{
+#if defined(DEBUG) || defined(_DEBUG)
+			_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF);
+			_CrtMemCheckpoint(&_startMemState);
+#endif
+		}
+
+		TEST_METHOD_CLEANUP(Cleanup)
+		{
+#if defined(DEBUG) || defined(_DEBUG)
+			_CrtMemState endMemState, diffMemState;
+			_CrtMemCheckpoint(&endMemState);
+			if (_CrtMemDifference(&diffMemState, &_startMemState, &endMemState))
+			{
+				_CrtDumpMemoryLeaks();
+				_CrtMemDumpStatistics(&diffMemState);
+				Assert::Fail(L"Memory Leaks!");
+			}
+#endif
+		}
+
+		TEST_METHOD(Interning) {
+			Symbol invalid;
+			Assert::IsFalse(invalid.IsValid());
+			Assert::AreEqual(invalid.Name(), std::string());
+
+			Symbol health("SymbolTestHealth");
+			Symbol again(std::string("SymbolTestHealth"));
+			Symbol mana("SymbolTestMana");
+
+			Assert::IsTrue(health.IsValid());
+			Assert::IsTrue(health == again);
+			Assert::IsTrue(health != mana);
+			Assert::AreEqual(health.Name(), std::string("SymbolTestHealth"));
+
+			// Interning the same name twice doesn't grow the table
+			size_t count = Symbol::Count();
+			Symbol third("SymbolTestHealth");
+			Assert::AreEqual(Symbol::Count(), count);
+			Assert::IsTrue(third == health);
+		}
+
+		TEST_METHOD(Find) {
+			Assert::IsFalse(Symbol::Find("SymbolTestNeverInterned").IsValid());
+
+			Symbol armor("SymbolTestArmor");
+			Assert::IsTrue(Symbol::Find("SymbolTestArmor") == armor);
+		}
+
+		TEST_METHOD(ScopeLookup) {
+			Scope s;
+			Symbol speed("SymbolTestSpeed");
+			s.Append(speed) = 12;
+
+			// Symbol and string lookups reach the same Datum
+			Assert::IsTrue(s.Find(speed) == s.Find("SymbolTestSpeed"));
+			Assert::AreEqual(s.Find(speed)->Get<int>(), 12);
+
+			// Unknown names are rejected without interning them
+			size_t count = Symbol::Count();
+			Assert::IsTrue(s.Find("SymbolTestUnknownKey") == nullptr);
+			Assert::AreEqual(Symbol::Count(), count);
+
+			Scope& child = s.AppendScope("SymbolTestChild");
+			Assert::IsTrue(child.Search(speed) == s.Find(speed));
+		}
+
+	private:
+		inline static _CrtMemState _startMemState;
+	};
+}
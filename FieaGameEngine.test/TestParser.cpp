@@ -1,12 +1,15 @@
 #include "pch.h"
 #include "CppUnitTest.h"
+#include "Benchmark.h"
 #include "TestParseHandler.h"
 #include "TestIntHandler.h"
 #include "TableHelper.h"
 #include "ParseCoordinator.h"
+#include "LevelArena.h"
 #include "TestTypes.h"
 #include <iostream>
 #include <string>
+#include <chrono>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace Fiea::GameEngine::test;
@@ -258,6 +261,109 @@ namespace Testparser
 		}
 
 
+		BENCHMARK_METHOD(LargeArrayBenchmark) {
+			// Loading a 100k int array through TableHelper, the Datum is filled by a single bulk Append
+			const int count = 100000;
+			std::string json = "{ \"Numbers\": [";
+			for (int i = 0; i < count; ++i) {
+				json += std::to_string(i);
+				json += (i + 1 < count) ? "," : "]}";
+			}
+
+			Scope root;
+			TableHelper::TableWrapper Twrapper(root);
+			ParseCoordinator parser(Twrapper);
+			TableHelper* tHandler = new(TableHelper);
+			parser.AddHandler(tHandler);
+
+			auto report = [](const char* name, auto from, auto to) {
+				double ms = std::chrono::duration<double, std::milli>(to - from).count();
+				std::string message = std::string("TableHelper 100k int array ") + name + ": " + std::to_string(ms) + " ms";
+				Logger::WriteMessage(message.c_str());
+			};
+
+			auto start = std::chrono::steady_clock::now();
+			Assert::IsTrue(parser.DeserializeObject(json));
+			report("(parse + load)", start, std::chrono::steady_clock::now());
+
+			Datum& numbers = root["Numbers"];
+			Assert::AreEqual(numbers.Size(), (size_t)count);
+			Assert::AreEqual(numbers.Capacity(), (size_t)count);
+			Assert::AreEqual(numbers.Get<int>(count - 1), count - 1);
+
+			// The handler alone, without the JsonCpp parsing
+			Json::Value array(Json::arrayValue);
+			for (int i = 0; i < count; ++i) {
+				array.append(i);
+			}
+			Scope other;
+			TableHelper::TableWrapper otherWrapper(other);
+			start = std::chrono::steady_clock::now();
+			Assert::IsTrue(tHandler->StartHandler(otherWrapper, "Numbers", array, true));
+			report("(load only)", start, std::chrono::steady_clock::now());
+			Assert::AreEqual(other["Numbers"].Size(), (size_t)count);
+
+			parser.RemoveHandler(tHandler);
+		}
+
+		BENCHMARK_METHOD(SceneArenaBenchmark) {
+			// Loading and tearing down a 10k object scene (100 rooms of 100 objects) on the heap and in a LevelArena
+			const int rooms = 100;
+			const int objectsPerRoom = 100;
+			std::string json = "{";
+			for (int r = 0; r < rooms; ++r) {
+				json += "\"Room" + std::to_string(r) + "\": {";
+				for (int o = 0; o < objectsPerRoom; ++o) {
+					json += "\"Object" + std::to_string(o) + "\": { \"Health\": " + std::to_string(o)
+						+ ", \"Speed\": 1.5, \"Name\": \"Goblin\", \"Path\": [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20] }";
+					json += (o + 1 < objectsPerRoom) ? "," : "}";
+				}
+				json += (r + 1 < rooms) ? "," : "}";
+			}
+
+			auto report = [](const char* name, auto from, auto to) {
+				double ms = std::chrono::duration<double, std::milli>(to - from).count();
+				std::string message = std::string("10k object scene ") + name + ": " + std::to_string(ms) + " ms";
+				Logger::WriteMessage(message.c_str());
+			};
+			auto load = [&json](Scope& root) {
+				TableHelper::TableWrapper wrapper(root);
+				ParseCoordinator parser(wrapper);
+				TableHelper* handler = new TableHelper();
+				parser.AddHandler(handler);
+				Assert::IsTrue(parser.DeserializeObject(json));
+				parser.RemoveHandler(handler);
+			};
+			auto verify = [rooms, objectsPerRoom](Scope& root) {
+				Scope* room = root["Room" + std::to_string(rooms - 1)].GetScope();
+				Scope* object = (*room)["Object" + std::to_string(objectsPerRoom - 1)].GetScope();
+				Assert::AreEqual((*object)["Health"].GetInt(), objectsPerRoom - 1);
+				Assert::AreEqual((*object)["Path"].Size(), (size_t)20);
+			};
+
+			{
+				Scope* root = new Scope();
+				auto start = std::chrono::steady_clock::now();
+				load(*root);
+				report("load (heap)", start, std::chrono::steady_clock::now());
+				verify(*root);
+				start = std::chrono::steady_clock::now();
+				delete root;
+				report("destroy (heap)", start, std::chrono::steady_clock::now());
+			}
+			{
+				LevelArena level;
+				auto start = std::chrono::steady_clock::now();
+				load(level.Root());
+				report("load (arena)", start, std::chrono::steady_clock::now());
+				verify(level.Root());
+				start = std::chrono::steady_clock::now();
+				level.Reset();
+				report("destroy (arena)", start, std::chrono::steady_clock::now());
+				Assert::IsTrue(level.Root().isEmpty());
+			}
+		}
+
 	private:
 		inline static _CrtMemState _startMemState;
 	};
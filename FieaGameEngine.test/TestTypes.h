@@ -2,6 +2,7 @@
 
 #include "Datum.h"
 #include "Scope.h"
+#include <memory_resource>
 
 using namespace Fiea::GameEngine;
 
@@ -100,3 +101,54 @@ namespace Microsoft::VisualStudio::CppUnitTestFramework
 	}
 
 }
+
+/** CountingResource
+ * @brief memory_resource forwarding to new/delete that keeps track of what is handed out, so tests can check
+ * allocations go to the resource they were given and come back with the sizes they were made with
+*/
+class CountingResource final : public std::pmr::memory_resource {
+public:
+	size_t Allocations() const { return _allocations; }
+	size_t BytesInUse() const { return _bytesInUse; }
+
+private:
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		++_allocations;
+		_bytesInUse += bytes;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+	void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+		_bytesInUse -= bytes;
+		std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+	}
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+	size_t _allocations = 0;
+	size_t _bytesInUse = 0;
+};
+
+#if defined(DEBUG) || defined(_DEBUG)
+/** AllocationCounter
+ * @brief Counts the CRT heap allocations made while it is alive by installing a debug allocation hook
+*/
+class AllocationCounter final {
+public:
+	AllocationCounter() { _count = 0; _previous = _CrtSetAllocHook(Hook); }
+	~AllocationCounter() { _CrtSetAllocHook(_previous); }
+	AllocationCounter(const AllocationCounter&) = delete;
+	AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+	size_t Count() const { return _count; }
+
+private:
+	static int Hook(int allocType, void*, size_t, int, long, const unsigned char*, int) {
+		if (allocType == _HOOK_ALLOC || allocType == _HOOK_REALLOC) {
+			++_count;
+		}
+		return 1;
+	}
+
+	inline static size_t _count = 0;
+	_CRT_ALLOC_HOOK _previous;
+};
+#endif
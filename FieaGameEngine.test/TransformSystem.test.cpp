@@ -0,0 +1,286 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "Benchmark.h"
+#include "TransformSystem.h"
+#include "GameObject.h"
+#include "Hero.h"
+#include "Action.h"
+#include "ActionList.h"
+#include "ActionIncrement.h"
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Fiea::GameEngine;
+
+namespace TransformSystemTest
+{
+	// T * Rz * Ry * Rx * S built one matrix at a time
+	glm::mat4 Expected(const glm::vec4& position, const glm::vec4& rotation, const glm::vec4& scale) {
+		const float cx = std::cos(rotation.x), sx = std::sin(rotation.x);
+		const float cy = std::cos(rotation.y), sy = std::sin(rotation.y);
+		const float cz = std::cos(rotation.z), sz = std::sin(rotation.z);
+		const glm::mat4 translate(glm::vec4(1, 0, 0, 0), glm::vec4(0, 1, 0, 0), glm::vec4(0, 0, 1, 0), glm::vec4(position.x, position.y, position.z, 1.0f));
+		const glm::mat4 rotateX(glm::vec4(1, 0, 0, 0), glm::vec4(0, cx, sx, 0), glm::vec4(0, -sx, cx, 0), glm::vec4(0, 0, 0, 1));
+		const glm::mat4 rotateY(glm::vec4(cy, 0, -sy, 0), glm::vec4(0, 1, 0, 0), glm::vec4(sy, 0, cy, 0), glm::vec4(0, 0, 0, 1));
+		const glm::mat4 rotateZ(glm::vec4(cz, sz, 0, 0), glm::vec4(-sz, cz, 0, 0), glm::vec4(0, 0, 1, 0), glm::vec4(0, 0, 0, 1));
+		const glm::mat4 scaling(glm::vec4(scale.x, 0, 0, 0), glm::vec4(0, scale.y, 0, 0), glm::vec4(0, 0, scale.z, 0), glm::vec4(0, 0, 0, 1));
+		return translate * rotateZ * rotateY * rotateX * scaling;
+	}
+
+	bool Near(const glm::mat4& lhs, const glm::mat4& rhs) {
+		for (int column = 0; column < 4; ++column) {
+			for (int row = 0; row < 4; ++row) {
+				if (std::fabs(lhs[column][row] - rhs[column][row]) > 1e-4f) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	TEST_CLASS(TransformSystemTest)
+	{
+	public:
+
+		TEST_METHOD_INITIALIZE(Initialize)
+		{
+			TypeManager::add<GameObject>();
+			TypeManager::add<Hero>();
+			TypeManager::add<Action>();
+			TypeManager::add<ActionList>();
+			TypeManager::add<ActionIncrement>();
+#if defined(DEBUG) || defined(_DEBUG)
+			_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF);
+			_CrtMemCheckpoint(&_startMemState);
+#endif
+		}
+
+		TEST_METHOD_CLEANUP(Cleanup)
+		{
+#if defined(DEBUG) || defined(_DEBUG)
+			_CrtMemState endMemState, diffMemState;
+			_CrtMemCheckpoint(&endMemState);
+			if (_CrtMemDifference(&diffMemState, &_startMemState, &endMemState))
+			{
+				_CrtDumpMemoryLeaks();
+				_CrtMemDumpStatistics(&diffMemState);
+				Assert::Fail(L"Memory Leaks!");
+			}
+#endif
+			TypeManager::Clear();
+		}
+
+		TEST_METHOD(WorldMatrices) {
+			GameObject* root = new GameObject();
+			Hero* child = new Hero();
+			GameObject* grandchild = new GameObject();
+			root->ObjTransform = { glm::vec4(1, 2, 3, 0), glm::vec4(0, 0, 1.5707964f, 0), glm::vec4(1, 1, 1, 0) };
+			child->ObjTransform = { glm::vec4(1, 0, 0, 0), glm::vec4(0.3f, -0.2f, 0.1f, 0), glm::vec4(2, 2, 2, 0) };
+			grandchild->ObjTransform = { glm::vec4(0, 0, 4, 0), glm::vec4(0, 0.7f, 0, 0), glm::vec4(1, 3, 1, 0) };
+			child->Name = "Child";
+			grandchild->Name = "Grandchild";
+			child->AddChild(grandchild);
+			root->AddChild(child);
+
+			// Added children first, Update still finds parents before their children
+			TransformSystem system;
+			system.Add(*grandchild);
+			system.Add(*root);
+			Assert::AreEqual(system.Size(), (size_t)3);
+			Assert::IsTrue(system.Contains(*child));
+			Assert::IsTrue(child->GetTransformSystem() == &system);
+			system.Update();
+
+			const glm::mat4 rootWorld = Expected(root->ObjTransform.Position, root->ObjTransform.Rotation, root->ObjTransform.Scale);
+			const glm::mat4 childWorld = rootWorld * Expected(child->ObjTransform.Position, child->ObjTransform.Rotation, child->ObjTransform.Scale);
+			const glm::mat4 grandchildWorld = childWorld * Expected(grandchild->ObjTransform.Position, grandchild->ObjTransform.Rotation, grandchild->ObjTransform.Scale);
+			Assert::IsTrue(Near(system.World(*root), rootWorld));
+			Assert::IsTrue(Near(system.World(*child), childWorld));
+			Assert::IsTrue(Near(system.World(*grandchild), grandchildWorld));
+
+			// A quarter turn about z takes the child's offset from x to y
+			const glm::vec4 origin = system.World(*child) * glm::vec4(0, 0, 0, 1);
+			Assert::IsTrue(std::fabs(origin.x - 1.0f) < 1e-4f && std::fabs(origin.y - 3.0f) < 1e-4f && std::fabs(origin.z - 3.0f) < 1e-4f);
+
+			GameObject stranger;
+			Assert::ExpectException<std::invalid_argument>([&system, &stranger]() { system.World(stranger); });
+			TransformSystem other;
+			Assert::ExpectException<std::runtime_error>([&other, root]() { other.Add(*root); });
+			delete root;
+			Assert::AreEqual(system.Size(), (size_t)0);
+		}
+
+		TEST_METHOD(AttributesViewSystem) {
+			GameObject object;
+			object.ObjTransform.Position = glm::vec4(1, 2, 3, 0);
+			TransformSystem system;
+			system.Add(object);
+
+			// Writes through the attribute land in the system, as an Action's would
+			object.Find(GameObject::PositionKey)->Get<glm::vec4>() = glm::vec4(5, 6, 7, 0);
+			Assert::IsTrue(object.GetTransform().Position == glm::vec4(5, 6, 7, 0));
+			system.Update();
+			Assert::IsTrue(system.World(object)[3] == glm::vec4(5, 6, 7, 1));
+
+			Transform transform = object.GetTransform();
+			transform.Scale = glm::vec4(2, 2, 2, 0);
+			object.SetTransform(transform);
+			Assert::IsTrue(object.Find("Scale")->Get<glm::vec4>() == glm::vec4(2, 2, 2, 0));
+			Assert::IsTrue(system.Local(object).Scale == glm::vec4(2, 2, 2, 0));
+
+			// Adding more objects moves the buffers, the attributes follow
+			std::vector<GameObject> others(100);
+			for (GameObject& other : others) {
+				system.Add(other);
+			}
+			Assert::IsTrue(object.Find(GameObject::PositionKey)->Get<glm::vec4>() == glm::vec4(5, 6, 7, 0));
+
+			// Removing hands the transform back to ObjTransform
+			system.Remove(object);
+			Assert::IsFalse(system.Contains(object));
+			Assert::IsTrue(object.ObjTransform.Position == glm::vec4(5, 6, 7, 0));
+			object.Find(GameObject::PositionKey)->Get<glm::vec4>() = glm::vec4(8, 8, 8, 0);
+			Assert::IsTrue(object.ObjTransform.Position == glm::vec4(8, 8, 8, 0));
+			Assert::ExpectException<std::invalid_argument>([&system, &object]() { system.Remove(object); });
+
+			// The object that took the removed slot still views its own transform
+			others.back().Find(GameObject::PositionKey)->Get<glm::vec4>() = glm::vec4(9, 9, 9, 0);
+			Assert::IsTrue(system.Local(others.back()).Position == glm::vec4(9, 9, 9, 0));
+
+			system.Clear();
+			Assert::IsTrue(others.back().ObjTransform.Position == glm::vec4(9, 9, 9, 0));
+			Assert::IsNull(others.front().GetTransformSystem());
+		}
+
+		TEST_METHOD(Reparenting) {
+			GameObject* first = new GameObject();
+			GameObject* second = new GameObject();
+			GameObject* child = new GameObject();
+			// Transforms start with a zero Scale
+			first->ObjTransform = { glm::vec4(10, 0, 0, 0), glm::vec4(0.0f), glm::vec4(1.0f) };
+			second->ObjTransform = { glm::vec4(0, 20, 0, 0), glm::vec4(0.0f), glm::vec4(1.0f) };
+			child->ObjTransform = { glm::vec4(1, 1, 1, 0), glm::vec4(0.0f), glm::vec4(1.0f) };
+			child->Name = "Child";
+			first->AddChild(child);
+
+			TransformSystem system;
+			system.Add(*child);
+			system.Add(*first);
+			system.Add(*second);
+			system.Update();
+			Assert::IsTrue(system.World(*child)[3] == glm::vec4(11, 1, 1, 1));
+
+			// AddChild and RemoveChild reorder the system before its next Update
+			Assert::IsTrue(first->RemoveChild(child));
+			system.Update();
+			Assert::IsTrue(system.World(*child)[3] == glm::vec4(1, 1, 1, 1));
+			Assert::IsTrue(second->AddChild(child));
+			system.Update();
+			Assert::IsTrue(system.World(*child)[3] == glm::vec4(1, 21, 1, 1));
+
+			// Removing a parent leaves its child as a root
+			system.Remove(*second);
+			system.Update();
+			Assert::IsTrue(system.World(*child)[3] == glm::vec4(1, 1, 1, 1));
+
+			delete second;
+			delete first;
+			Assert::AreEqual(system.Size(), (size_t)0);
+		}
+
+		TEST_METHOD(Copies) {
+			GameObject object;
+			object.ObjTransform.Position = glm::vec4(1, 2, 3, 0);
+			TransformSystem system;
+			system.Add(object);
+			object.Find(GameObject::PositionKey)->Get<glm::vec4>() = glm::vec4(4, 5, 6, 0);
+
+			// Copies take the current transform but stay out of the system
+			GameObject copy(object);
+			Assert::IsNull(copy.GetTransformSystem());
+			Assert::IsTrue(copy.ObjTransform.Position == glm::vec4(4, 5, 6, 0));
+			copy.Find(GameObject::PositionKey)->Get<glm::vec4>() = glm::vec4(7, 7, 7, 0);
+			Assert::IsTrue(copy.ObjTransform.Position == glm::vec4(7, 7, 7, 0));
+			Assert::IsTrue(object.GetTransform().Position == glm::vec4(4, 5, 6, 0));
+
+			// Assigning a managed object keeps it in the system with rhs' transform
+			object = copy;
+			Assert::IsTrue(system.Contains(object));
+			Assert::IsTrue(system.Local(object).Position == glm::vec4(7, 7, 7, 0));
+			object.Find(GameObject::PositionKey)->Get<glm::vec4>() = glm::vec4(1, 1, 1, 0);
+			Assert::IsTrue(system.Local(object).Position == glm::vec4(1, 1, 1, 0));
+			Assert::IsTrue(copy.ObjTransform.Position == glm::vec4(7, 7, 7, 0));
+
+			GameObject* clone = object.Clone();
+			Assert::IsNull(clone->GetTransformSystem());
+			Assert::IsTrue(clone->ObjTransform.Position == glm::vec4(1, 1, 1, 0));
+			delete clone;
+		}
+
+		BENCHMARK_METHOD(UpdateBenchmark) {
+			// 20k objects, 100 under the root each with 199 children, world matrices by walking the Scopes vs one batched pass
+			const size_t branches = 100;
+			const size_t leaves = 199;
+			GameObject* root = new GameObject();
+			for (size_t branch = 0; branch < branches; ++branch) {
+				GameObject* middle = new GameObject();
+				middle->Name = "Branch" + std::to_string(branch);
+				middle->ObjTransform = { glm::vec4(float(branch), 1, 0, 0), glm::vec4(0, 0.01f * branch, 0, 0), glm::vec4(1, 1, 1, 0) };
+				for (size_t leaf = 0; leaf < leaves; ++leaf) {
+					GameObject* object = new GameObject();
+					object->Name = "Leaf" + std::to_string(leaf);
+					object->ObjTransform = { glm::vec4(0, float(leaf), 2, 0), glm::vec4(0.02f * leaf, 0, 0.5f, 0), glm::vec4(1, 2, 1, 0) };
+					middle->AddChild(object);
+				}
+				root->AddChild(middle);
+			}
+
+			// Per object: attributes found by name, children reached through their wrapper Scopes
+			std::vector<glm::mat4> naive;
+			naive.reserve(branches * (leaves + 1) + 1);
+			std::function<void(GameObject&, const glm::mat4&)> walk = [&naive, &walk](GameObject& object, const glm::mat4& parent) {
+				const glm::mat4 world = parent * Expected(object.Find("Position")->Get<glm::vec4>(), object.Find("Rotation")->Get<glm::vec4>(), object.Find("Scale")->Get<glm::vec4>());
+				naive.push_back(world);
+				Datum* children = object.Find(GameObject::ChildrenKey);
+				for (size_t idx = 0; idx < children->Size(); ++idx) {
+					Scope* wrapper = children->GetScope(idx);
+					for (std::uint32_t named = 0; named < wrapper->GetSize(); ++named) {
+						walk(*(*wrapper)[named].GetScope()->As<GameObject>(), world);
+					}
+				}
+			};
+			const int runs = 10;
+			auto start = std::chrono::steady_clock::now();
+			for (int run = 0; run < runs; ++run) {
+				naive.clear();
+				walk(*root, glm::mat4(1.0f));
+			}
+			double naiveMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / runs;
+
+			TransformSystem system;
+			system.Reserve(naive.size());
+			start = std::chrono::steady_clock::now();
+			system.Add(*root);
+			system.Update();
+			double addMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			start = std::chrono::steady_clock::now();
+			for (int run = 0; run < runs; ++run) {
+				system.Update();
+			}
+			double batchMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / runs;
+			Assert::AreEqual(system.Size(), naive.size());
+			Assert::IsTrue(Near(system.World(*root), naive.front()));
+			Assert::IsTrue(Near(system.World(*(*root->Find(GameObject::ChildrenKey)->GetScope(branches - 1))[0].GetScope()->As<GameObject>()), naive[naive.size() - leaves - 1]));
+
+			std::string message = "World matrices of 20k GameObjects: Scope walk " + std::to_string(naiveMs) + " ms, TransformSystem::Update "
+				+ std::to_string(batchMs) + " ms (first Add and Update " + std::to_string(addMs) + " ms)";
+			Logger::WriteMessage(message.c_str());
+			delete root;
+		}
+
+	private:
+		inline static _CrtMemState _startMemState;
+	};
+}
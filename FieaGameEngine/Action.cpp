@@ -6,6 +6,15 @@ using namespace std::string_literals;
 namespace Fiea::GameEngine {
 	RTTI_DEFINITIONS(Action);
 
+	// Destructor, the GameObject holding this Action lists its Actions again before its next Update
+	Action::~Action()
+	{
+		GameObject* owner = SleepOwner();
+		if (owner != nullptr) {
+			owner->InvalidateUpdateList();
+		}
+	}
+
 	/** SetName
 	 * @brief Set action's Name
 	 * @param name : new Name
@@ -44,14 +53,60 @@ namespace Fiea::GameEngine {
 		GOparent = parent;
 	}
 
+	/** GetReach
+	 * @brief Declares what Update reads or writes outside the Action's own GameObject subtree. Actions running under
+	 * GameObject::Update(time, jobs) that return Ancestors are updated after the parallel pass, one at a time in
+	 * tree order. Override it in Actions that touch a parent's (or any other outside) attributes.
+	 * @return Subtree, the default
+	*/
+	Action::Reach Action::GetReach() const
+	{
+		return Reach::Subtree;
+	}
+
+	/** ReachOf
+	 * @brief Reach of an attribute path resolved against the parent GameObject
+	 * @param path : path last resolved from GOparent
+	 * @return Subtree if it resolved to an attribute of GOparent or one of its descendants, Ancestors otherwise
+	 * (including a path not resolved yet, or resolved before something changed)
+	*/
+	Action::Reach Action::ReachOf(const AttributePath& path) const
+	{
+		if (GOparent == nullptr) {
+			return Reach::Ancestors;
+		}
+		const Scope* owner = path.Owner(*GOparent);
+		for (const Scope* current = owner; current != nullptr; current = current->GetParent()) {
+			if (current == GOparent) {
+				return Reach::Subtree;
+			}
+		}
+		return Reach::Ancestors;
+	}
+
+	/** SleepOwner
+	 * @return the closest GameObject holding this Action, the one whose Update schedules it
+	*/
+	GameObject* Action::SleepOwner()
+	{
+		for (Scope* scope = GetParent(); scope != nullptr; scope = scope->GetParent()) {
+			GameObject* owner = scope->As<GameObject>();
+			if (owner != nullptr) {
+				return owner;
+			}
+		}
+		return nullptr;
+	}
+
 	/**
 	 * @brief Create signatures to be used by attributed and TypeManager
-	 * @return vector of signatures
+	 * @return compile time table of signatures
 	*/
-	std::vector<Signature> Action::Signatures()
+	std::span<const Signature> Action::Signatures()
 	{
-		return std::vector<Signature> {
-			{ "Name"s, Datum::DatumType::String, 1, offsetof(Action, Name) }
-		};
+		static constexpr auto signatures = MakeSignatures({
+			SIGNATURE(Action, Name, "Name")
+		});
+		return signatures;
 	}
 }
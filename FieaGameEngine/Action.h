@@ -2,18 +2,20 @@
 #include "Attributed.h"
 #include "GameClock.h"
 #include "GameObject.h"
+#include "AttributePath.h"
+#include "Sleeper.h"
 
 using string = std::string;
 
 // Abstract Class that extends Attributed
 namespace Fiea::GameEngine {
-	class Action : public Attributed {
+	class Action : public Attributed, public Sleeper {
 		RTTI_DECLARATIONS(Action, Attributed);
 	public:
 		Action() : Attributed(TypeIdClass(), nullptr) {};
-		Action(std::vector<RTTI::IdType>* childIds) : Attributed(TypeIdClass(), childIds) {};
+		Action(const TypeIdList* childIds) : Attributed(TypeIdClass(), childIds) {};
 
-		virtual ~Action() = default;
+		virtual ~Action();
 		Action(const Action& other) = default;
 		Action& operator=(const Action& rhs) = default;
 		Action(Action&& other) noexcept = default;
@@ -23,14 +25,23 @@ namespace Fiea::GameEngine {
 		virtual bool operator==(Action* other);
 
 		virtual void Update(GameTime time) = 0;
+
+		// What Update may touch besides the Action's GameObject and that object's descendants. The parallel
+		// GameObject::Update holds back Actions reaching Ancestors until every subtree is done, see GetReach
+		enum class Reach { Subtree, Ancestors };
+		virtual Reach GetReach() const;
+
 		void SetName(const string& name);
 		string& GetName();
 		void SetParent(GameObject* parent);
 
-		static std::vector<Signature> Signatures();
+		static std::span<const Signature> Signatures();
 
 	protected:
+		Reach ReachOf(const AttributePath& path) const;
+		GameObject* SleepOwner() override;
+
 		string Name;
-		GameObject* GOparent;
+		GameObject* GOparent = nullptr;
 	};
 }
\ No newline at end of file
@@ -6,15 +6,7 @@ using namespace std::string_literals;
 namespace Fiea::GameEngine {
 	RTTI_DEFINITIONS(ActionList);
 
-	// Destructor
-	ActionList::~ActionList()
-	{
-		if (ALid != nullptr) {
-			if (!ALid->empty()) {
-				delete ALid;
-			}
-		}
-	}
+	const Symbol ActionList::ActionsKey("Actions");
 
 	ActionList* ActionList::Clone() const{
 		return NEW ActionList(*this);
@@ -27,11 +19,11 @@ namespace Fiea::GameEngine {
 		// Check the names are the same
 		if (GetName() != other->GetName()) return false;
 		// Check they both have the same amount of actions
-		if (Find("Actions")->GetScope()->GetSize() != other->Find("Actions")->GetScope()->GetSize()) return false;
+		if (Find(ActionsKey)->GetScope()->GetSize() != other->Find(ActionsKey)->GetScope()->GetSize()) return false;
 		// Now check if each action is the same
-		for (int i = 0; i < (int)Find("Actions")->GetScope()->GetSize(); ++i) {
-			Action* Action1 = (*Find("Actions")->GetScope())[i].GetScope()->As<Action>();
-			Action* Action2 = (*other->Find("Actions")->GetScope())[i].GetScope()->As<Action>();
+		for (int i = 0; i < (int)Find(ActionsKey)->GetScope()->GetSize(); ++i) {
+			Action* Action1 = (*Find(ActionsKey)->GetScope())[i].GetScope()->As<Action>();
+			Action* Action2 = (*other->Find(ActionsKey)->GetScope())[i].GetScope()->As<Action>();
 			if (!(*Action1 == Action2) || Action1 == nullptr || Action2 == nullptr) {
 				return false;
 			}
@@ -45,7 +37,7 @@ namespace Fiea::GameEngine {
 	*/
 	void ActionList::Update(GameTime time)
 	{
-		Scope* ActionsListScope = Find("Actions")->GetScope();
+		Scope* ActionsListScope = Find(ActionsKey)->GetScope();
 		for (int idx = 0; idx < (int)ActionsListScope->GetSize(); ++idx) {
 			Action* a = (*ActionsListScope)[idx].GetScope()->As<Action>();
 			if (a != nullptr) {
@@ -64,27 +56,51 @@ namespace Fiea::GameEngine {
 	*/
 	void ActionList::AddAction(Action* action)
 	{
-		Datum* ActionsDatum = Find("Actions");
+		Datum* ActionsDatum = Find(ActionsKey);
 		if (ActionsDatum != nullptr) {
-			Find("Actions")->GetScope()->Adopt(*action, action->GetName());
+			Find(ActionsKey)->GetScope()->Adopt(*action, action->GetName());
 		}
 	}
 
-	std::vector<Signature> ActionList::Signatures() {
-		return std::vector<Signature> {
-			{ "Actions"s, Datum::DatumType::Table, 0, 0 }
-		};
+	/** GetReach
+	 * @brief The widest reach of the listed actions, as of the parent they were last handed
+	 * @return Ancestors if any action reaches them
+	*/
+	Action::Reach ActionList::GetReach() const
+	{
+		return ReachOfActions(Find(ActionsKey));
 	}
 
-
-	std::vector<RTTI::IdType>* ActionList::AppendId(std::vector<RTTI::IdType>* Ids)
+	/** ReachOfActions
+	 * @brief The widest reach of the Actions in a Table attribute, held directly or named in wrapper Scopes
+	 * @param table : Table Datum, may be nullptr
+	 * @return Ancestors if any action reaches them
+	*/
+	Action::Reach ActionList::ReachOfActions(const Datum* table)
 	{
-		if (Ids == nullptr) {
-			ALid = NEW std::vector<RTTI::IdType>;
-			ALid->push_back(TypeIdClass());
-			return ALid;
+		for (size_t idx = 0; table != nullptr && idx < table->Size(); ++idx) {
+			const Scope* scope = table->GetScope(idx);
+			const Action* action = scope->As<Action>();
+			if (action != nullptr) {
+				if (action->GetReach() == Reach::Ancestors) {
+					return Reach::Ancestors;
+				}
+				continue;
+			}
+			for (std::uint32_t named = 0; named < scope->GetSize(); ++named) {
+				const Datum& datum = (*scope)[named];
+				if (datum.CheckType(Datum::DatumType::Table) && ReachOfActions(&datum) == Reach::Ancestors) {
+					return Reach::Ancestors;
+				}
+			}
 		}
-		Ids->push_back(TypeIdClass());
-		return Ids;
+		return Reach::Subtree;
+	}
+
+	std::span<const Signature> ActionList::Signatures() {
+		static constexpr auto signatures = MakeSignatures({
+			{ "Actions", Datum::DatumType::Table, 0, 0 }
+		});
+		return signatures;
 	}
 }
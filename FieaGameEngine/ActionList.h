@@ -6,9 +6,9 @@ namespace Fiea::GameEngine {
 		RTTI_DECLARATIONS(ActionList, Action);
 
 	public:
-		ActionList(std::vector<RTTI::IdType>* Ids = nullptr) : Action(AppendId(Ids)) {};
+		ActionList(TypeIdList* Ids = nullptr) : Action(AppendTypeId(Ids, TypeIdClass())) {};
 
-		virtual ~ActionList();
+		virtual ~ActionList() = default;
 		ActionList(const ActionList& rhs) = default;
 		ActionList(ActionList&& WhileList) noexcept = default;
 		ActionList& operator=(const ActionList& rhs) = default;
@@ -19,11 +19,13 @@ namespace Fiea::GameEngine {
 
 		void Update(GameTime time);
 		void AddAction(Action* action);
+		Reach GetReach() const override;
 
-		static std::vector<Signature> Signatures();
-	private:
+		static std::span<const Signature> Signatures();
 
-		std::vector<RTTI::IdType>* AppendId(std::vector<RTTI::IdType>* Ids);
-		std::vector<RTTI::IdType>* ALid;
+		static const Symbol ActionsKey;
+
+	protected:
+		static Reach ReachOfActions(const Datum* table);
 	};
 }
\ No newline at end of file
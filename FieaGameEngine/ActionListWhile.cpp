@@ -7,17 +7,8 @@ using namespace std::string_literals;
 namespace Fiea::GameEngine {
 	RTTI_DEFINITIONS(ActionListWhile);
 
-	/** Destructor
-	 * @brief Destructor taking care of owned data
-	*/
-	ActionListWhile::~ActionListWhile()
-	{
-		if (ALWid != nullptr) {
-			if (!ALWid->empty()) {
-				delete ALWid;
-			}
-		}
-	}
+	const Symbol ActionListWhile::PreambleKey("Preamble");
+	const Symbol ActionListWhile::IncrementKey("Increment");
 
 	ActionListWhile* ActionListWhile::Clone() const
 	{
@@ -25,12 +16,13 @@ namespace Fiea::GameEngine {
 	}
 
 	/** Update
-	 * @brief Executes Preamble first the start a while loop to update each Action in the list till the condition is met
+	 * @brief Executes Preamble first the start a while loop to update each Action in the list till the condition is met.
+	 * Without a Preamble the Action then sleeps until its condition changes.
 	 * @param time 
 	*/
 	void ActionListWhile::Update(GameTime time)
 	{
-		Datum* IncrementDatum = Find("Increment");
+		Datum* IncrementDatum = Find(IncrementKey);
 		if (IncrementDatum->Empty()) {				// If the Increment Datum is empty, adds an Action increment that defaultly decrements by 1
 			// Add ActionIncrement as default
 			//ActionList* AL = new ActionList();
@@ -38,10 +30,10 @@ namespace Fiea::GameEngine {
 			increment->SetParent(GOparent);			// Sets increment's parent to ActionListWhile's GameObject Parent
 			increment->SetDatumKey(condition);	// Sets the Datum key to alter
 			increment->SetValue(-1);				// Set value to increment by to -1 so it decrementes by 1
-			Adopt(*increment, "Increment");		// Pushes the ActionIncrement into the Increment Datum
+			Adopt(*increment, IncrementKey);		// Pushes the ActionIncrement into the Increment Datum
 		}
 		// Call update on Preamble actions
-		Datum* Preamble = Find("Preamble");
+		Datum* Preamble = Find(PreambleKey);
 		if (Preamble->Size() > 0) {
 			for (int idx = 0; idx < (int)Preamble->GetScope()->GetSize(); ++idx) {
 				if (!(*Preamble->GetScope())[idx].Empty()) {
@@ -57,18 +49,19 @@ namespace Fiea::GameEngine {
 			}
 		}
 		// For easier access get the increment Action
-		Action* incrementAction = Find("Increment")->GetScope()->As<Action>();
+		Action* incrementAction = Find(IncrementKey)->GetScope()->As<Action>();
 
+		// Set conditionDatum based on the condition, every Update so a new parent is picked up (the path caches it)
+		if (condition != conditionPath.ToString()) {
+			conditionPath.Parse(condition);
+		}
+		conditionDatum = conditionPath.Resolve(*GOparent, GameObject::ChildrenKey);
 		if (conditionDatum == nullptr) {
-			// Set conditionDatum based on the condition 
-			conditionDatum = GOparent->Find(condition);
-			if (conditionDatum == nullptr) {
-				throw std::invalid_argument("Invalid condition datum");
-			}
+			throw std::invalid_argument("Invalid condition datum");
 		}
 		// Execute while loop for ActionListWhile
-		while (conditionDatum->Get<int>()) {				// Will run as long as condition is non-zero
-			Datum* Actions = Find("Actions");
+		while (conditionDatum->Get<int>(conditionPath.Index())) {				// Will run as long as condition is non-zero
+			Datum* Actions = Find(ActionsKey);
 			if (Actions->Size() > 0) {
 				for (int actionIdx = 0; actionIdx < (int)Actions->GetScope()->GetSize(); ++actionIdx) {
 					Action* loopAction = (*Actions->GetScope())[actionIdx].GetScope()->As<Action>();
@@ -84,9 +77,31 @@ namespace Fiea::GameEngine {
 			incrementAction->Update(time); // increments condition
 		}
 
+		// Without a Preamble nothing runs until the condition is set again, sleep till then. Only a condition of the
+		// own GameObject is watched, it lives as long as this Action.
+		if (!IsAsleep() && Preamble->Size() == 0 && conditionPath.Owner(*GOparent) == GOparent) {
+			SleepUntilChanged(*conditionDatum);
+		}
 	}
 
 
+	/** GetReach
+	 * @brief The widest reach of the condition, the Preamble, Increment and loop Actions
+	 * @return Ancestors if any of them reaches them, or the condition has not been resolved yet
+	*/
+	Action::Reach ActionListWhile::GetReach() const
+	{
+		if (ReachOf(conditionPath) == Reach::Ancestors) {
+			return Reach::Ancestors;
+		}
+		for (Symbol key : { PreambleKey, IncrementKey, ActionsKey }) {
+			if (ReachOfActions(Find(key)) == Reach::Ancestors) {
+				return Reach::Ancestors;
+			}
+		}
+		return Reach::Subtree;
+	}
+
 	/** SetCondition
 	 * @brief Resets Condition to new condition key
 	 * @param conditionKey: key to attribute to be used as condition
@@ -95,35 +110,20 @@ namespace Fiea::GameEngine {
 	{
 		conditionDatum = nullptr;
 		condition = conditionKey;
+		Wake();
 	}
 
 	/** Signatures
 	 * @brief returns the class' Signatures
-	 * @return vector of class' Signatures
-	*/
-	std::vector<Signature> ActionListWhile::Signatures()
-	{
-		return std::vector<Signature> {
-			{ "Condition"s, Datum::DatumType::String, 1, offsetof(ActionListWhile, condition)},
-			{ "Preamble"s, Datum::DatumType::Table, 0, 0},
-			{ "Increment"s, Datum::DatumType::Table, 0, 0 }
-		};
-	}
-
-
-	/** AppendId
-	 * @brief Appends ActionListWhile's type id to Ids
-	 * @param Ids : vector of type Ids
-	 * @return Address of vector of Ids
+	 * @return compile time table of class' Signatures
 	*/
-	std::vector<RTTI::IdType>* ActionListWhile::AppendId(std::vector<RTTI::IdType>* Ids)
+	std::span<const Signature> ActionListWhile::Signatures()
 	{
-		if (Ids == nullptr) {
-			ALWid = NEW std::vector<RTTI::IdType>();
-			ALWid->push_back(TypeIdClass());
-			return ALWid;
-		}
-		Ids->push_back(TypeIdClass());
-		return Ids;
+		static constexpr auto signatures = MakeSignatures({
+			SIGNATURE(ActionListWhile, condition, "Condition"),
+			{ "Preamble", Datum::DatumType::Table, 0, 0 },
+			{ "Increment", Datum::DatumType::Table, 0, 0 }
+		});
+		return signatures;
 	}
 }
@@ -1,13 +1,14 @@
 #pragma once
 #include "ActionList.h"
+#include "AttributePath.h"
 
 namespace Fiea::GameEngine {
 	class ActionListWhile : public ActionList {
 		RTTI_DECLARATIONS(ActionListWhile, ActionList);
 
 	public:
-		ActionListWhile(std::vector<RTTI::IdType>* Ids = nullptr) : ActionList(AppendId(Ids)) {};
-		virtual ~ActionListWhile();
+		ActionListWhile(TypeIdList* Ids = nullptr) : ActionList(AppendTypeId(Ids, TypeIdClass())) {};
+		virtual ~ActionListWhile() = default;
 		ActionListWhile(const ActionListWhile& WhileList) = default;
 		ActionListWhile(ActionListWhile&& WhileList) noexcept = default;
 		ActionListWhile& operator=(const ActionListWhile& rhs) = default;
@@ -15,14 +16,16 @@ namespace Fiea::GameEngine {
 		[[nodiscard]] ActionListWhile* Clone() const override;
 
 		void Update(GameTime time);
+		Reach GetReach() const override;
 		void SetCondition(const string& conditionKey);
 
-		static std::vector<Signature> Signatures();
+		static std::span<const Signature> Signatures();
+
+		static const Symbol PreambleKey;
+		static const Symbol IncrementKey;
 	private:
 		string condition = "\0";
 		Datum* conditionDatum;
-
-		std::vector<RTTI::IdType>* AppendId(std::vector<RTTI::IdType>* Ids);
-		std::vector<RTTI::IdType>* ALWid;
+		AttributePath conditionPath; // condition as of the last parse
 	};
 }
\ No newline at end of file
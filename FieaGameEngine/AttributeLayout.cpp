@@ -0,0 +1,87 @@
+#include "pch.h"
+#include "AttributeLayout.h"
+#include <algorithm>
+
+namespace Fiea::GameEngine {
+
+	/** Append
+	 * @brief Adds a type's Signatures after the ones already in the layout. A key that is already there keeps its
+	 * position, it is moved into the object when the new Signature has an Offset (the last one wins, like appending
+	 * the same key twice did), a Scope owned attribute never replaces an earlier one.
+	 * @param signatures : the type's Signatures, their names are interned here
+	 * @param typeId : the type they belong to
+	*/
+	void AttributeLayout::Append(std::span<const Signature> signatures, std::size_t typeId)
+	{
+		for (const Signature& signature : signatures) {
+			const Symbol key(signature.Name);
+			auto existing = std::find_if(_entries.begin(), _entries.end(), [key](const Entry& entry) { return entry.Key == key; });
+			if (existing == _entries.end()) {
+				_entries.push_back({ key, signature.Type, signature.size, signature.Offset });
+			}
+			else if (signature.Offset != 0) {
+				*existing = { key, signature.Type, signature.size, signature.Offset };
+			}
+		}
+		_types.push_back(typeId);
+	}
+
+	/** Seal
+	 * @brief Builds the prototype and the perfect hash index once every Signature is appended. Tries a few
+	 * multipliers per table size and doubles the table until the keys land in distinct slots.
+	*/
+	void AttributeLayout::Seal()
+	{
+		_prototype = std::make_unique<Scope>(static_cast<std::uint32_t>(_entries.size() + 1), Scope::Storage::Flat);
+		// Attributed::ThisKey, always first
+		_prototype->Append(Symbol("This")).SetStorage((char*)nullptr, 1, Datum::Pointer);
+		for (const Entry& entry : _entries) {
+			Datum& datum = _prototype->Append(entry.Key);
+			if (entry.Offset == 0) {
+				datum.SetTypeByType(entry.Type);
+			}
+			else {
+				// Attributed::Rebase points it into the object
+				datum.SetStorage((char*)nullptr, entry.Size, entry.Type);
+			}
+		}
+
+		std::uint32_t bits = 1;
+		while (((std::size_t)1 << bits) < _entries.size()) {
+			++bits;
+		}
+		for (;; ++bits) {
+			std::vector<Symbol> index((std::size_t)1 << bits);
+			const std::uint32_t shift = 32 - bits;
+			for (std::uint32_t attempt = 0; attempt < 32; ++attempt) {
+				const std::uint32_t multiplier = (0x9E3779B9u + attempt * 0x7F4A7C16u) | 1u;
+				std::fill(index.begin(), index.end(), Symbol());
+				bool collision = false;
+				for (const Entry& entry : _entries) {
+					Symbol& slot = index[(entry.Key.Id() * multiplier) >> shift];
+					if (slot.IsValid()) {
+						collision = true;
+						break;
+					}
+					slot = entry.Key;
+				}
+				if (!collision) {
+					_index = std::move(index);
+					_multiplier = multiplier;
+					_shift = shift;
+					return;
+				}
+			}
+		}
+	}
+
+	/** Covers
+	 * @brief Whether the Signatures of typeId are part of this layout
+	 * @param typeId : type id
+	 * @return true if they were appended
+	*/
+	bool AttributeLayout::Covers(std::size_t typeId) const
+	{
+		return std::find(_types.begin(), _types.end(), typeId) != _types.end();
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "Signature.h"
+#include "Scope.h"
+#include <vector>
+#include <cstdint>
+#include <memory>
+
+namespace Fiea::GameEngine {
+
+	/** AttributeLayout
+	 * @brief The prescribed attributes of one Attributed type, compiled once by the TypeManager from the Signatures of
+	 * the type and its registered ancestors. Entries are in the order Attributed appends them (base classes first) with
+	 * every key once, and a perfect hash over the interned keys answers "is this key prescribed" with one probe. The
+	 * prototype Scope holds the same attributes, ready for new objects to be copied from.
+	*/
+	class AttributeLayout final {
+	public:
+		// One prescribed attribute, Offset 0 means it lives in the Scope instead of the object
+		struct Entry {
+			Symbol Key;
+			Datum::DatumType Type;
+			std::uint32_t Size;
+			std::size_t Offset;
+		};
+
+		AttributeLayout() = default;
+
+		void Append(std::span<const Signature> signatures, std::size_t typeId);
+		void Seal();
+
+		bool Contains(Symbol key) const { return key.IsValid() && _index[(key.Id() * _multiplier) >> _shift] == key; };
+		bool Covers(std::size_t typeId) const;
+
+		const std::vector<Entry>& Entries() const { return _entries; };
+		std::size_t Size() const { return _entries.size(); };
+
+		// Flat Scope with the This Datum followed by every entry, the ones living in the object have no storage yet
+		const Scope& Prototype() const { return *_prototype; };
+
+	private:
+		std::vector<Entry> _entries;
+		std::vector<std::size_t> _types; // types whose Signatures were appended
+
+		// Perfect hash of the keys: slot = (Id * _multiplier) >> _shift, empty slots hold invalid Symbols
+		std::vector<Symbol> _index = std::vector<Symbol>(2);
+		std::uint32_t _multiplier = 1;
+		std::uint32_t _shift = 31;
+
+		std::unique_ptr<Scope> _prototype; // made by Seal
+	};
+}
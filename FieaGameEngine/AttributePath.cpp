@@ -0,0 +1,167 @@
+#include "pch.h"
+#include "AttributePath.h"
+#include <charconv>
+
+namespace Fiea::GameEngine {
+
+	/** AttributePath
+	 * @brief Parses path, see Parse
+	 * @param path : dotted and indexed attribute path
+	*/
+	AttributePath::AttributePath(std::string_view path)
+	{
+		Parse(path);
+	}
+
+	/** Parse
+	 * @brief Splits path at the dots into keys, each optionally followed by an element index in brackets ("Name[3]"),
+	 * and interns the keys. An empty path has no segments. Throws invalid_argument for an empty key or anything
+	 * but digits in the brackets, the previous path is kept in that case.
+	 * @param path : dotted and indexed attribute path
+	*/
+	void AttributePath::Parse(std::string_view path)
+	{
+		std::vector<Segment> segments;
+		size_t start = 0;
+		while (start < path.size()) {
+			size_t end = path.find('.', start);
+			if (end == std::string_view::npos) {
+				end = path.size();
+			}
+			std::string_view part = path.substr(start, end - start);
+
+			size_t index = 0;
+			size_t open = part.find('[');
+			size_t close = part.find(']');
+			if (open != std::string_view::npos || close != std::string_view::npos) {
+				if (open == std::string_view::npos || close != part.size() - 1 || close <= open + 1) {
+					throw std::invalid_argument("Invalid brackets in attribute path " + std::string(path));
+				}
+				auto [last, error] = std::from_chars(part.data() + open + 1, part.data() + close, index);
+				if (error != std::errc() || last != part.data() + close) {
+					throw std::invalid_argument("Invalid input in brackets");
+				}
+				part = part.substr(0, open);
+			}
+			if (part.empty()) {
+				throw std::invalid_argument("Empty key in attribute path " + std::string(path));
+			}
+			segments.push_back({ Symbol(part), index });
+
+			start = end + 1;
+			if (end + 1 == path.size()) {
+				throw std::invalid_argument("Empty key in attribute path " + std::string(path));
+			}
+		}
+
+		_segments = std::move(segments);
+		_path = path;
+		Invalidate();
+	}
+
+	/** Resolve
+	 * @brief Finds the Datum the path names, starting at root. The Datum found last time is returned again without
+	 * any lookups while it is still valid, see Valid.
+	 * @param root : Scope the first key is Searched from
+	 * @param wrappers : Table attribute of root whose element Scopes hold named children, checked for the first key
+	 * when root can't find it
+	 * @return the Datum, its element is Index(). nullptr if a key does not exist or names no nested Scope
+	*/
+	Datum* AttributePath::Resolve(Scope& root, Symbol wrappers)
+	{
+		if (&root == _root && wrappers == _wrappers && Valid()) {
+			// Writable access copies a shared Datum like Find does
+			Link& last = _links.back();
+			last.Owner->Unshare(*last.Found);
+			return last.Found;
+		}
+		return Walk(root, wrappers);
+	}
+
+	/** Walk
+	 * @brief Resolves the path one key at a time and remembers every step along with its Scope's generation
+	 * @param root : Scope the first key is Searched from
+	 * @param wrappers : Table attribute of root holding named children, ignored when invalid
+	 * @return the Datum, nullptr if the path does not resolve
+	*/
+	Datum* AttributePath::Walk(Scope& root, Symbol wrappers)
+	{
+		Invalidate();
+		if (_segments.empty()) {
+			return nullptr;
+		}
+
+		const Segment& first = _segments.front();
+		Scope* owner = nullptr;
+		Datum* found = root.Search(first.Key, &owner);
+		if (found == nullptr && wrappers.IsValid()) {
+			Datum* table = root.Find(wrappers);
+			if (table != nullptr && table->_type == Datum::DatumType::Table) {
+				for (size_t idx = 0; idx < table->Size() && found == nullptr; ++idx) {
+					Scope* wrapper = table->GetScope(idx);
+					if (wrapper != nullptr && (found = wrapper->Find(first.Key)) != nullptr) {
+						_links.push_back({ &root, table, 0, idx });
+						owner = wrapper;
+					}
+				}
+			}
+		}
+		if (found == nullptr) {
+			_links.clear();
+			return nullptr;
+		}
+		_links.push_back({ owner, found, 0, first.Index });
+
+		for (size_t idx = 1; idx < _segments.size(); ++idx) {
+			const Link& previous = _links.back();
+			if (previous.Found->_type != Datum::DatumType::Table || previous.Index >= previous.Found->Size()) {
+				_links.clear();
+				return nullptr;
+			}
+			Scope* nested = previous.Found->GetScope(previous.Index);
+			Datum* next = nested != nullptr ? nested->Find(_segments[idx].Key) : nullptr;
+			if (next == nullptr) {
+				_links.clear();
+				return nullptr;
+			}
+			_links.push_back({ nested, next, 0, _segments[idx].Index });
+		}
+
+		// Take the generations once every step is found
+		for (Link& link : _links) {
+			link.Generation = link.Owner->WatchedGeneration();
+		}
+		_root = &root;
+		_wrappers = wrappers;
+		_rootGeneration = root.WatchedGeneration();
+		return _links.back().Found;
+	}
+
+	/** Valid
+	 * @brief Whether the remembered steps still hold: root and every Scope on the way kept their generation (no new
+	 * keys, reparenting or replaced content, see Scope::InvalidateSearches) and each nested Scope is still the one
+	 * the Table Datum before it holds at that element.
+	 * @return true if the last resolved Datum can be handed out again
+	*/
+	bool AttributePath::Valid() const
+	{
+		if (_links.empty() || _root->_generation != _rootGeneration) {
+			return false;
+		}
+		for (size_t idx = 0; idx < _links.size(); ++idx) {
+			const Link& link = _links[idx];
+			if (idx > 0) {
+				// Compare against the Table first, the Owner is only dereferenced once it is known to be alive
+				const Datum& table = *_links[idx - 1].Found;
+				const size_t element = _links[idx - 1].Index;
+				if (table._type != Datum::DatumType::Table || element >= table.Size() || static_cast<Scope* const*>(table._mData)[element] != link.Owner) {
+					return false;
+				}
+			}
+			if (link.Owner->_generation != link.Generation) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
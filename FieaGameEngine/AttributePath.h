@@ -0,0 +1,67 @@
+#pragma once
+#include "Scope.h"
+#include <vector>
+#include <string>
+#include <string_view>
+
+namespace Fiea::GameEngine {
+
+	/** AttributePath
+	 * @brief A dotted and indexed attribute path such as "Sword.Damage" or "Stats[2].Health[1]", parsed once into
+	 * interned keys and element indices. The first key is Searched from the root Scope (so inherited attributes are
+	 * found), every following key is looked up in the nested Scope the previous segment names.
+	 * When the first key is not an attribute and a wrappers key is given, it is looked for in the element Scopes of
+	 * that Table attribute instead, this is how GameObjects keep named children (see GameObject::ChildrenKey).
+	 * Resolve remembers every Scope and Datum on the way and hands the same Datum back while none of those Scopes
+	 * changed (their Search generation) and every nested Scope is still where it was found.
+	*/
+	class AttributePath final {
+	public:
+		// A key and the element of its Datum the path continues in (or ends at)
+		struct Segment {
+			Symbol Key;
+			std::size_t Index;
+		};
+
+		AttributePath() = default;
+		explicit AttributePath(std::string_view path);
+
+		void Parse(std::string_view path);
+
+		Datum* Resolve(Scope& root, Symbol wrappers = Symbol());
+
+		// Element index the path ends at, 0 without brackets on the last key
+		std::size_t Index() const { return _segments.empty() ? 0 : _segments.back().Index; };
+
+		const std::vector<Segment>& Segments() const { return _segments; };
+		const std::string& ToString() const { return _path; };
+		bool Empty() const { return _segments.empty(); };
+
+		// Scope holding the Datum the last Resolve from root returned, nullptr unless Resolve would hand it out again
+		const Scope* Owner(const Scope& root) const { return &root == _root && Valid() ? _links.back().Owner : nullptr; };
+
+		// Forgets the resolved Datum, the next Resolve walks the path again
+		void Invalidate() { _root = nullptr; _links.clear(); };
+
+	private:
+		// One step of a resolved path: Datum was found in Owner while Owner had Generation
+		struct Link {
+			Scope* Owner;
+			Datum* Found;
+			std::uint64_t Generation;
+			std::size_t Index; // element of Found the next step continues in
+		};
+
+		Datum* Walk(Scope& root, Symbol wrappers);
+		bool Valid() const;
+
+		std::string _path;
+		std::vector<Segment> _segments;
+
+		// Cached resolution
+		Scope* _root = nullptr;
+		Symbol _wrappers;
+		std::uint64_t _rootGeneration = 0;
+		std::vector<Link> _links;
+	};
+}
@@ -3,6 +3,7 @@
 #include "pch.h"
 #include "Attributed.h"
 #include "Signature.h"
+#include "EntityStore.h"
 
 using string = std::string;
 using vec4 = glm::vec4;
@@ -11,42 +12,155 @@ using mat4 = glm::mat4;
 namespace Fiea::GameEngine {
 	RTTI_DEFINITIONS(Attributed);
 
-	Attributed::Attributed(RTTI::IdType id, std::vector<RTTI::IdType>* childIds)
-	{
+	const Symbol Attributed::ThisKey("This");
+
+	// What objects without a complete layout start from before their attributes are appended one by one
+	static const Scope NoPrototype;
+
+	/** Attributed
+	 * @brief Populates the prescribed attributes of the type being constructed. The derived constructors append their
+	 * type ids to childIds, the most derived first. When that type's layout already holds every one of them (it was
+	 * registered with TypeManager::add<T>) the object starts as a block copy of the layout's prototype Scope and only
+	 * the pointers into the object are set, otherwise each type's layout is applied in turn.
+	 * @param id : type id of the class right below Attributed
+	 * @param childIds : type ids of the derived classes
+	*/
+	Attributed::Attributed(RTTI::IdType id, const TypeIdList* childIds) : Attributed(CompleteLayout(id, childIds), id, childIds) {}
+
+	/** Attributed
+	 * @brief Copies the prototype of complete when there is one
+	 * @param complete : layout covering id and every childId, nullptr if there is none
+	 * @param id : type id of the class right below Attributed
+	 * @param childIds : type ids of the derived classes
+	*/
+	Attributed::Attributed(const AttributeLayout* complete, RTTI::IdType id, const TypeIdList* childIds) :
+		Scope(complete != nullptr ? complete->Prototype() : NoPrototype) {
+		if (complete != nullptr) {
+			Rebase(*complete);
+			return;
+		}
 		PopulateAttribute(id);
 		if (childIds != nullptr) {
-			for (int idx = 0; idx < (int)childIds->size(); ++idx) {
-				PopulateAttribute(childIds->at(idx));
+			for (RTTI::IdType childId : *childIds) {
+				PopulateAttribute(childId);
+			}
+		}
+	}
+
+	/** CompleteLayout
+	 * @brief The layout of the most derived type, if it holds the attributes of every type being constructed
+	 * @param id : type id of the class right below Attributed
+	 * @param childIds : type ids of the derived classes
+	 * @return the layout, nullptr if some type's attributes are missing from it
+	*/
+	const AttributeLayout* Attributed::CompleteLayout(RTTI::IdType id, const TypeIdList* childIds) {
+		const bool derived = childIds != nullptr && !childIds->IsEmpty();
+		const AttributeLayout& layout = TypeManager::layout(derived ? childIds->Front() : id);
+		if (!layout.Covers(id)) {
+			return nullptr;
+		}
+		if (derived) {
+			for (RTTI::IdType childId : *childIds) {
+				if (!layout.Covers(childId)) {
+					return nullptr;
+				}
 			}
 		}
-	};
+		return &layout;
+	}
 
+	/** Rebase
+	 * @brief Points the This Datum and the attributes living in the object, still empty in the prototype, at this
+	 * @param layout : layout the Scope was copied from
+	*/
+	void Attributed::Rebase(const AttributeLayout& layout) {
+		char* beginPtr = reinterpret_cast<char*>(this);
+		// Entries are in the prototype's order, This first
+		(*this)[std::uint32_t(0)].SetStorage(this, 1, Datum::Pointer);
+		const std::vector<AttributeLayout::Entry>& entries = layout.Entries();
+		for (size_t idx = 0; idx < entries.size(); ++idx) {
+			const AttributeLayout::Entry& entry = entries[idx];
+			if (entry.Offset != 0) {
+				(*this)[static_cast<std::uint32_t>(idx + 1)].SetStorage(beginPtr + entry.Offset, entry.Size, entry.Type);
+			}
+		}
+	}
+
+	// Destructor, leaves the EntityStore holding the object
+	Attributed::~Attributed()
+	{
+		if (_entityBinding.Store != nullptr) {
+			_entityBinding.Store->Erase(*this);
+		}
+	}
+
+	/**
+	 * @brief Copy constructor, the copy is not stored. A stored original's members are brought up to date first,
+	 * the derived copy constructors copy them.
+	 * @param other
+	*/
 	Attributed::Attributed(const Attributed& other) : Scope(other){
 		PopulateAttribute(other.TypeIdInstance());
+		if (other._entityBinding.Store != nullptr) {
+			other._entityBinding.Store->Sync(other);
+		}
 	}
 
+	/**
+	 * @brief Copy assignment, takes this object out of its EntityStore
+	 * @param rhs
+	 * @return this object
+	*/
 	Attributed& Attributed::operator=(const Attributed& rhs) {
 		if (&rhs == this) {
 			return *this;
 		}
+		if (_entityBinding.Store != nullptr) {
+			_entityBinding.Store->Remove(*this);
+		}
+		if (rhs._entityBinding.Store != nullptr) {
+			rhs._entityBinding.Store->Sync(rhs);
+		}
 		Scope::operator=(rhs);
 		PopulateAttribute(rhs.TypeIdInstance());
 		return *this;
 	}
 
-	Attributed::Attributed(Attributed&& moveother) noexcept : Scope(std::move(moveother)){
+	/**
+	 * @brief Move constructor, a stored original leaves its EntityStore first
+	 * @param moveother
+	*/
+	Attributed::Attributed(Attributed&& moveother) noexcept : Scope(std::move(Unstored(moveother))){
 		PopulateAttribute(moveother.TypeIdInstance());
 	}
 
+	/**
+	 * @brief Move assignment, both objects leave their EntityStores
+	 * @param moverhs
+	 * @return this object
+	*/
 	Attributed& Attributed::operator=(Attributed&& moverhs) noexcept{
 		if (&moverhs == this) {
 			return *this;
 		}
-		Scope::operator=(std::move(moverhs));
+		Unstored(*this);
+		Scope::operator=(std::move(Unstored(moverhs)));
 		PopulateAttribute(moverhs.TypeIdInstance());
 		return *this;
 	}
 
+	/** Unstored
+	 * @brief Takes object out of its EntityStore, its members hold the attributes again
+	 * @param object
+	 * @return object
+	*/
+	Attributed& Attributed::Unstored(Attributed& object) {
+		if (object._entityBinding.Store != nullptr) {
+			object._entityBinding.Store->Remove(object);
+		}
+		return object;
+	}
+
 	bool Attributed::IsAttribute(const std::string& name) const
 	{
 		// check if this is an attribute
@@ -57,13 +171,13 @@ namespace Fiea::GameEngine {
 	}
 
 	bool Attributed::IsPrescribedAttribute(const std::string& name) const {
-		const std::vector<Signature> sig = TypeManager::get(TypeIdInstance());
-		for (Signature s : sig) {
-			if (s.Name == name) {
-				return true;
-			}
-		}
-		return false;
+		// A name that was never interned can't belong to any registered signature
+		Symbol key = Symbol::Find(name);
+		return key.IsValid() && IsPrescribedAttribute(key);
+	}
+
+	bool Attributed::IsPrescribedAttribute(Symbol key) const {
+		return TypeManager::layout(TypeIdInstance()).Contains(key);
 	}
 
 	bool Attributed::IsAuxiliaryAttribute(const std::string& name) const {
@@ -81,24 +195,30 @@ namespace Fiea::GameEngine {
 	}
 
 	void Attributed::PopulateAttribute(RTTI::IdType id) {
-		const std::vector<Signature> sig = TypeManager::get(id);
+		PopulateAttribute(TypeManager::layout(id));
+	}
+
+	/** PopulateAttribute
+	 * @brief Appends the This pointer and every attribute of layout, pointing the prescribed ones into this object
+	 * @param layout : compiled attributes of a type
+	*/
+	void Attributed::PopulateAttribute(const AttributeLayout& layout) {
 		char* beginPtr = reinterpret_cast<char*>(this);
+		// Checks go through const Find so Datums shared by CloneShared stay shared
+		const Scope& self = *this;
 
-		// Adding first element containing this pointer
-		if (Find("This") == nullptr) {
-			Append("This").SetStorage(this, 1, Datum::Pointer);
-		}
-		for (Signature s : sig) {
-			if (s.Offset == 0) {
+		// Adding first element containing this pointer, a copy's still points at the original
+		Append(ThisKey).SetStorage(this, 1, Datum::Pointer);
+		for (const AttributeLayout::Entry& entry : layout.Entries()) {
+			if (entry.Offset == 0) {
 				// check if cloning
-				if (Find(s.Name) == nullptr) {
-					Append(s.Name).SetTypeByType(s.Type);
+				if (self.Find(entry.Key) == nullptr) {
+					Append(entry.Key).SetTypeByType(entry.Type);
 				}
 			}
 			else {
-				Append(s.Name).SetStorage((beginPtr + s.Offset), s.size, s.Type);
+				Append(entry.Key).SetStorage((beginPtr + entry.Offset), entry.Size, entry.Type);
 			}
 		};
-
 	}
 }
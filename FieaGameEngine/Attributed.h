@@ -1,14 +1,43 @@
 #pragma once
 #include "Scope.h"
 #include "TypeManager.h"
+#include <array>
 
 namespace Fiea::GameEngine {
+	class EntityStore;
+
+	/** TypeIdList
+	 * @brief Type ids the derived constructors collect on their way down to Attributed, the most derived first.
+	 * Fixed capacity, it lives in a temporary of the constructor call so building an object never allocates for it.
+	*/
+	class TypeIdList final {
+	public:
+		static constexpr std::size_t Capacity = 16;
+
+		void Push(RTTI::IdType id) {
+			if (_size == Capacity) {
+				throw std::runtime_error("Too many derived types for a TypeIdList");
+			}
+			_ids[_size++] = id;
+		};
+
+		std::size_t Size() const { return _size; };
+		bool IsEmpty() const { return _size == 0; };
+		RTTI::IdType Front() const { return _ids[0]; };
+		const RTTI::IdType* begin() const { return _ids.data(); };
+		const RTTI::IdType* end() const { return _ids.data() + _size; };
+
+	private:
+		std::array<RTTI::IdType, Capacity> _ids;
+		std::size_t _size = 0;
+	};
+
 	class Attributed : public Scope
 	{
 		RTTI_DECLARATIONS(Attributed, Scope);
 
 	public:
-		virtual ~Attributed() {};
+		virtual ~Attributed();
 		Attributed(const Attributed& other);
 		Attributed& operator=(const Attributed& rhs);
 		Attributed(Attributed&& other) noexcept;
@@ -18,14 +47,50 @@ namespace Fiea::GameEngine {
 
 		virtual bool IsAttribute(const std::string& name) const;
 		virtual bool IsPrescribedAttribute(const std::string& name) const;
+		virtual bool IsPrescribedAttribute(Symbol key) const;
 		virtual bool IsAuxiliaryAttribute(const std::string& name) const;
 		virtual Datum& AppendAuxiliaryAttribute(const std::string& name);
 
+		// The EntityStore keeping the prescribed attributes in its columns, nullptr if there is none
+		EntityStore* GetEntityStore() const { return _entityBinding.Store; };
+
+		// Key of the Datum holding the object's own this pointer
+		static const Symbol ThisKey;
+
 	protected:
-		explicit Attributed(RTTI::IdType id, std::vector<RTTI::IdType>* childIds = nullptr);
+		explicit Attributed(RTTI::IdType id, const TypeIdList* childIds = nullptr);
+
+		// Adds id to ids for the base constructor, a new list lives in scratch when ids is nullptr
+		static TypeIdList* AppendTypeId(TypeIdList* ids, RTTI::IdType id, TypeIdList&& scratch = TypeIdList()) {
+			TypeIdList* list = ids != nullptr ? ids : &scratch;
+			list->Push(id);
+			return list;
+		};
 
 		// PopulateAttribute Helper method
 		void PopulateAttribute(RTTI::IdType id);
+		void PopulateAttribute(const AttributeLayout& layout);
+
+	private:
+		friend EntityStore;
+
+		// The EntityStore holding the object and its row there, copying never carries it over
+		struct EntityBinding {
+			EntityStore* Store = nullptr;
+			std::uint32_t Archetype = 0;
+			std::uint32_t Row = 0;
+
+			EntityBinding() = default;
+			EntityBinding(const EntityBinding&) {};
+			EntityBinding& operator=(const EntityBinding&) { return *this; };
+		};
+		EntityBinding _entityBinding;
+
+		Attributed(const AttributeLayout* complete, RTTI::IdType id, const TypeIdList* childIds);
+
+		static const AttributeLayout* CompleteLayout(RTTI::IdType id, const TypeIdList* childIds);
+		static Attributed& Unstored(Attributed& object);
+		void Rebase(const AttributeLayout& layout);
 
 	};
 }
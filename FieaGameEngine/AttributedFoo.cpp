@@ -42,7 +42,7 @@ using namespace std::string_literals;
 		*/
 		bool AttributedFoo::IsPrescribedAttribute(const std::string& name) const {
 			if (IsAttribute(name)) {
-				for (Signature s : Signatures()) {
+				for (const Signature& s : Signatures()) {
 					if (s.Name == name) {
 						return true;
 					}
@@ -74,18 +74,19 @@ using namespace std::string_literals;
 		}
 
 
-		std::vector<Signature> AttributedFoo::Signatures() {
-			return std::vector<Signature> {
-		{ "externalInteger"s, Datum::DatumType::Int, 1, offsetof(AttributedFoo, externalInteger) },
-		{ "externalFloat"s, Datum::DatumType::Float, 1, offsetof(AttributedFoo, externalFloat) },
-		{ "externalString"s, Datum::DatumType::String, 1, offsetof(AttributedFoo, externalString) },
-		{ "externalVector"s, Datum::DatumType::Vector, 1, offsetof(AttributedFoo, externalVector) },
-		{ "externalMatrix"s, Datum::DatumType::Matrix, 1, offsetof(AttributedFoo, externalMatrix) },
-		{ "externalIntegerArray"s, Datum::DatumType::Int, arraySize, offsetof(AttributedFoo, externalIntegerArray) },
-		{ "externalFloatArray"s, Datum::DatumType::Float, arraySize, offsetof(AttributedFoo, externalFloatArray) },
-		{ "externalStringArray"s, Datum::DatumType::String, arraySize, offsetof(AttributedFoo, externalStringArray) },
-		{ "externalVectorArray"s, Datum::DatumType::Vector, arraySize, offsetof(AttributedFoo, externalVectorArray) },
-		{ "externalMatrixArray"s, Datum::DatumType::Matrix, arraySize, offsetof(AttributedFoo, externalMatrixArray) },
-			};
+		std::span<const Signature> AttributedFoo::Signatures() {
+			static constexpr auto signatures = MakeSignatures({
+		SIGNATURE(AttributedFoo, externalInteger, "externalInteger"),
+		SIGNATURE(AttributedFoo, externalFloat, "externalFloat"),
+		SIGNATURE(AttributedFoo, externalString, "externalString"),
+		SIGNATURE(AttributedFoo, externalVector, "externalVector"),
+		SIGNATURE(AttributedFoo, externalMatrix, "externalMatrix"),
+		SIGNATURE(AttributedFoo, externalIntegerArray, "externalIntegerArray"),
+		SIGNATURE(AttributedFoo, externalFloatArray, "externalFloatArray"),
+		SIGNATURE(AttributedFoo, externalStringArray, "externalStringArray"),
+		SIGNATURE(AttributedFoo, externalVectorArray, "externalVectorArray"),
+		SIGNATURE(AttributedFoo, externalMatrixArray, "externalMatrixArray")
+			});
+			return signatures;
 		}
 	}
\ No newline at end of file
@@ -42,7 +42,7 @@ namespace Fiea::GameEngine {
 
 		//bool Equals(const RTTI* rhs) const override;
 		std::string ToString() const override { return Attributed::ToString(); }
-		static std::vector<Signature> Signatures();
+		static std::span<const Signature> Signatures();
 		
 	};
 }
\ No newline at end of file
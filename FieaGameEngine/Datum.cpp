@@ -1,21 +1,308 @@
 #include "pch.h"
 #include "Datum.h"
+#include "HeapResource.h"
 #include "typeinfo"
 #include <stdexcept>
 #include <regex>
 #include <sstream>
-
-#define NULLVEC glm::vec4(0.0f);
-#define NULLMAT glm::mat4(0.0f);
+#include <limits>
+#include <vector>
 
 namespace Fiea::GameEngine {
+	static_assert(sizeof(glm::vec4) == 4 * sizeof(float) && sizeof(glm::mat4) == 16 * sizeof(float), "Datum compares vectors and matrices as float arrays");
+
+	namespace {
+		/** EqualFloats
+		 * @brief Compares two float arrays a block at a time, without branching inside a block so the loop vectorizes
+		 * @return true if every float compares equal (so -0 == 0 and NaN != NaN like operator==)
+		*/
+		bool EqualFloats(const float* lhs, const float* rhs, size_t count) {
+			constexpr size_t BlockSize = 64;
+			for (size_t start = 0; start < count; start += BlockSize) {
+				const size_t end = std::min(count, start + BlockSize);
+				int differ = 0;
+				for (size_t i = start; i < end; ++i) {
+					differ |= (lhs[i] != rhs[i]);
+				}
+				if (differ) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// String parsing per element type, throws on malformed input
+		void ParseElement(const std::string& s, int& out) {
+			static const std::regex intPattern("[0-9]*");
+			if (!std::regex_match(s, intPattern)) {
+				throw std::runtime_error("Invalid string entered");
+			}
+			out = std::stoi(s);
+		}
+
+		void ParseElement(const std::string& s, float& out) {
+			static const std::regex floatPattern("[0-9]+\\.[0-9]+[f]?");
+			if (!std::regex_match(s, floatPattern)) {
+				throw std::runtime_error("Invalid string entered");
+			}
+			out = std::stof(s);
+		}
+
+		void ParseElement(const std::string& s, std::string& out) {
+			out = s;
+		}
+
+		void ParseElement(const std::string& s, glm::vec4& out) {
+			float v[4];
+			if (sscanf_s(s.c_str(), "Vec4(%f, %f, %f, %f)", &v[0], &v[1], &v[2], &v[3]) != 4 && sscanf_s(s.c_str(), "vec4(%f, %f, %f, %f)", &v[0], &v[1], &v[2], &v[3]) != 4) {
+				throw std::runtime_error("Invalid string entered");
+			}
+			out = glm::vec4(v[0], v[1], v[2], v[3]);
+		}
+
+		void ParseElement(const std::string& s, glm::mat4& out) {
+			float m[16];
+			const char* formats[] = { "Mat4((%f, %f, %f, %f), (%f, %f, %f, %f), (%f, %f, %f, %f), (%f, %f, %f, %f))", "mat4((%f, %f, %f, %f), (%f, %f, %f, %f), (%f, %f, %f, %f), (%f, %f, %f, %f))" };
+			bool parsed = false;
+			for (const char* format : formats) {
+				if (sscanf_s(s.c_str(), format, &m[0], &m[1], &m[2], &m[3], &m[4], &m[5], &m[6], &m[7], &m[8], &m[9], &m[10], &m[11], &m[12], &m[13], &m[14], &m[15]) == 16) {
+					parsed = true;
+					break;
+				}
+			}
+			if (!parsed) {
+				throw std::runtime_error("Invalid string entered");
+			}
+			out = glm::mat4(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8], m[9], m[10], m[11], m[12], m[13], m[14], m[15]);
+		}
+
+		std::string ElementToString(int value) { return std::to_string(value); }
+		std::string ElementToString(float value) { return std::to_string(value); }
+		std::string ElementToString(const std::string& value) { return value; }
+		std::string ElementToString(const glm::vec4& value) { return glm::to_string(value); }
+		std::string ElementToString(const glm::mat4& value) { return glm::to_string(value); }
+
+		/** DeduceType
+		 * @brief Guesses the DatumType a string represents, used by SetFromString on an Unknown Datum
+		 * @param s
+		 * @return Int, Float, Vector, Matrix or String
+		*/
+		Datum::DatumType DeduceType(const std::string& s) {
+			static const std::regex floatPattern("[0-9]+\\.[0-9]+[f]?");
+			if (std::regex_match(s, floatPattern)) {
+				return Datum::Float;
+			}
+			if (std::all_of(s.begin(), s.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; })) {
+				return Datum::Int;
+			}
+			std::string prefix = s.substr(0, 4);
+			if (prefix == "Mat4" || prefix == "mat4") {
+				return Datum::Matrix;
+			}
+			if (prefix == "Vec4" || prefix == "vec4") {
+				return Datum::Vector;
+			}
+			return Datum::String;
+		}
+
+		/** ElementOps
+		 * @brief Type specialized loops over raw element storage, one instantiation per DatumType element type
+		 * @tparam T : element type
+		*/
+		template<class T>
+		struct ElementOps {
+			using Type = T;
+
+			static void Copy(void* dest, const void* src, size_t count) {
+				if constexpr (std::is_trivially_copyable_v<T>) {
+					if (count > 0) {
+						memcpy(dest, src, sizeof(T) * count);
+					}
+				}
+				else {
+					std::uninitialized_copy_n(static_cast<const T*>(src), count, static_cast<T*>(dest));
+				}
+			}
+
+			static void Relocate(void* dest, void* src, size_t count) noexcept {
+				if constexpr (std::is_trivially_copyable_v<T>) {
+					if (count > 0) {
+						memcpy(dest, src, sizeof(T) * count);
+					}
+				}
+				else {
+					static_assert(std::is_nothrow_move_constructible_v<T>, "Relocating elements must not throw");
+					std::uninitialized_move_n(static_cast<T*>(src), count, static_cast<T*>(dest));
+					std::destroy_n(static_cast<T*>(src), count);
+				}
+			}
+
+			static void Destroy(void* data, size_t count) noexcept {
+				if constexpr (!std::is_trivially_destructible_v<T>) {
+					std::destroy_n(static_cast<T*>(data), count);
+				}
+			}
+
+			static bool Equal(const void* lhs, const void* rhs, size_t count) {
+				if constexpr (std::has_unique_object_representations_v<T>) {
+					// Equal values have equal bytes, a single memcmp does
+					return count == 0 || memcmp(lhs, rhs, sizeof(T) * count) == 0;
+				}
+				else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, glm::vec4> || std::is_same_v<T, glm::mat4>) {
+					return EqualFloats(static_cast<const float*>(lhs), static_cast<const float*>(rhs), count * (sizeof(T) / sizeof(float)));
+				}
+				else {
+					return std::equal(static_cast<const T*>(lhs), static_cast<const T*>(lhs) + count, static_cast<const T*>(rhs));
+				}
+			}
+
+			// Removes the element at idx out of count, shifting the following ones down
+			static void Erase(void* data, size_t idx, size_t count) {
+				T* ptr = static_cast<T*>(data);
+				if constexpr (std::is_trivially_copyable_v<T>) {
+					memmove(ptr + idx, ptr + idx + 1, sizeof(T) * (count - idx - 1));
+				}
+				else {
+					std::move(ptr + idx + 1, ptr + count, ptr + idx);
+					ptr[count - 1].~T();
+				}
+			}
+
+			// Removes the element at idx out of count, moving the last one into its place
+			static void SwapErase(void* data, size_t idx, size_t count) {
+				T* ptr = static_cast<T*>(data);
+				if (idx != count - 1) {
+					if constexpr (std::is_trivially_copyable_v<T>) {
+						memcpy(ptr + idx, ptr + count - 1, sizeof(T));
+					}
+					else {
+						ptr[idx] = std::move(ptr[count - 1]);
+					}
+				}
+				if constexpr (!std::is_trivially_destructible_v<T>) {
+					ptr[count - 1].~T();
+				}
+			}
+
+			static std::string ToString(const void* data, size_t idx) {
+				return ElementToString(static_cast<const T*>(data)[idx]);
+			}
+
+			// Sets element idx, or pushes a new one when idx is the Datum's size
+			static void FromString(Datum& datum, size_t idx, const std::string& s) {
+				T value;
+				ParseElement(s, value);
+				if (idx < datum.Size()) {
+					datum.Set(idx, value);
+				}
+				else {
+					datum.Push(value);
+				}
+			}
+		};
+
+		// RTTI pointers compare through Equals, other pointers by address
+		struct PointerOps : ElementOps<RTTI*> {
+			static bool Equal(const void* lhs, const void* rhs, size_t count) {
+				const RTTI* const* lhsPtr = static_cast<const RTTI* const*>(lhs);
+				const RTTI* const* rhsPtr = static_cast<const RTTI* const*>(rhs);
+				for (size_t i = 0; i < count; ++i) {
+					if (lhsPtr[i] != rhsPtr[i] && (lhsPtr[i] == nullptr || !lhsPtr[i]->Equals(rhsPtr[i]))) {
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		// The heap resources are the same heap malloc uses, keep the realloc fast path for them
+		std::pmr::memory_resource* ResourceOf(const Datum::allocator_type& allocator) {
+			std::pmr::memory_resource* resource = allocator.resource();
+			return resource == HeapResource::Get() || resource == std::pmr::new_delete_resource() ? nullptr : resource;
+		}
+	}
+
+	/** TypeOps
+	 * @brief Everything Datum does to its elements without knowing their type. Table and Pointer have no
+	 * string form so their ToString and FromString are nullptr. PooledString entries are only half a string,
+	 * their ToString is nullptr too and Datum reads them together with the character pool.
+	*/
+	struct Datum::TypeOps {
+		const char* Name;
+		bool TriviallyCopyable;
+		void (*Copy)(void* dest, const void* src, size_t count);
+		void (*Relocate)(void* dest, void* src, size_t count) noexcept;
+		void (*Destroy)(void* data, size_t count) noexcept;
+		bool (*Equal)(const void* lhs, const void* rhs, size_t count);
+		void (*Erase)(void* data, size_t idx, size_t count);
+		void (*SwapErase)(void* data, size_t idx, size_t count);
+		std::string (*ToString)(const void* data, size_t idx);
+		void (*FromString)(Datum& datum, size_t idx, const std::string& s);
+
+		template<class Elements>
+		static constexpr TypeOps For(const char* name) {
+			using T = typename Elements::Type;
+			TypeOps ops{ name, std::is_trivially_copyable_v<T>, &Elements::Copy, &Elements::Relocate, &Elements::Destroy, &Elements::Equal, &Elements::Erase, &Elements::SwapErase, nullptr, nullptr };
+			if constexpr (!std::is_pointer_v<T>) {
+				ops.FromString = &Elements::FromString;
+				if constexpr (!std::is_same_v<T, PooledEntry>) {
+					ops.ToString = &Elements::ToString;
+				}
+			}
+			return ops;
+		}
+	};
+
+	/** PooledStringOps
+	 * @brief Entries are plain offsets into the character pool, so copying and moving them is a memcpy.
+	 * Parsing stores the characters through the Datum.
+	*/
+	struct Datum::PooledStringOps : ElementOps<PooledEntry> {
+		static void FromString(Datum& datum, size_t idx, const std::string& s) {
+			if (idx < datum.Size()) {
+				datum.SetString(idx, s);
+			}
+			else {
+				datum.Push(std::string_view(s));
+			}
+		}
+	};
 
+	/** Ops
+	 * @brief Looks up the operations for type
+	 * @param type
+	 * @return TypeOps of type
+	*/
+	const Datum::TypeOps& Datum::Ops(DatumType type) {
+		static constexpr TypeOps table[] = {
+			TypeOps::For<ElementOps<void*>>("Unknown"),
+			TypeOps::For<ElementOps<int>>("Int"),
+			TypeOps::For<ElementOps<float>>("Float"),
+			TypeOps::For<ElementOps<std::string>>("String"),
+			TypeOps::For<ElementOps<glm::vec4>>("Vector"),
+			TypeOps::For<ElementOps<glm::mat4>>("Matrix"),
+			TypeOps::For<ElementOps<Scope*>>("Table"),
+			TypeOps::For<PointerOps>("Pointer"),
+			TypeOps::For<PooledStringOps>("PooledString")
+		};
+		static_assert(std::size(table) == std::size(typeSizes), "Every DatumType needs its operations");
+		if (static_cast<size_t>(type) >= std::size(table)) {
+			throw std::invalid_argument("Invalid Datum Type");
+		}
+		return table[type];
+	}
 
 	/** Default Constructor
 	 * @brief Construct and empty Datum and setting startPointer to nullptr
 	*/
 	Datum::Datum(): _mData(nullptr) {}
 
+	/** Allocator Constructor
+	 * @brief Constructs an empty Datum whose storage will come from allocator's resource
+	 * @param allocator
+	*/
+	Datum::Datum(std::allocator_arg_t, const allocator_type& allocator) : _mData(nullptr), _resource(ResourceOf(allocator)) {}
+
 	/** Deconstructor
 	 * @brief frees up allocated memory and makes sure Datum is deconstructed correctly
 	*/
@@ -27,31 +314,13 @@ namespace Fiea::GameEngine {
 			externalStorage = false;
 			_type = Unknown;
 		}
-		else {
-			switch (_type)
-			{
-			case Table:
-			case Pointer:
-			case Int:
-			case Float:
-			case Vector:
-			case Matrix:
-				free(_mData); // For all PODs just frees _mData and the contents are dealt with
-				break;
-			case String: {
-				std::string* stringPtr = static_cast<std::string*>(_mData);
-				for (size_t i = 0; i < _DatumSize; ++i) {
-					(stringPtr + i)->~basic_string();
-				}
-				free(stringPtr);
-				break;
-			}
-			default:
-				break;
-			};
+		else if (_type != Unknown) {
+			Release();
+			FreeChars();
 		}
 	}
 
+
 	/** Parameterized constructor template specialization for strings
 	 * @brief Specialized Parameterized constructor for string types
 	 * @param const char* st
@@ -62,14 +331,32 @@ namespace Fiea::GameEngine {
 		std::string strValue = std::string(value);
 		SetType(value); // Sets the DatumType (_type) for the Datum
 		
-		_mData = (std::string*)malloc(sizeof(std::string)); //Allocate memory for a single string
+		_mData = AllocateStorage(1); //Storage for a single string, kept inline
 		new(_mData) std::string(strValue); // Placement new
 		_DatumSize++;
 		_DatumCapacity++;
 	}
 
+	/** Parameterized constructor for pooled strings
+	 * @brief Constructs a PooledString Datum holding value
+	 * @param value
+	*/
+	Datum::Datum(std::string_view value) {
+		Push(value);
+	}
+
 	// Copy Constructors
-	Datum::Datum(Datum& other): _DatumSize(other._DatumSize), _DatumCapacity(other._DatumCapacity), _type(other._type) {
+	Datum::Datum(Datum& other) : Datum(static_cast<const Datum&>(other)) {}
+
+	Datum::Datum(const Datum& other) : Datum(std::allocator_arg, allocator_type(HeapResource::Get()), other) {}
+
+	/**
+	 * @brief Copy constructor allocating the copy's storage from allocator's resource
+	 * @param allocator
+	 * @param other
+	*/
+	Datum::Datum(std::allocator_arg_t, const allocator_type& allocator, const Datum& other) : _DatumSize(other._DatumSize), _DatumCapacity(other._DatumCapacity),
+		_type(other._type), _resource(ResourceOf(allocator)) {
 		if (other.externalStorage) {
 			externalStorage = true;
 			_mData = other._mData;
@@ -77,133 +364,54 @@ namespace Fiea::GameEngine {
 		else {
 			if (_type != Unknown) {
 				// Allocate memory based on the other Datum's capacity
-				_mData = malloc(typeSizes[_type] * _DatumCapacity);
+				_mData = AllocateStorage(_DatumCapacity);
 				// Copies over content based on type
-				switch (_type)
-				{
-				case Fiea::GameEngine::Datum::Int: {
-					int* intPtr = static_cast<int*>(_mData);
-					int* otherPtr = static_cast<int*>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(intPtr + i) int(otherPtr[i]);
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::Float: {
-					float* floatPtr = static_cast<float*>(_mData);
-					float* otherPtr = static_cast<float*>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(floatPtr + i) float(otherPtr[i]);
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::String: {
-					std::string* strPtr = static_cast<std::string*>(_mData);
-					std::string* otherPtr = static_cast<std::string*>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(strPtr + i) std::string(otherPtr[i]);
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::Vector: {
-					glm::vec4* vecPtr = static_cast<glm::vec4*>(_mData);
-					glm::vec4* otherPtr = static_cast<glm::vec4*>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(vecPtr + i) glm::vec4(otherPtr[i]);
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::Matrix: {
-					glm::mat4* matPtr = static_cast<glm::mat4*>(_mData);
-					glm::mat4* otherPtr = static_cast<glm::mat4*>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(matPtr + i) glm::mat4(otherPtr[i]);
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::Table: {
-					Scope** scopePtr = static_cast<Scope**>(_mData);
-					Scope** otherPtr = static_cast<Scope**>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(scopePtr + i) Scope*(otherPtr[i]);
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::Pointer: {
-					RTTI** rPtr = static_cast<RTTI**>(_mData);
-					RTTI** otherPtr = static_cast<RTTI**>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(rPtr + i) RTTI*(otherPtr[i]);
-					}
-					break;
-				}
-				}
+				Ops(_type).Copy(_mData, other._mData, _DatumSize);
+				CopyChars(other);
 			}
 		}
 	}
 
-	Datum::Datum(const Datum& other) : _DatumSize(other._DatumSize), _DatumCapacity(other._DatumCapacity), _type(other._type) {
-		if (other.externalStorage) {
-			externalStorage = true;
-			_mData = other._mData;
-		}
-		else {
-			if (_type != Unknown) {
-				// Allocate memory based on the other Datum's capacity
-				_mData = malloc(typeSizes[_type] * _DatumCapacity);
-				// Copies over content based on type
-				switch (_type)
-				{
-				case Fiea::GameEngine::Datum::Int: {
-					int* intPtr = static_cast<int*>(_mData);
-					int* otherPtr = static_cast<int*>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(intPtr + (typeSizes[_type] * i)) int(otherPtr[i]);
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::Float: {
-					float* floatPtr = static_cast<float*>(_mData);
-					float* otherPtr = static_cast<float*>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(floatPtr + (typeSizes[_type] * i)) float(otherPtr[i]);
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::String: {
-					std::string* strPtr = static_cast<std::string*>(_mData);
-					std::string* otherPtr = static_cast<std::string*>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(strPtr + (typeSizes[_type] * i)) std::string(otherPtr[i]);
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::Vector: {
-					glm::vec4* vecPtr = static_cast<glm::vec4*>(_mData);
-					glm::vec4* otherPtr = static_cast<glm::vec4*>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(vecPtr + (typeSizes[_type] * i)) glm::vec4(otherPtr[i]);
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::Matrix: {
-					glm::mat4* matPtr = static_cast<glm::mat4*>(_mData);
-					glm::mat4* otherPtr = static_cast<glm::mat4*>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(matPtr + (typeSizes[_type] * i)) glm::mat4(otherPtr[i]);
-					}
-				}
-				}
-			}
-		}
+	/** Owned
+	 * @brief Copies the elements into storage of the copy's own, whether this Datum owns its storage or views external one
+	 * @return the copy, sized to the elements
+	*/
+	Datum Datum::Owned() const {
+		Datum copy;
+		if (_type != Unknown) {
+			copy._type = _type;
+			copy._DatumCapacity = _DatumSize;
+			copy._mData = copy.AllocateStorage(_DatumSize);
+			Ops(_type).Copy(copy._mData, _mData, _DatumSize);
+			copy._DatumSize = _DatumSize;
+			copy.CopyChars(*this);
+		}
+		return copy;
 	}
 
 	/**
 	 * @brief Move Constructor
 	 * @param other: rvalue of Datum 
 	*/
-	Datum::Datum(Datum&& other) noexcept : _DatumSize(other._DatumSize), _DatumCapacity(other._DatumCapacity), _type(other._type), _mData(other._mData), externalStorage(other.externalStorage) {
-		other._mData = nullptr;
+	Datum::Datum(Datum&& other) noexcept : _DatumSize(other._DatumSize), _DatumCapacity(other._DatumCapacity), _type(other._type),
+		externalStorage(other.externalStorage), _resource(other._resource) {
+		StealStorage(other);
+		StealChars(other);
+		other._DatumCapacity = 0;
+		other._DatumSize = 0;
+		other._type = Unknown;
+		other.externalStorage = false;
+	};
+
+	/**
+	 * @brief Move constructor with an allocator, other's elements are moved into new storage when it uses another resource
+	 * @param allocator
+	 * @param other: rvalue of Datum
+	*/
+	Datum::Datum(std::allocator_arg_t, const allocator_type& allocator, Datum&& other) : _DatumSize(other._DatumSize), _DatumCapacity(other._DatumCapacity),
+		_type(other._type), externalStorage(other.externalStorage), _resource(ResourceOf(allocator)) {
+		StealStorage(other);
+		StealChars(other);
 		other._DatumCapacity = 0;
 		other._DatumSize = 0;
 		other._type = Unknown;
@@ -229,51 +437,10 @@ namespace Fiea::GameEngine {
 				_DatumSize = other._DatumSize;
 				_DatumCapacity = other._DatumCapacity;
 				// Allocate memory based on the other Datum's capacity
-				_mData = malloc(typeSizes[_type] * _DatumCapacity);
+				_mData = AllocateStorage(_DatumCapacity);
 				// Copies over content based on type
-				switch (_type)
-				{
-				case Fiea::GameEngine::Datum::Int: {
-					int* intPtr = static_cast<int*>(_mData);
-					int* otherPtr = static_cast<int*>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(intPtr + (typeSizes[_type] * i)) int(otherPtr[i]);
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::Float: {
-					float* floatPtr = static_cast<float*>(_mData);
-					float* otherPtr = static_cast<float*>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(floatPtr + (typeSizes[_type] * i)) float(otherPtr[i]);
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::String: {
-					std::string* strPtr = static_cast<std::string*>(_mData);
-					std::string* otherPtr = static_cast<std::string*>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(strPtr + (typeSizes[_type] * i)) std::string(otherPtr[i]);
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::Vector: {
-					glm::vec4* vecPtr = static_cast<glm::vec4*>(_mData);
-					glm::vec4* otherPtr = static_cast<glm::vec4*>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(vecPtr + (typeSizes[_type] * i)) glm::vec4(otherPtr[i]);
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::Matrix: {
-					glm::mat4* matPtr = static_cast<glm::mat4*>(_mData);
-					glm::mat4* otherPtr = static_cast<glm::mat4*>(other._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(matPtr + (typeSizes[_type] * i)) glm::mat4(otherPtr[i]);
-					}
-					break;
-				}
-				}
+				Ops(_type).Copy(_mData, other._mData, _DatumSize);
+				CopyChars(other);
 			}
 		}
 	}
@@ -287,10 +454,8 @@ namespace Fiea::GameEngine {
 	void Datum::operator=(int i) {
 		if (!externalStorage) {
 			if (_type == Unknown || _type == Int) {
-				if (_DatumSize > 0) {
-					free(_mData);
-				}
-				_mData = (int*)malloc(sizeof(int));
+				Release();
+				_mData = AllocateStorage(1);
 				new(_mData) int(i);
 				_DatumCapacity = 1;
 				_DatumSize = 1;
@@ -314,10 +479,8 @@ namespace Fiea::GameEngine {
 	void Datum::operator=(float f) {
 		if (!externalStorage) {
 			if (_type == Unknown || _type == Float) {
-				if (_DatumSize > 0) {
-					free(_mData);
-				}
-				_mData = (float*)malloc(sizeof(float));
+				Release();
+				_mData = AllocateStorage(1);
 				new(_mData) float(f);
 				_DatumCapacity = 1;
 				_DatumSize = 1;
@@ -341,14 +504,8 @@ namespace Fiea::GameEngine {
 	void Datum::operator=(std::string s) {
 		if (!externalStorage) {
 			if (_type == Unknown || _type == String) {
-				if (_DatumSize > 0) {
-					std::string* strPtr = static_cast<std::string*>(_mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						strPtr[i].~basic_string();
-					}
-					free(strPtr);
-				}
-				_mData = (std::string*)malloc(sizeof(std::string));
+				Release();
+				_mData = AllocateStorage(1);
 				new(_mData) std::string(s);
 				_DatumCapacity = 1;
 				_DatumSize = 1;
@@ -372,10 +529,8 @@ namespace Fiea::GameEngine {
 	void Datum::operator=(glm::vec4 v) {
 		if (!externalStorage) {
 			if (_type == Unknown || _type == Vector) {
-				if (_DatumSize > 0) {
-					free(_mData);
-				}
-				_mData = (glm::vec4*)malloc(sizeof(glm::vec4));
+				Release();
+				_mData = AllocateStorage(1);
 				new(_mData) glm::vec4(v);
 				_DatumCapacity = 1;
 				_DatumSize = 1;
@@ -399,10 +554,8 @@ namespace Fiea::GameEngine {
 	void Datum::operator=(glm::mat4 m) {
 		if (!externalStorage) {
 			if (_type == Unknown || _type == Matrix) {
-				if (_DatumSize > 0) {
-					free(_mData);
-				}
-				_mData = (glm::mat4*)malloc(sizeof(glm::mat4));
+				Release();
+				_mData = AllocateStorage(1);
 				new(_mData) glm::mat4(m);
 				_DatumCapacity = 1;
 				_DatumSize = 1;
@@ -426,30 +579,18 @@ namespace Fiea::GameEngine {
 		if (!externalStorage) {
 			if (_type == Unknown || _type == other._type) {
 				// If Datum contains items, clear it out
-				if (_DatumSize > 0) {
-					// Handle string proper disposal
-					if (_type == String) {
-						// Create string pointer to navigate string correctly
-						std::string* strPtr = static_cast<std::string*>(_mData);
-						for (size_t i = 0; i < _DatumSize; ++i) {
-								strPtr[i].~basic_string();
-						}
-						free(strPtr);
-					}
-					else {
-						free(_mData);
-					}
-				}
+				Release();
+				FreeChars();
 				// Move everything to current Datum
-				_mData = other._mData;
-				_DatumCapacity = other._DatumCapacity;
-				_DatumSize = other._DatumSize;
 				if (_type == Unknown) {
 					_type = other._type;
 				}
+				StealStorage(other);
+				StealChars(other);
+				_DatumCapacity = other._DatumCapacity;
+				_DatumSize = other._DatumSize;
 
 				// Empty out other
-				other._mData = nullptr;
 				other._DatumCapacity = 0;
 				other._DatumSize = 0;
 				other._type = Unknown;
@@ -459,219 +600,41 @@ namespace Fiea::GameEngine {
 
 	// Equality operator
 	bool Datum::operator==(Datum& rhs) {
-		if (_type == rhs._type) {
-			if (_DatumSize == rhs._DatumSize) {
-				switch (_type)
-				{
-				case Fiea::GameEngine::Datum::Unknown:
-					return true;
-				case Fiea::GameEngine::Datum::Int:
-				{
-					int* intPtr = static_cast<int*>(_mData);
-					int* otherintPtr = static_cast<int*>(rhs._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						if (intPtr[i] != otherintPtr[i]) {
-							return false;
-						}
-					}
-					return true;
-				}
-				case Fiea::GameEngine::Datum::Float:
-				{
-					float* floatPtr = static_cast<float*>(_mData);
-					float* otherfPtr = static_cast<float*>(rhs._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						if (floatPtr[i] != otherfPtr[i]) {
-							return false;
-						}
-					}
-					return true;
-				}
-				case Fiea::GameEngine::Datum::String:
-				{
-					std::string* strPtr = static_cast<std::string*>(_mData);
-					std::string* otherStrPtr = static_cast<std::string*>(rhs._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						if (strPtr[i] != otherStrPtr[i]) {
-							return false;
-						}
-					}
-					return true;
-				}
-				case Fiea::GameEngine::Datum::Vector:
-				{
-					glm::vec4* vecPtr = static_cast<glm::vec4*>(_mData);
-					glm::vec4* otherVecPtr = static_cast<glm::vec4*>(rhs._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						if (vecPtr[i] != otherVecPtr[i]) {
-							return false;
-						}
-					}
-					return true;
-				}
-				case Fiea::GameEngine::Datum::Matrix:
-				{
-					glm::mat4* matPtr = static_cast<glm::mat4*>(_mData);
-					glm::mat4* otherMatPtr = static_cast<glm::mat4*>(rhs._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						if (matPtr[i] != otherMatPtr[i]) {
-							return false;
-						}
-					}
-					return true;
-				}
-				case Fiea::GameEngine::Datum::Table:
-				{
-					Scope** scopePtr = static_cast<Scope**>(_mData);
-					Scope** otherScopePtr = static_cast<Scope**>(rhs._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						if (scopePtr[i] != otherScopePtr[i]) {
-							return false;
-						}
-					}
-					return true;
-				}
-				case Fiea::GameEngine::Datum::Pointer:
-					// Special thing for RTTI**
-					return false;
-				default:
-					throw std::invalid_argument("Invalid Datum Type");
-				}
-			}
-			else {
-				return false;
-			}
-		}
-		else {
-			return false;
-		}
+		return static_cast<const Datum&>(*this) == static_cast<const Datum&>(rhs);
 	}
 
 	// Equal Comparison operator
 	bool Datum::operator==(const Datum& rhs) const{
-		if (_type == rhs._type) {
-			if (_DatumSize == rhs._DatumSize) {
-				switch (_type)
-				{
-				case Fiea::GameEngine::Datum::Unknown:
-					return true;
-				case Fiea::GameEngine::Datum::Int:
-				{
-					int* intPtr = static_cast<int*>(_mData);
-					int* otherintPtr = static_cast<int*>(rhs._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						if (intPtr[i] != otherintPtr[i]) {
-							return false;
-						}
-					}
-					return true;
-				}
-				case Fiea::GameEngine::Datum::Float:
-				{
-					float* floatPtr = static_cast<float*>(_mData);
-					float* otherfPtr = static_cast<float*>(rhs._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						if (floatPtr[i] != otherfPtr[i]) {
-							return false;
-						}
-					}
-					return true;
-				}
-				case Fiea::GameEngine::Datum::String:
-				{
-					std::string* strPtr = static_cast<std::string*>(_mData);
-					std::string* otherStrPtr = static_cast<std::string*>(rhs._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						if (strPtr[i] != otherStrPtr[i]) {
-							return false;
-						}
-					}
-					return true;
-				}
-				case Fiea::GameEngine::Datum::Vector:
-				{
-					glm::vec4* vecPtr = static_cast<glm::vec4*>(_mData);
-					glm::vec4* otherVecPtr = static_cast<glm::vec4*>(rhs._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						if (vecPtr[i] != otherVecPtr[i]) {
-							return false;
-						}
-					}
-					return true;
-				}
-				case Fiea::GameEngine::Datum::Matrix:
-				{
-					glm::mat4* matPtr = static_cast<glm::mat4*>(_mData);
-					glm::mat4* otherMatPtr = static_cast<glm::mat4*>(rhs._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						if (matPtr[i] != otherMatPtr[i]) {
-							return false;
-						}
-					}
-					return true;
-				}
-				case Fiea::GameEngine::Datum::Table:
-				{
-					Scope** scopePtr = static_cast<Scope**>(_mData);
-					Scope** otherScopePtr = static_cast<Scope**>(rhs._mData);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						if (scopePtr[i] != otherScopePtr[i]) {
-							return false;
-						}
-					}
-					return true;
-				}
-				case Fiea::GameEngine::Datum::Pointer:
-					// Special thing for RTTI**
+		if (_type != rhs._type || _DatumSize != rhs._DatumSize) {
+			return false;
+		}
+		if (_type == PooledString) {
+			// Equal strings can sit at different offsets, compare the characters
+			for (size_t i = 0; i < _DatumSize; ++i) {
+				if (GetStringView(i) != rhs.GetStringView(i)) {
 					return false;
-				default:
-					throw std::invalid_argument("Invalid Datum Type");
 				}
 			}
-			else {
-				return false;
-			}
-		}
-		else {
-			return false;
+			return true;
 		}
+		return Ops(_type).Equal(_mData, rhs._mData, _DatumSize);
 	}
 
 	bool Datum::operator!=(Datum& rhs) {
 		return !operator==(rhs);
 	}
 
+	bool Datum::operator!=(const Datum& rhs) const {
+		return !operator==(rhs);
+	}
+
 
 	/** GetType
 	* @brief retruns a string with the type that the Datum contains
 	* @return string with Datum's contained type
 	*/
 	const std::string Datum::GetType() const{
-		std::string type;
-		switch (_type)
-		{
-		case Fiea::GameEngine::Datum::Unknown:
-			type = "Unknown";
-			break;
-		case Fiea::GameEngine::Datum::Int:
-			type = "Int";
-			break;
-		case Fiea::GameEngine::Datum::Float:
-			type = "Float";
-			break;
-		case Fiea::GameEngine::Datum::String:
-			type = "String";
-			break;
-		case Fiea::GameEngine::Datum::Vector:
-			type = "Vector";
-			break;
-		case Fiea::GameEngine::Datum::Matrix:
-			type = "Matrix";
-			break;
-		default:
-			break;
-		}
-		return type;
+		return Ops(_type).Name;
 	};
 
 
@@ -684,6 +647,10 @@ namespace Fiea::GameEngine {
 		return (_type == type);
 	}
 
+	bool Datum::CheckType(DatumType type) const{
+		return (_type == type);
+	}
+
 	// Empty
 
 	/**
@@ -712,6 +679,7 @@ namespace Fiea::GameEngine {
 				throw std::out_of_range("index out of range");
 			}
 			else {
+				Detach();
 				int* intPtr = static_cast<int*>(_mData);
 				return intPtr[idx];
 			}
@@ -748,6 +716,7 @@ namespace Fiea::GameEngine {
 				throw std::out_of_range("index out of range");
 			}
 			else {
+				Detach();
 				float* floatPtr = static_cast<float*>(_mData);
 				return floatPtr[idx];
 			}
@@ -784,6 +753,7 @@ namespace Fiea::GameEngine {
 				throw std::out_of_range("index out of range");
 			}
 			else {
+				Detach();
 				std::string* strPtr = static_cast<std::string*>(_mData);
 				return strPtr[idx];
 			}
@@ -820,6 +790,7 @@ namespace Fiea::GameEngine {
 				throw std::out_of_range("index out of range");
 			}
 			else {
+				Detach();
 				glm::vec4* vecPtr = static_cast<glm::vec4*>(_mData);
 				return vecPtr[idx];
 			}
@@ -856,6 +827,7 @@ namespace Fiea::GameEngine {
 				throw std::out_of_range("index out of range");
 			}
 			else {
+				Detach();
 				glm::mat4* matPtr = static_cast<glm::mat4*>(_mData);
 				return matPtr[idx];
 			}
@@ -941,63 +913,70 @@ namespace Fiea::GameEngine {
 		}
 	}
 
-	/** Pop
-	 * @brief Removes the very last element of the Datum
+	/** GetStringView
+	 * @brief Views the string at index idx of a PooledString or String Datum
+	 * @param idx: size_t index
+	 * @return std::string_view: valid until the Datum's strings are next changed
 	*/
-	void Datum::Pop() {
-		if (!externalStorage) {
-			// Check if _DatumSize is more than 0
-			if (!Empty()) {
-				// Remove the last element of Datum
-				switch (_type)
-				{
-				case Fiea::GameEngine::Datum::Int:
-				{
-					// get an Int pointer version of _mData
-					int* intPtr = static_cast<int*>(_mData);
-					intPtr[_DatumSize - 1] = NULL;
-					--_DatumSize;
-					break;
-				}
-				case Fiea::GameEngine::Datum::Float:
-				{
-					// get an Float pointer version of _mData
-					float* fPtr = static_cast<float*>(_mData);
-					fPtr[_DatumSize - 1] = NULL;
-					--_DatumSize;
-					break;
-				}
-				case Fiea::GameEngine::Datum::String:
-				{
-					// get an String pointer version of _mData
-					std::string* strPtr = static_cast<std::string*>(_mData);
-					(strPtr + (_DatumSize - 1))->~basic_string();
-					--_DatumSize;
-					break;
-				}
-				case Fiea::GameEngine::Datum::Vector:
-				{
-					// get an Vector pointer version of _mData
-					glm::vec4* vecPtr = static_cast<glm::vec4*>(_mData);
-					vecPtr[_DatumSize - 1] = glm::vec4(0.0f);
-					--_DatumSize;
-					break;
-				}
-				case Fiea::GameEngine::Datum::Matrix:
-				{
-					// get an Vector pointer version of _mData
-					glm::mat4* matPtr = static_cast<glm::mat4*>(_mData);
-					matPtr[_DatumSize - 1] = glm::mat4(0.0f);
-					--_DatumSize;
-					break;
-				}
-				case Fiea::GameEngine::Datum::Table:
-					break;
-				case Fiea::GameEngine::Datum::Pointer:
-					break;
-				default:
-					break;
+	std::string_view Datum::GetStringView(size_t idx) const {
+		if (_type == String) {
+			return GetString(idx);
+		}
+		if (_type != PooledString) {
+			throw std::runtime_error("Datum is either uninitialized or not of type: PooledString");
+		}
+		if (idx >= _DatumSize) { //Checks idx/index is within range
+			throw std::out_of_range("index out of range");
+		}
+		const PooledEntry& entry = static_cast<const PooledEntry*>(_mData)[idx];
+		return std::string_view(PoolChars() + entry.Offset, entry.Length);
+	}
+
+	/** Push
+	 * @brief Adds a copy of value's characters at the end of a PooledString Datum, an Unknown Datum becomes a
+	 * PooledString one and String Datums push a std::string
+	 * @param value
+	*/
+	void Datum::Push(std::string_view value) {
+		if (externalStorage) {
+			throw std::runtime_error("Can't manipulate external storage");
+		}
+		if (_type == Unknown) {
+			SetType(value);
+		}
+		if (_type == String) {
+			Push(std::string(value));
+			return;
+		}
+		if (!CheckType(value)) {
+			throw std::runtime_error("Value entered does not match with Datum's current type");
+		}
+		PooledEntry entry = StoreChars(value);
+		if (_DatumSize == _DatumCapacity) {
+			Reallocate((_DatumCapacity * 2) + 1);
+		}
+		static_cast<PooledEntry*>(_mData)[_DatumSize] = entry;
+		_DatumSize++;
+	}
+
+	/** Pop
+	 * @brief Removes the very last element of the Datum
+	*/
+	void Datum::Pop() {
+		if (!externalStorage) {
+			// Check if _DatumSize is more than 0
+			if (!Empty()) {
+				Detach();
+				if (_type == PooledString && _chars != nullptr) {
+					// The last string's characters are usually the last ones in the pool, hand them back
+					const PooledEntry& last = static_cast<PooledEntry*>(_mData)[_DatumSize - 1];
+					if (last.Offset + last.Length == _chars->Size) {
+						_chars->Size = last.Offset;
+					}
 				}
+				// Remove the last element of Datum
+				Ops(_type).Destroy(static_cast<char*>(_mData) + typeSizes[_type] * (_DatumSize - 1), 1);
+				--_DatumSize;
 			}
 			else {
 				throw std::out_of_range("Trying to Pop from an empty Datum");
@@ -1010,195 +989,59 @@ namespace Fiea::GameEngine {
 
 
 	/**
-	 * @brief SetFromString sets an element in Datum at index (index) with the value represented with the string s
+	 * @brief SetFromString sets an element in Datum at index (index) with the value represented with the string s,
+	 * or pushes it when index is the Datum's size
 	 * @param index 
 	 * @param s 
 	*/
 	void Datum::SetFromString(size_t idx, std::string s) {
 		// Verify index is not out of bounds
-		if(idx < _DatumSize){
-			if (_type == Unknown) {
-				// Identify type
-				if (s.substr(0, 4) == "Vec4" || s.substr(0, 4) == "vec4") {
-					_type = Vector;
-				}
-				if (s.substr(0, 4) == "Mat4" || s.substr(0, 4) == "mat4") {
-					_type = Matrix;
-				}
-				// Check if int by checking if all the chars in s are digits
-				bool isInt = true;
-				for (char c : s) {
-					if (!std::isdigit(c)) {
-						isInt = false;
-					}
-				}
-				if (isInt) {
-					_type = Int;
-				}
-
-				// Check for float
-				if (std::regex_match(s, std::regex("[0-9]+\\.[0-9]+[f]?"))) {
-					_type = Float;
-				}
-
-				// If none then string
-				if (_type == Unknown) {
-					_type = String;
-				}
-			}
-			switch (_type)
-			{
-			case Fiea::GameEngine::Datum::Int:{
-				if (std::regex_match(s, std::regex("[0-9]*"))) {
-					int value = std::stoi(s);
-					Set(idx, value);
-				}
-				else {
-					throw std::runtime_error("Invalid string entered");
-				}
-				break;
-			}
-			case Fiea::GameEngine::Datum::Float:{
-				if (std::regex_match(s, std::regex("[0-9]+\\.[0-9]+[f]?"))) {
-					float f = stof(s);
-					Set(idx, f);
-				}
-				else {
-					throw std::runtime_error("Invalid string entered");
-				}
-				break;
-			}
-			case Fiea::GameEngine::Datum::String:
-			{
-				// Can't throw exception since 
-				Set(idx, s);
-				break;
-			}
-			case Fiea::GameEngine::Datum::Vector:
-			{
-				float vec1, vec2, vec3, vec4;
-				if (sscanf_s(s.c_str(), "Vec4(%f, %f, %f, %f)", &vec1, &vec2, &vec3, &vec4) == 4 || sscanf_s(s.c_str(), "vec4(%f, %f, %f, %f)", &vec1, &vec2, &vec3, &vec4) == 4) {
-					// Parse the string
-					glm::vec4 vec(vec1, vec2, vec3, vec4);
-					Set(idx, vec);
-				}
-				else {
-					throw std::runtime_error("Invalid string entered");
-				}
-				break;
-			}
-			case Fiea::GameEngine::Datum::Matrix: 
-			{
-				float mat1, mat2, mat3, mat4, mat5, mat6, mat7, mat8, mat9, mat10, mat11, mat12, mat13, mat14, mat15, mat16;
-				if (sscanf_s(s.c_str(), "Mat4((%f, %f, %f, %f), (%f, %f, %f, %f), (%f, %f, %f, %f), (%f, %f, %f, %f))", &mat1, &mat2, &mat3, &mat4, &mat5, &mat6, &mat7, &mat8, &mat9, &mat10, &mat11, &mat12, &mat13, &mat14, &mat15, &mat16) == 16 || sscanf_s(s.c_str(), "mat4((%f, %f, %f, %f), (%f, %f, %f, %f), (%f, %f, %f, %f), (%f, %f, %f, %f))", &mat1, &mat2, &mat3, &mat4, &mat5, &mat6, &mat7, &mat8, &mat9, &mat10, &mat11, &mat12, &mat13, &mat14, &mat15, &mat16) == 16) {
-					// Parse the string
-					glm::mat4 mat(mat1, mat2, mat3, mat4, mat5, mat6, mat7, mat8, mat9, mat10, mat11, mat12, mat13, mat14, mat15, mat16);
+		if (idx > _DatumSize) {
+			return;
+		}
+		if (_type == Unknown) {
+			// Identify type
+			_type = DeduceType(s);
+		}
+		const TypeOps& ops = Ops(_type);
+		if (ops.FromString != nullptr) {
+			ops.FromString(*this, idx, s);
+		}
+	}
 
-					Set(idx, mat);
-				}
-				else { throw std::runtime_error("Invalid string entered"); }
-				break;
-			}
-			case Fiea::GameEngine::Datum::Table:
-				break;
-			case Fiea::GameEngine::Datum::Pointer:
-				break;
-			default:
-				break;
+	/** SetString
+	 * @brief Sets the string at index idx of a PooledString or String Datum, or pushes it into an empty Datum.
+	 * Pooled strings that don't grow are overwritten in place, longer ones are stored at the end of the pool.
+	 * @param idx
+	 * @param value
+	*/
+	void Datum::SetString(size_t idx, std::string_view value) {
+		if (_DatumSize == 0 && idx == 0) {
+			Push(value);
+			return;
+		}
+		if (_type == String) {
+			GetString(idx) = value;
+			return;
+		}
+		if (_type != PooledString) {
+			throw std::runtime_error("valueRef was not of a supported type");
+		}
+		if (idx >= _DatumSize) {
+			throw std::out_of_range("Index entered is out of Datum's range");
+		}
+		PooledEntry& entry = static_cast<PooledEntry*>(_mData)[idx];
+		if (value.size() <= entry.Length) {
+			// value may point into the pool itself, memmove handles the overlap
+			if (!value.empty()) {
+				memmove(PoolChars() + entry.Offset, value.data(), value.size());
 			}
+			entry.Length = static_cast<std::uint32_t>(value.size());
 		}
 		else {
-			if (_DatumSize == idx) {
-				if (_type == Unknown) {
-					// Identify type
-					if (s.substr(0, 4) == "Vec4" || s.substr(0, 4) == "vec4") {
-						_type = Vector;
-					}
-					if (s.substr(0, 4) == "Mat4" || s.substr(0, 4) == "mat4") {
-						_type = Matrix;
-					}
-					// Check if int by checking if all the chars in s are digits
-					bool isInt = true;
-					for (char c : s) {
-						if (!std::isdigit(c)) {
-							isInt = false;
-							break;
-						}
-					}
-					if (isInt) {
-						_type = Int;
-					}
-
-					// Check for float
-					if (std::regex_match(s, std::regex("[0-9]+\\.[0-9]+[f]?"))) {
-						_type = Float;
-					}
-
-					// If none then string
-					if (_type == Unknown) {
-						_type = String;
-					}
-				}
-				switch (_type)
-				{
-				case Fiea::GameEngine::Datum::Int: {
-					if (std::regex_match(s, std::regex("[0-9]*"))) {
-						int value = std::stoi(s);
-						Push(value);
-					}
-					else {
-						throw std::runtime_error("Invalid string entered");
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::Float: {
-					if (std::regex_match(s, std::regex("[0-9]+\\.[0-9]+[f]?"))) {
-						float f = stof(s);
-						Push(f);
-					}
-					else {
-						throw std::runtime_error("Invalid string entered");
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::String:
-				{
-					// Can't throw exception since 
-					Push(s);
-					break;
-				}
-				case Fiea::GameEngine::Datum::Vector:
-				{
-					float vec1, vec2, vec3, vec4;
-					if (sscanf_s(s.c_str(), "Vec4(%f, %f, %f, %f)", &vec1, &vec2, &vec3, &vec4) == 4 || sscanf_s(s.c_str(), "vec4(%f, %f, %f, %f)", &vec1, &vec2, &vec3, &vec4) == 4) {
-						// Parse the string
-						glm::vec4 vec(vec1, vec2, vec3, vec4);
-						Push(vec);
-					}
-					else {
-						throw std::runtime_error("Invalid string entered");
-					}
-					break;
-				}
-				case Fiea::GameEngine::Datum::Matrix:
-				{
-					float mat1, mat2, mat3, mat4, mat5, mat6, mat7, mat8, mat9, mat10, mat11, mat12, mat13, mat14, mat15, mat16;
-					if (sscanf_s(s.c_str(), "Mat4((%f, %f, %f, %f), (%f, %f, %f, %f), (%f, %f, %f, %f), (%f, %f, %f, %f))", &mat1, &mat2, &mat3, &mat4, &mat5, &mat6, &mat7, &mat8, &mat9, &mat10, &mat11, &mat12, &mat13, &mat14, &mat15, &mat16) == 16 || sscanf_s(s.c_str(), "mat4((%f, %f, %f, %f), (%f, %f, %f, %f), (%f, %f, %f, %f), (%f, %f, %f, %f))", &mat1, &mat2, &mat3, &mat4, &mat5, &mat6, &mat7, &mat8, &mat9, &mat10, &mat11, &mat12, &mat13, &mat14, &mat15, &mat16) == 16) {
-						// Parse the string
-						glm::mat4 mat(mat1, mat2, mat3, mat4, mat5, mat6, mat7, mat8, mat9, mat10, mat11, mat12, mat13, mat14, mat15, mat16);
-						Push(mat);
-					}
-					else { throw std::runtime_error("Invalid string entered"); }
-					break;
-				}
-				case Fiea::GameEngine::Datum::Table:
-					break;
-				case Fiea::GameEngine::Datum::Pointer:
-					break;
-				default:
-					break;
-				}
-			}
+			// The old characters stay behind until the pool next grows
+			PooledEntry stored = StoreChars(value);
+			static_cast<PooledEntry*>(_mData)[idx] = stored;
 		}
 	}
 
@@ -1211,33 +1054,14 @@ namespace Fiea::GameEngine {
 		// Throw exception if idx is out of Datum's range
 		if (idx >= _DatumSize) 
 			throw std::out_of_range("idx is out of range");
-		else {
-			switch (_type)
-			{
-			case Fiea::GameEngine::Datum::Int: {
-				int ivalue = Get<int>(idx);
-				return std::to_string(ivalue);
-			}
-			case Fiea::GameEngine::Datum::Float: {
-				float fvalue = Get<float>(idx);
-				return std::to_string(fvalue);
-			}
-			case Fiea::GameEngine::Datum::String: {
-				return Get<std::string>(idx);
-			}
-			case Fiea::GameEngine::Datum::Vector: {
-				glm::vec4 v = Get<glm::vec4>(idx);
-				return glm::to_string(v);
-			}
-			case Fiea::GameEngine::Datum::Matrix: {
-				glm::mat4 m = Get<glm::mat4>(idx);
-				return glm::to_string(m);
-			}
-			default:
-				// This line will never be reached
-				throw std::runtime_error("_type is Unkown");
-			}
+		if (_type == PooledString) {
+			return std::string(GetStringView(idx));
+		}
+		const TypeOps& ops = Ops(_type);
+		if (ops.ToString == nullptr) {
+			throw std::runtime_error("_type has no string representation");
 		}
+		return ops.ToString(_mData, idx);
 	};
 
 	/**
@@ -1246,57 +1070,14 @@ namespace Fiea::GameEngine {
 	void Datum::Clear() {
 		// Checks if there is anything to clear
 		if (!Empty()) {
-			// Iterate over Datum and destruct/remove any populated items
-			switch (_type)
-			{
-			case Fiea::GameEngine::Datum::Int: {
-				// Create int pointer for easier navigation
-				int* intPtr = static_cast<int*>(_mData);
-				// Set all elements to Null
-				for (size_t i = 0; i < _DatumSize; ++i) {
-					intPtr[i] = NULL;
-				}
-				break;
-			}
-			case Fiea::GameEngine::Datum::Float: {
-				// Create float pointer
-				float* fPtr = static_cast<float*>(_mData);
-				// Set each populated element to null
-				for (size_t i = 0; i < _DatumSize; ++i) {
-					fPtr[i] = NULL;
-				}
-				break;
-			}
-			case Fiea::GameEngine::Datum::String: {
-				// Create string pointer
-				std::string* strPtr = static_cast<std::string*>(_mData);
-				// Destruct strings
-				for (size_t i = 0; i < _DatumSize; ++i) {
-					(strPtr + i)->~basic_string();
-				}
-				break;
-			}
-			case Fiea::GameEngine::Datum::Vector: {
-				// Create glm::vec4 pointer
-				glm::vec4* vecPtr = static_cast<glm::vec4*>(_mData);
-				// Set populated vectors to NULL
-				for (size_t i = 0; i < _DatumSize; ++i) {
-					vecPtr[i] = NULLVEC;
-				}
-				break;
-			}
-			case Fiea::GameEngine::Datum::Matrix: {
-				// Create glm::mat4 pointer
-				glm::mat4* matPtr = static_cast<glm::mat4*>(_mData);
-				// Set populated Matrices to NULL
-				for (size_t i = 0; i < _DatumSize; ++i) {
-					matPtr[i] = NULLMAT;
-				}
-				break;
-			}
-			}
+			Detach();
+			// Destruct any populated items
+			Ops(_type).Destroy(_mData, _DatumSize);
 			// Set size to 0
 			_DatumSize = 0;
+			if (_chars != nullptr) {
+				_chars->Size = 0;
+			}
 		}
 	};
 
@@ -1306,224 +1087,433 @@ namespace Fiea::GameEngine {
 	 * @param newSize 
 	*/
 	void Datum::Resize(size_t newSize) {
-		if (newSize < _DatumSize) {
-			// Allocate memory equal to newSize
-			switch (_type)
-			{
-			case Fiea::GameEngine::Datum::Int: {
-				//Move current data in Datum up to newSize to new _mData
-				int* intPtr = static_cast<int*>(_mData);
-				int* newData = (int*)malloc(sizeof(int) * newSize);
-				for (size_t i = 0; i < newSize; ++i) {
-					new(newData + i) int(intPtr[i]);
-				}
-				// Free Up old data
-				free(_mData);
-				// Transfer data to a new _mData
-				_mData = newData;
-				// Set Size to newSize
-				_DatumSize = newSize;
-				break;
-			}
-			case Fiea::GameEngine::Datum::Float: {
-				//Move current data in Datum up to newSize to new _mData
-				float* floatPtr = static_cast<float*>(_mData);
-				float* newData = (float*)malloc(typeSizes[_type] * newSize);
-				for (size_t i = 0; i < newSize; ++i) {
-					new(newData + i) float(floatPtr[i]);
-				}
-				// Free Up old data
-				free(_mData);
-				// Transfer data to a new _mData
-				_mData = newData;
-				// Set Size to newSize
-				_DatumSize = newSize;
-				break;
-			}
-			case Fiea::GameEngine::Datum::String: {
-				// Create pointers for better navigation
-				std::string* strPtr = static_cast<std::string*>(_mData);
-				std::string* newData = (std::string*)malloc(typeSizes[_type] * newSize);
-				// Copy over data
-				for (size_t i = 0; i < newSize; ++i) {
-					new(newData + i) std::string(strPtr[i]);
-				}
-				// Destroy strings in _mData
-				for (size_t j = 0; j < _DatumSize; ++j) {
-					strPtr[j].~basic_string();
-				}
-				free(_mData);
-				_mData = newData;
-				_DatumSize = newSize;
-				break;
+		if (_type == Unknown) {
+			throw std::runtime_error("Can't Resize empty Datum");
+		}
+		Detach();
+		// Shrinking to the current size reallocates too, the capacity always describes the storage actually held
+		if (newSize != _DatumCapacity) {
+			if (_type == Pointer) {
+				throw std::runtime_error("_type is unsupported");
 			}
-			case Fiea::GameEngine::Datum::Vector: {
-				//Move current data in Datum up to newSize to new _mData
-				glm::vec4* vecPtr = static_cast<glm::vec4*>(_mData);
-				glm::vec4* newData = (glm::vec4*)malloc(typeSizes[_type] * newSize);
-				for (size_t i = 0; i < newSize; ++i) {
-					new(newData + i) glm::vec4(vecPtr[i]);
+			// Moves the elements that still fit, inline or on the heap depending on newSize
+			Reallocate(newSize);
+			if (_type == Table) {
+				// Tables grow to newSize with empty Scope*s
+				Scope** scopePtr = static_cast<Scope**>(_mData);
+				for (size_t j = _DatumSize; j < newSize; ++j) {
+					scopePtr[j] = nullptr;
 				}
-				// Free Up old data
-				free(_mData);
-				// Transfer data to a new _mData
-				_mData = newData;
-				// Set Size to newSize
 				_DatumSize = newSize;
-				break;
 			}
-			case Fiea::GameEngine::Datum::Matrix: {
-				//Move current data in Datum up to newSize to new _mData
-				glm::mat4* matPtr = static_cast<glm::mat4*>(_mData);
-				glm::mat4* newData = (glm::mat4*)malloc(typeSizes[_type] * newSize);
-				for (size_t i = 0; i < newSize; ++i) {
-					new(newData + i) glm::mat4(matPtr[i]);
-				}
-				// Free Up old data
-				free(_mData);
-				// Transfer data to a new _mData
-				_mData = newData;
-				// Set Size to newSize
-				_DatumSize = newSize;
-				break;
+		}
+		_DatumCapacity = newSize;
+	};
+
+	/** Reserve
+	 * @brief Makes room for capacity elements without changing the size, never shrinks the Datum
+	 * @param capacity
+	*/
+	void Datum::Reserve(size_t capacity) {
+		if (externalStorage) {
+			throw std::runtime_error("Can't manipulate external storage");
+		}
+		if (_type == Unknown) {
+			throw std::runtime_error("Can't Reserve empty Datum");
+		}
+		if (capacity > _DatumCapacity) {
+			Detach();
+			Reallocate(capacity);
+		}
+	}
+
+	/** AllocateStorage
+	 * @brief Picks memory for capacity elements of the current type, the inline buffer when they fit and the heap
+	 * otherwise. The previous storage must already be released or moved out of.
+	 * @param capacity : number of elements
+	 * @return pointer to uninitialized storage
+	*/
+	void* Datum::AllocateStorage(size_t capacity) {
+		size_t bytes = typeSizes[_type] * capacity;
+		if (bytes <= InlineBytes) {
+			return _inline;
+		}
+		if (_resource != nullptr) {
+			return _resource->allocate(bytes, alignof(std::max_align_t));
+		}
+		void* data = malloc(bytes);
+		if (data == nullptr) {
+			throw std::bad_alloc();
+		}
+		return data;
+	}
+
+	/** FreeStorage
+	 * @brief Releases heap storage, the inline buffer needs no freeing. Elements must already be destroyed and
+	 * _type and _DatumCapacity still describe the storage, resources are told the size they handed out.
+	*/
+	void Datum::FreeStorage() {
+		if (_mData != nullptr && !IsInline()) {
+			if (_resource != nullptr) {
+				_resource->deallocate(_mData, typeSizes[_type] * _DatumCapacity, alignof(std::max_align_t));
 			}
-			case Fiea::GameEngine::Datum::Table: {
-				Scope** scopePtr = static_cast<Scope**>(_mData);
-				Scope** newPtr = (Scope**)malloc(typeSizes[_type] * newSize);
-				for (size_t i = 0; i < newSize; ++i) {
-					new(newPtr + i) Scope*(scopePtr[i]);
-				}
-				// Free Up old data
+			else {
 				free(_mData);
-				// Transfer data to a new _mData
-				_mData = newPtr;
-				// Set Size to newSize
-				_DatumSize = newSize;
-				break;
-			}
-			default:
-				throw std::runtime_error("_type is unsupported");
 			}
 		}
-		else if (newSize > _DatumSize) {
-			if(newSize != _DatumCapacity) {
-				// Allocate memory equal to newSize
-				switch (_type)
-				{
-				case Fiea::GameEngine::Datum::Int: {
-					//Move current data in Datum up to newSize to new _mData
-					int* intPtr = static_cast<int*>(_mData);
-					int* newData = (int*)malloc(typeSizes[_type] * newSize);
-					// Move already populated items
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(newData + i) int(intPtr[i]);
-					}
-					// Default construct the rest
-					for (size_t j = _DatumSize; j < newSize; ++j) {
-						newData[j] = NULL;
-					}
-					// Free Up old data
-					free(_mData);
-					// Transfer data to a new _mData
-					_mData = newData;
-					
-					break;
-				}
-				case Fiea::GameEngine::Datum::Float: {
-					//Move current data in Datum up to newSize to new _mData
-					float* floatPtr = static_cast<float*>(_mData);
-					float* newData = (float*)malloc(typeSizes[_type] * newSize);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(newData + i) float(floatPtr[i]);
-					}
-					// Default construct the rest
-					for (size_t j = _DatumSize; j < newSize; ++j) {
-						newData[j] = NULL;
-					}
-					// Free Up old data
-					free(_mData);
-					// Transfer data to a new _mData
-					_mData = newData;
-					break;
-				}
-				case Fiea::GameEngine::Datum::String: {
-					// Create pointers for better navigation
-					std::string* strPtr = static_cast<std::string*>(_mData);
-					std::string* newData = (std::string*)malloc(typeSizes[_type] * newSize);
-					// Copy over data
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(newData + i) std::string(strPtr[i]);
-					}
-					// Destruct strPtr's elements
-					for (size_t j = 0; j < _DatumSize; ++j) {
-						strPtr[j].~basic_string();
-					}
-					free(_mData);
-					_mData = newData;
-					break;
-				}
-				case Fiea::GameEngine::Datum::Vector: {
-					//Move current data in Datum up to newSize to new _mData
-					glm::vec4* vecPtr = static_cast<glm::vec4*>(_mData);
-					glm::vec4* newData = (glm::vec4*)malloc(typeSizes[_type] * newSize);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(newData + i) glm::vec4(vecPtr[i]);
-					}
-					// Default construct vectors for the rest
-					for (size_t j = _DatumSize; j < newSize; ++j) {
-						newData[j] = glm::vec4();
-					}
-					// Free Up old data
-					free(_mData);
-					// Transfer data to a new _mData
-					_mData = newData;
-					break;
-				}
-				case Fiea::GameEngine::Datum::Matrix: {
-					//Move current data in Datum up to newSize to new _mData
-					glm::mat4* matPtr = static_cast<glm::mat4*>(_mData);
-					glm::mat4* newData = (glm::mat4*)malloc(typeSizes[_type] * newSize);
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(newData + i) glm::mat4(matPtr[i]);
-					}
-					// Default construct vectors for the rest
-					for (size_t j = _DatumSize; j < newSize; ++j) {
-						newData[j] = glm::mat4();
-					}
-					// Free Up old data
-					free(_mData);
-					// Transfer data to a new _mData
-					_mData = newData;
-					break;
-				}
-				case Fiea::GameEngine::Datum::Table: {
-					Scope** scopePtr = static_cast<Scope**>(_mData);
-					Scope** newPtr = (Scope**)malloc(typeSizes[_type] * newSize);
-					for (size_t i = 0; i < newSize; ++i) {
-						new(newPtr + i) Scope* (scopePtr[i]);
-					}
-					// Default construct the Scope*s
-					for (size_t j = _DatumSize; j < newSize; ++j) {
-						newPtr[j] = nullptr;
-					}
-					// Free Up old data
-					free(_mData);
-					// Transfer data to a new _mData
-					_mData = newPtr;
-					// Set Size to newSize
-					_DatumSize = newSize;
-					break;
-				}
-				default:
-					throw std::runtime_error("_type is unsupported");
-				}
+		_mData = nullptr;
+	}
+
+	/** Reallocate
+	 * @brief Moves the elements into storage for newCapacity elements, dropping the ones past newCapacity.
+	 * Stays in the inline buffer when the elements already live there and still fit. Trivially copyable types
+	 * grow on the heap with realloc, which can extend the block in place.
+	 * @param newCapacity
+	*/
+	void Datum::Reallocate(size_t newCapacity) {
+		if (_type == Unknown) {
+			throw std::runtime_error("_type is unsupported");
+		}
+		const TypeOps& ops = Ops(_type);
+		const size_t elementSize = typeSizes[_type];
+		size_t count = std::min(_DatumSize, newCapacity);
+		ops.Destroy(static_cast<char*>(_mData) + elementSize * count, _DatumSize - count);
+		_DatumSize = count;
+
+		bool fitsInline = elementSize * newCapacity <= InlineBytes;
+		if (IsInline() && fitsInline) {
+			_DatumCapacity = newCapacity;
+			return;
+		}
+		if (ops.TriviallyCopyable && !fitsInline && _mData != nullptr && !IsInline() && _resource == nullptr) {
+			void* grown = realloc(_mData, elementSize * newCapacity);
+			if (grown == nullptr) {
+				throw std::bad_alloc();
+			}
+			_mData = grown;
+			_DatumCapacity = newCapacity;
+			return;
+		}
+		void* newData = AllocateStorage(newCapacity);
+		ops.Relocate(newData, _mData, count);
+		FreeStorage();
+		_mData = newData;
+		_DatumCapacity = newCapacity;
+	}
+
+	/** StealStorage
+	 * @brief Takes other's elements, relocating them out of other's inline buffer, or out of other's resource when this
+	 * Datum allocates from a different one. _type must already be set. Sizes are left to the caller.
+	 * @param other : Datum whose storage is taken, left without storage
+	*/
+	void Datum::StealStorage(Datum& other) {
+		if (other.IsInline()) {
+			_mData = _inline;
+			Ops(other._type).Relocate(_inline, other._inline, other._DatumSize);
+		}
+		else if (other.externalStorage || other._mData == nullptr || other._resource == _resource || other._shared) {
+			// Shared blocks remember their own resource
+			_mData = other._mData;
+		}
+		else {
+			_mData = AllocateStorage(other._DatumCapacity);
+			Ops(other._type).Relocate(_mData, other._mData, other._DatumSize);
+			other.FreeStorage();
+		}
+		_shared = other._shared;
+		other._shared = false;
+		other._mData = nullptr;
+		// The snapshot holds copies of the elements, wherever they went
+		_snapshot = other._snapshot;
+		other._snapshot = nullptr;
+	}
+
+	/** Release
+	 * @brief Destroys the elements and frees their storage, or only drops this Datum's reference when they are shared
+	*/
+	void Datum::Release() {
+		if (_snapshot != nullptr) {
+			DropSnapshot();
+		}
+		if (_shared) {
+			ReleaseShared();
+		}
+		else {
+			Ops(_type).Destroy(_mData, _DatumSize);
+			FreeStorage();
+		}
+	}
+
+	/** Share
+	 * @brief Makes this empty Datum refer to source's elements instead of copying them. The first time source is
+	 * shared its elements are copied into a reference counted SharedBlock that source keeps for the next Datums
+	 * sharing them, and whichever Datum changes them first gets its own copy (see Detach). Source's own storage never
+	 * moves, so references and spans into it stay valid; its next mutable access lets go of the block. Elements that
+	 * fit inline and PooledStrings are cheaper to copy, external storage is referenced like the copy constructor
+	 * does. Tables can't be shared, every Scope has a single owner, so Scope::CloneShared clones them instead.
+	 * @param source : keeps its values and their storage
+	*/
+	void Datum::Share(const Datum& source) {
+		if (source._type == Table) {
+			throw std::invalid_argument("Table Datums can't be shared");
+		}
+		if (source.externalStorage || source._type == Unknown || source._type == PooledString || source._DatumSize == 0 || source.IsInline()) {
+			operator=(source);
+			return;
+		}
+		SharedBlock* block = nullptr;
+		if (source._shared) {
+			block = source.Block();
+		}
+		else {
+			// Only the cached block changes, source's elements stay where they are
+			Datum& from = const_cast<Datum&>(source);
+			if (from._snapshot == nullptr) {
+				from._snapshot = from.MakeSnapshot();
+			}
+			block = from._snapshot;
+		}
+		block->Refs.fetch_add(1, std::memory_order_relaxed);
+		_type = source._type;
+		_DatumSize = source._DatumSize;
+		_DatumCapacity = block->Capacity;
+		_mData = block + 1;
+		_shared = true;
+	}
+
+	/** MakeSnapshot
+	 * @brief Copies the elements into a new SharedBlock, referenced once for this Datum's _snapshot
+	 * @return the block
+	*/
+	Datum::SharedBlock* Datum::MakeSnapshot() const {
+		const size_t bytes = sizeof(SharedBlock) + typeSizes[_type] * _DatumSize;
+		void* memory = _resource != nullptr ? _resource->allocate(bytes, alignof(SharedBlock)) : malloc(bytes);
+		if (memory == nullptr) {
+			throw std::bad_alloc();
+		}
+		SharedBlock* block = new(memory) SharedBlock{ 1, _resource, _DatumSize };
+		try {
+			Ops(_type).Copy(block + 1, _mData, _DatumSize);
+		}
+		catch (...) {
+			FreeBlock(block);
+			throw;
+		}
+		return block;
+	}
+
+	/** DropSnapshot
+	 * @brief Lets go of the block made for sharing this Datum's elements, before they change or go away. Datums still
+	 * sharing it keep it alive.
+	*/
+	void Datum::DropSnapshot() {
+		SharedBlock* block = _snapshot;
+		_snapshot = nullptr;
+		if (block->Refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			// A snapshot holds as many elements as it has room for
+			Ops(_type).Destroy(block + 1, block->Capacity);
+			FreeBlock(block);
+		}
+	}
+
+	/** DetachShared
+	 * @brief Gives this Datum storage of its own, copying the shared elements, or taking them when no other Datum
+	 * refers to them anymore
+	*/
+	void Datum::DetachShared() {
+		SharedBlock* block = Block();
+		void* data = AllocateStorage(_DatumCapacity);
+		if (block->Refs.load(std::memory_order_acquire) > 1) {
+			Ops(_type).Copy(data, _mData, _DatumSize);
+			if (block->Refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				// The others let go while copying
+				Ops(_type).Destroy(_mData, _DatumSize);
+				FreeBlock(block);
 			}
 		}
-		if (_type == Unknown) {
-			throw std::runtime_error("Can't Resize empty Datum");
+		else {
+			Ops(_type).Relocate(data, _mData, _DatumSize);
+			FreeBlock(block);
 		}
-		_DatumCapacity = newSize;
-	};
+		_mData = data;
+		_shared = false;
+	}
+
+	/** ReleaseShared
+	 * @brief Drops this Datum's reference to its SharedBlock, the last reference destroys the elements.
+	 * The Datum keeps its type and is left empty.
+	*/
+	void Datum::ReleaseShared() {
+		SharedBlock* block = Block();
+		if (block->Refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			Ops(_type).Destroy(_mData, _DatumSize);
+			FreeBlock(block);
+		}
+		_mData = nullptr;
+		_shared = false;
+		_DatumSize = 0;
+		_DatumCapacity = 0;
+	}
+
+	/** FreeBlock
+	 * @brief Hands a SharedBlock back to where it was allocated, its elements must already be destroyed or moved out
+	 * @param block
+	*/
+	void Datum::FreeBlock(SharedBlock* block) const {
+		std::pmr::memory_resource* resource = block->Resource;
+		const size_t bytes = sizeof(SharedBlock) + typeSizes[_type] * block->Capacity;
+		block->~SharedBlock();
+		if (resource != nullptr) {
+			resource->deallocate(block, bytes, alignof(SharedBlock));
+		}
+		else {
+			free(block);
+		}
+	}
+
+	/** AllocatePool
+	 * @brief Allocates a character block for capacity chars the same way AllocateStorage does, never inline
+	 * @param capacity : number of chars
+	 * @return empty CharPool
+	*/
+	Datum::CharPool* Datum::AllocatePool(size_t capacity) {
+		if (capacity > std::numeric_limits<std::uint32_t>::max()) {
+			throw std::runtime_error("PooledString Datum holds too many characters");
+		}
+		const size_t bytes = sizeof(CharPool) + capacity;
+		void* block = _resource != nullptr ? _resource->allocate(bytes, alignof(CharPool)) : malloc(bytes);
+		if (block == nullptr) {
+			throw std::bad_alloc();
+		}
+		CharPool* pool = static_cast<CharPool*>(block);
+		pool->Size = 0;
+		pool->Capacity = static_cast<std::uint32_t>(capacity);
+		return pool;
+	}
+
+	/** ReserveChars
+	 * @brief Makes room for count more chars at the end of the pool. Growing copies only the characters entries
+	 * still refer to, so the ones left behind by SetString and RemoveAt are dropped.
+	 * @param count
+	*/
+	void Datum::ReserveChars(size_t count) {
+		if (_chars != nullptr && _chars->Size + count <= _chars->Capacity) {
+			return;
+		}
+		PooledEntry* entries = static_cast<PooledEntry*>(_mData);
+		size_t live = 0;
+		for (size_t i = 0; i < _DatumSize; ++i) {
+			live += entries[i].Length;
+		}
+		CharPool* pool = AllocatePool(std::max({ live + count, live * 2, size_t(64) }));
+		char* dest = reinterpret_cast<char*>(pool + 1);
+		const char* src = PoolChars();
+		for (size_t i = 0; i < _DatumSize; ++i) {
+			if (entries[i].Length > 0) {
+				memcpy(dest + pool->Size, src + entries[i].Offset, entries[i].Length);
+			}
+			entries[i].Offset = pool->Size;
+			pool->Size += entries[i].Length;
+		}
+		FreeChars();
+		_chars = pool;
+	}
+
+	/** StoreChars
+	 * @brief Copies value's characters to the end of the pool
+	 * @param value : may point into the pool itself
+	 * @return entry referring to the copy
+	*/
+	Datum::PooledEntry Datum::StoreChars(std::string_view value) {
+		if (value.empty()) {
+			return PooledEntry{ 0, 0 };
+		}
+		const char* chars = PoolChars();
+		if (chars != nullptr && value.data() >= chars && value.data() < chars + _chars->Capacity) {
+			// Growing would free the characters being copied
+			return StoreChars(std::string(value));
+		}
+		ReserveChars(value.size());
+		PooledEntry entry{ _chars->Size, static_cast<std::uint32_t>(value.size()) };
+		memcpy(PoolChars() + entry.Offset, value.data(), value.size());
+		_chars->Size += entry.Length;
+		return entry;
+	}
+
+	/** StoreStrings
+	 * @brief Pushes count strings, with room for all of them made up front. The entry storage must already have
+	 * room for count more elements.
+	 * @param first
+	 * @param count
+	*/
+	void Datum::StoreStrings(const std::string_view* first, size_t count) {
+		size_t length = 0;
+		bool aliased = false;
+		const char* chars = PoolChars();
+		for (size_t i = 0; i < count; ++i) {
+			length += first[i].size();
+			aliased |= chars != nullptr && first[i].data() >= chars && first[i].data() < chars + _chars->Capacity;
+		}
+		if (aliased) {
+			// Growing would free the characters being copied
+			std::vector<std::string> copies(first, first + count);
+			std::vector<std::string_view> views(copies.begin(), copies.end());
+			StoreStrings(views.data(), count);
+			return;
+		}
+		ReserveChars(length);
+		PooledEntry* entries = static_cast<PooledEntry*>(_mData);
+		for (size_t i = 0; i < count; ++i) {
+			entries[_DatumSize] = StoreChars(first[i]);
+			_DatumSize++;
+		}
+	}
+
+	/** CopyChars
+	 * @brief Copies other's whole pool in a single memcpy, entries keep their offsets. This Datum must have no pool.
+	 * @param other
+	*/
+	void Datum::CopyChars(const Datum& other) {
+		if (other._chars == nullptr || other._chars->Size == 0) {
+			return;
+		}
+		_chars = AllocatePool(other._chars->Size);
+		memcpy(PoolChars(), other.PoolChars(), other._chars->Size);
+		_chars->Size = other._chars->Size;
+	}
+
+	/** StealChars
+	 * @brief Takes other's pool, or copies it when this Datum allocates from another resource. This Datum must have no pool.
+	 * @param other : left without a pool
+	*/
+	void Datum::StealChars(Datum& other) {
+		if (other._chars == nullptr) {
+			return;
+		}
+		if (other._resource == _resource) {
+			_chars = other._chars;
+			other._chars = nullptr;
+		}
+		else {
+			CopyChars(other);
+			other.FreeChars();
+		}
+	}
+
+	/** FreeChars
+	 * @brief Releases the character pool
+	*/
+	void Datum::FreeChars() {
+		if (_chars != nullptr) {
+			if (_resource != nullptr) {
+				_resource->deallocate(_chars, sizeof(CharPool) + _chars->Capacity, alignof(CharPool));
+			}
+			else {
+				free(_chars);
+			}
+		}
+		_chars = nullptr;
+	}
 
 	const std::string Datum::ToString() const{
 		std::stringstream ss;
@@ -1539,87 +1529,28 @@ namespace Fiea::GameEngine {
 		if (idx >= _DatumSize) {
 			throw std::out_of_range("idx is larger than Datum size");
 		}
-		else {
-			switch (_type)
-			{
-			case Fiea::GameEngine::Datum::Unknown:
-				throw std::invalid_argument("Cannot remove from uninitialized Datum");
-			case Fiea::GameEngine::Datum::Int:
-			{
-				int* ptr = static_cast<int*>(_mData);
-				ptr[idx] = NULL;
-				for (size_t i = idx; i < _DatumSize - 1; ++i) {
-					ptr[i] = ptr[i + 1];
-				}
-				--_DatumSize;
-				break;
-			}
-			case Fiea::GameEngine::Datum::Float:
-			{
-				float* ptr = static_cast<float*>(_mData);
-				ptr[idx] = NULL;
-				for (size_t i = idx; i < _DatumSize - 1; ++i) {
-					ptr[i] = ptr[i + 1];
-				}
-				--_DatumSize;
-				break;
-			}
-			case Fiea::GameEngine::Datum::String:
-			{
-				std::string* ptr = static_cast<std::string*>(_mData);
-				ptr[idx] = std::string();
-				for (size_t i = idx; i < _DatumSize - 1; ++i) {
-					ptr[i] = ptr[i + 1];
-				}
-				--_DatumSize;
-				break;
-			}
-			case Fiea::GameEngine::Datum::Vector:
-			{
-				glm::vec4* ptr = static_cast<glm::vec4*>(_mData);
-				ptr[idx] = glm::vec4();
-				for (size_t i = idx; i < _DatumSize - 1; ++i) {
-					ptr[i] = ptr[i + 1];
-				}
-				--_DatumSize;
-				break;
-			}
-			case Fiea::GameEngine::Datum::Matrix:
-			{
-				glm::mat4* ptr = static_cast<glm::mat4*>(_mData);
-				ptr[idx] = glm::mat4();
-				for (size_t i = idx; i < _DatumSize - 1; ++i) {
-					ptr[i] = ptr[i + 1];
-				}
-				--_DatumSize;
-				break;
-			}
-			case Fiea::GameEngine::Datum::Table:
-			{
-				Scope** ptr = static_cast<Scope**>(_mData);
-				ptr[idx] = nullptr;
-				if ((idx + 1) < _DatumSize) {
-					for (size_t i = idx; i < _DatumSize - 1; ++i) {
-						ptr[i] = ptr[i + 1];
-					}
-					ptr[_DatumSize - 1] = nullptr;
-				}
-				--_DatumSize;
-				break;
-			}
-			case Fiea::GameEngine::Datum::Pointer:
-			{
-				RTTI** ptr = static_cast<RTTI**>(_mData);
-				ptr[idx] = nullptr;
-				for (size_t i = idx; i < _DatumSize - 1; ++i) {
-					ptr[i] = ptr[i + 1];
-				}
-				--_DatumSize;
-				break;
-			}
-			default:
-				throw std::invalid_argument("Type unsupported");
-			}
+		if (_type == Unknown) {
+			throw std::invalid_argument("Cannot remove from uninitialized Datum");
 		}
+		Detach();
+		Ops(_type).Erase(_mData, idx, _DatumSize);
+		--_DatumSize;
 	};
+
+	/** RemoveAtUnordered
+	 * @brief Removes the element at idx by moving the last element into its slot, so nothing shifts
+	 * but the order of the remaining elements changes
+	 * @param idx : index of the element to remove
+	*/
+	void Datum::RemoveAtUnordered(size_t idx) {
+		if (idx >= _DatumSize) {
+			throw std::out_of_range("idx is larger than Datum size");
+		}
+		if (_type == Unknown) {
+			throw std::invalid_argument("Cannot remove from uninitialized Datum");
+		}
+		Detach();
+		Ops(_type).SwapErase(_mData, idx, _DatumSize);
+		--_DatumSize;
+	}
 };
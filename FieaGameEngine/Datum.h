@@ -3,15 +3,22 @@
 #define GLM_ENABLE_EXPERIMENTAL
 
 #include <string>
+#include <string_view>
+#include <span>
+#include <iterator>
+#include <memory_resource>
+#include <atomic>
 #include "glm/glm.hpp"
 #include "glm/gtx/string_cast.hpp"
 #include "RTTI.h"
 
 namespace Fiea::GameEngine {
 	class Scope;
+	class AttributePath;
 
 	class Datum {
 	friend Scope;
+	friend AttributePath;
 	public:
 
 		// Enum determining Data Type
@@ -23,11 +30,18 @@ namespace Fiea::GameEngine {
 			Vector,
 			Matrix,
 			Table,
-			Pointer
+			Pointer,
+			PooledString // strings whose characters share one pool per Datum, read through GetStringView
 		};
 
+		// Element storage comes from this allocator's memory_resource when one is given (see GetResource).
+		// Declaring it, with the allocator_arg constructors below, makes pmr containers (and Scope) hand
+		// their resource down to the Datums they hold.
+		using allocator_type = std::pmr::polymorphic_allocator<>;
+
 		// Default Constructor -------------------------------------------------------------------------------------------
 		Datum();
+		Datum(std::allocator_arg_t, const allocator_type& allocator);
 
 		// Parameterized Constructors ------------------------------------------------------------------------------------
 		template<class T>
@@ -36,20 +50,31 @@ namespace Fiea::GameEngine {
 		template<>
 		Datum(const char* value);
 
+		Datum(std::string_view value);
+
 		template<class T>
 		Datum(T value, size_t size);
 
 		template<>
 		Datum(const char* value, size_t size);
 
+		// Range Constructor ----------------------------------------------------------------------------------------------
+		template<std::input_iterator InputIt>
+		Datum(InputIt first, InputIt last);
+
 		// Copy Constructor -----------------------------------------------------------------------------------------------
 
 		Datum(Datum& other);
 		Datum(const Datum& other);
+		Datum(std::allocator_arg_t, const allocator_type& allocator, const Datum& other);
+
+		// Copy owning its elements, also of a Datum viewing external storage (plain copies view the same storage)
+		[[nodiscard]] Datum Owned() const;
 
 		// Move Constructor -----------------------------------------------------------------------------------------------
 
 		Datum(Datum&& other) noexcept;
+		Datum(std::allocator_arg_t, const allocator_type& allocator, Datum&& other);
 
 		// Assignment Operator -------------------------------------------------------------------------------------------------
 
@@ -77,13 +102,24 @@ namespace Fiea::GameEngine {
 		template<>
 		void Push(const char* value);
 
+		void Push(std::string_view value);
+
 		void Pop();
 
+		// Bulk insertion
+		template<class T>
+		void Append(const T* first, size_t count);
+
+		template<class T>
+		void Assign(std::span<const T> values);
+
 		// Set
 		template<class T>
 		void Set(size_t idx, T& valueRef);
 
 		void SetFromString(size_t idx, std::string value);
+
+		void SetString(size_t idx, std::string_view value);
 		
 
 		// Retrieving Methods (GET)
@@ -108,6 +144,17 @@ namespace Fiea::GameEngine {
 		const Scope* GetScope(size_t idx = 0) const;
 		RTTI* GetPointer(size_t idx = 0);
 		const RTTI* GetPointer(size_t idx = 0) const;
+		std::string_view GetStringView(size_t idx = 0) const;
+
+		// Typed views over every element, a single type check instead of one per element
+		template<class T>
+		std::span<T> AsSpan();
+
+		template<class T>
+		std::span<const T> AsSpan() const;
+
+		template<class T>
+		std::span<const T> AsConstSpan() const;
 
 		// Retrieval as String
 		std::string GetAsString(size_t idx = 0);
@@ -124,9 +171,11 @@ namespace Fiea::GameEngine {
 		bool CheckType(T value);
 
 		bool CheckType(DatumType type);
+		bool CheckType(DatumType type) const;
 
 		// Size
 		void Resize(size_t newSize);
+		void Reserve(size_t capacity);
 		void Clear();
 		bool Empty();
 		size_t Size() { return _DatumSize; };
@@ -140,11 +189,17 @@ namespace Fiea::GameEngine {
 		template<class T>
 		void SetStorage(T* array, int elementNum, DatumType type);
 
+		// Resource element storage is allocated from, nullptr when it lives on the heap (malloc/realloc)
+		std::pmr::memory_resource* GetResource() const { return _resource; };
+
 		// no implementation in headers for now... move to inl or cpp
 
 		// Scope
 		void RemoveAt(size_t idx);
 
+		// Constant time removal, the last element takes idx's place
+		void RemoveAtUnordered(size_t idx);
+
 
 
 		// operator[]
@@ -154,7 +209,26 @@ namespace Fiea::GameEngine {
 
 	private:
 
-		size_t typeSizes[8] = {
+		// PooledString element, the characters of the string inside the Datum's CharPool
+		struct PooledEntry {
+			std::uint32_t Offset;
+			std::uint32_t Length;
+		};
+
+		// Header of a PooledString Datum's character block, Capacity chars follow it
+		struct CharPool {
+			std::uint32_t Size;
+			std::uint32_t Capacity;
+		};
+
+		// Header in front of elements shared copy-on-write by several Datums (see Share), Capacity elements follow it
+		struct alignas(16) SharedBlock {
+			std::atomic<std::uint32_t> Refs;
+			std::pmr::memory_resource* Resource; // where the block came from, nullptr for malloc
+			size_t Capacity;
+		};
+
+		inline static constexpr size_t typeSizes[9] = {
 			sizeof(void*),
 			sizeof(int),
 			sizeof(float),
@@ -162,14 +236,59 @@ namespace Fiea::GameEngine {
 			sizeof(glm::vec4),
 			sizeof(glm::mat4x4),
 			sizeof(Scope*),
-			sizeof(RTTI*)
+			sizeof(RTTI*),
+			sizeof(PooledEntry)
 		};
 
+		// Bytes of element storage kept inside the Datum itself, enough for one of the largest type (mat4)
+		static constexpr size_t InlineBytes = sizeof(glm::mat4x4);
+		static_assert(InlineBytes >= sizeof(std::string), "Inline buffer must hold at least one string");
+
+		template<class T>
+		static constexpr DatumType TypeOf();
+
+		bool IsInline() const { return _mData == _inline; };
+		void* AllocateStorage(size_t capacity);
+		void FreeStorage();
+		void Reallocate(size_t newCapacity);
+		void StealStorage(Datum& other);
+		void Release();
+
+		// Copy-on-write sharing, used by Scope::CloneShared
+		SharedBlock* Block() const { return reinterpret_cast<SharedBlock*>(static_cast<char*>(_mData) - sizeof(SharedBlock)); };
+		void Share(const Datum& source);
+		SharedBlock* MakeSnapshot() const;
+		void DropSnapshot();
+		void Detach() { if (_shared) { DetachShared(); } else if (_snapshot != nullptr) { DropSnapshot(); } };
+		void DetachShared();
+		void ReleaseShared();
+		void FreeBlock(SharedBlock* block) const;
+
+		// Per DatumType element operations (copy, relocate, destroy, compare, string conversion), defined in Datum.cpp
+		struct TypeOps;
+		struct PooledStringOps;
+		static const TypeOps& Ops(DatumType type);
+
+		// PooledString character pool
+		char* PoolChars() const { return _chars == nullptr ? nullptr : reinterpret_cast<char*>(_chars + 1); };
+		CharPool* AllocatePool(size_t capacity);
+		void ReserveChars(size_t count);
+		PooledEntry StoreChars(std::string_view value);
+		void StoreStrings(const std::string_view* first, size_t count);
+		void CopyChars(const Datum& other);
+		void StealChars(Datum& other);
+		void FreeChars();
+
 		DatumType _type = Unknown; // an Enum determining the type of elements inside the Datum
+		bool externalStorage = false;
+		bool _shared = false; // _mData points into a SharedBlock, copied before the elements are changed
+		SharedBlock* _snapshot = nullptr; // copy of this Datum's own elements that Share hands out, see Share
 		size_t _DatumSize = 0; //Datum's size
 		size_t _DatumCapacity = 0; //Datum's Capacity
 		void* _mData = nullptr; //pointer to the first element in the Datum
-		bool externalStorage = false;
+		std::pmr::memory_resource* _resource = nullptr; // where heap storage comes from, nullptr for malloc
+		CharPool* _chars = nullptr; // characters of PooledString elements, allocated like the element storage
+		alignas(16) unsigned char _inline[InlineBytes]; // small buffer used instead of the heap while the elements fit
 	};
 }
 
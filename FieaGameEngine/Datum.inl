@@ -16,7 +16,7 @@ namespace Fiea::GameEngine {
 		// Determine type of value
 		SetType(value);
 		if (typeSizes[_type] > 0) {
-			T* dataPtr = (T*)malloc(typeSizes[_type]);
+			T* dataPtr = static_cast<T*>(AllocateStorage(1));
 			new(dataPtr) T(value);
 			_mData = dataPtr;
 			_DatumSize = _DatumCapacity = 1;
@@ -35,8 +35,14 @@ namespace Fiea::GameEngine {
 	Datum::Datum(T value, size_t size) {
 		// Determine type of value
 		SetType(value);
+		if constexpr (std::is_same_v<T, std::string_view>) {
+			// Pooled strings copy their characters into the pool, see Push
+			Reserve(size);
+			Push(value);
+			return;
+		}
 		if (typeSizes[_type] != 0) {
-			_mData = (T*)malloc(typeSizes[_type] * size);
+			_mData = AllocateStorage(size);
 			T* T_mData = static_cast<T*>(_mData);
 			new(T_mData) T(value);
 
@@ -54,7 +60,7 @@ namespace Fiea::GameEngine {
 	inline Datum::Datum(const char* value, size_t size) {
 		std::string strValue = std::string(value); // transforms const char* to string strValue
 		SetType(value); // Sets the DatumType (_type) for the Datum to String
-		_mData = (std::string*)malloc(sizeof(std::string) * size); //Allocates memory equal to size of string * size
+		_mData = AllocateStorage(size); //Allocates memory equal to size of string * size, inline if it fits
 		if (sizeof(strValue) > 0) {
 			new(_mData) std::string(strValue); // Placement new to put strValue in the beginning of Datum (_mData)
 			_DatumSize = 1; //Set DatumSize to size
@@ -73,6 +79,7 @@ namespace Fiea::GameEngine {
 			throw std::runtime_error("Can't manipulate external storage");
 		}
 		else {
+			Detach();
 			// Checks if the type is the same as the current Datum or the Datum is empty
 			if (_type == Unknown) {
 				//Attempt to SetType
@@ -82,45 +89,12 @@ namespace Fiea::GameEngine {
 			if (CheckType(value)) {
 				// If Datum is at capacity, reallocate more memory
 				if (_DatumSize == _DatumCapacity) {
-					//String Exception
-					if (_type == String) {
-						size_t size = typeSizes[_type] * ((_DatumCapacity * 2) + 1);
-						std::string* _newData = (std::string*)malloc(typeSizes[_type] * ((_DatumCapacity * 2) + 1));
-						std::string* ptr = static_cast<std::string*>(_mData);
-						// Transfer over all memory to the new reallocated memory
-						for (size_t i = 0; i < _DatumSize; ++i) {
-							new(_newData + i) std::string(ptr[i]);
-						}
-						// free string using ~basic_string()
-						for (size_t j = 0; j < _DatumSize; ++j) {
-							ptr[j].~basic_string();
-						}
-						free(_mData);
-						// Have _mData point to the address of the new memory
-						_mData = _newData;
-						// Adjust capacity
-						_DatumCapacity = ((_DatumCapacity * 2) + 1);
-					}
-					else {
-						// Allocate memory equal to size * (capacity * 2)
-						T* _newData = (T*)malloc(typeSizes[_type] * ((_DatumCapacity * 2) + 1));
-						T* ptr = static_cast<T*>(_mData);
-						// Transfer over all memory to the new reallocated memory
-						for (size_t i = 0; i < _DatumSize; ++i) {
-							new(_newData + i) T(ptr[i]);
-						}
-						// free current memory #Make sure there is a version for non POD
-						free(_mData);
-						// Have _mData point to the address of the new memory
-						_mData = _newData;
-						// Adjust capacity
-						_DatumCapacity = ((_DatumCapacity * 2) + 1);
-					}
+					// Moves to the heap once the elements outgrow the inline buffer
+					Reallocate((_DatumCapacity * 2) + 1);
 				}
-				Resize(_DatumCapacity);
-				// Add new value
+				// Add new value, value is already a copy so it can be moved in
 				T* ptr = static_cast<T*>(_mData);
-				new(ptr + _DatumSize) T(value);
+				new(ptr + _DatumSize) T(std::move(value));
 				_DatumSize++;
 			}
 			else {
@@ -136,6 +110,7 @@ namespace Fiea::GameEngine {
 	template<>
 	inline void Datum::Push(const char* value) {
 		if (!externalStorage) {
+			Detach();
 			if (_type == Unknown) {
 				//Attempt to SetType
 				SetType(value);
@@ -144,28 +119,12 @@ namespace Fiea::GameEngine {
 			if (CheckType(value)) {
 				// If Datum is at capacity, reallocate more memory
 				if (_DatumSize == _DatumCapacity) {
-					size_t size = typeSizes[_type] * ((_DatumCapacity * 2) + 1);
-					std::string* _newData = (std::string*)malloc(typeSizes[_type] * ((_DatumCapacity * 2) + 1));
-					std::string* ptr = static_cast<std::string*>(_mData);
-					// Transfer over all memory to the new reallocated memory
-					for (size_t i = 0; i < _DatumSize; ++i) {
-						new(_newData + i) std::string(ptr[i]);
-					}
-					// free string using ~basic_string()
-					for (size_t j = 0; j < _DatumSize; ++j) {
-						ptr[j].~basic_string();
-					}
-					free(_mData);
-					// Have _mData point to the address of the new memory
-					_mData = _newData;
-					// Adjust capacity
-					_DatumCapacity = ((_DatumCapacity * 2) + 1);
+					// Moves to the heap once the elements outgrow the inline buffer
+					Reallocate((_DatumCapacity * 2) + 1);
 				}
-				Resize(_DatumCapacity);
 				// Add new value
-				std::string s = std::string(value);
 				std::string* ptr = static_cast<std::string*>(_mData);
-				new(ptr + _DatumSize) std::string(s);
+				new(ptr + _DatumSize) std::string(value);
 				_DatumSize++;
 			}
 			else {
@@ -177,6 +136,89 @@ namespace Fiea::GameEngine {
 		}
 	};
 
+	/** Range Constructor
+	 * @brief Constructs a Datum holding a copy of every element in [first, last), allocating once when the
+	 * length of the range is known up front
+	 * @tparam InputIt : iterator over one of the Datum types
+	 * @param first
+	 * @param last
+	*/
+	template<std::input_iterator InputIt>
+	Datum::Datum(InputIt first, InputIt last) {
+		using T = std::iter_value_t<InputIt>;
+		static_assert(!std::is_same_v<T, const char*>, "Construct String Datums from std::strings");
+		// std::string_views are pooled one at a time, their characters have to be copied in
+		if constexpr (std::forward_iterator<InputIt> && !std::is_same_v<T, std::string_view>) {
+			size_t count = static_cast<size_t>(std::distance(first, last));
+			if (count == 0) {
+				return;
+			}
+			SetType(T(*first));
+			_mData = AllocateStorage(count);
+			std::uninitialized_copy(first, last, static_cast<T*>(_mData));
+			_DatumSize = _DatumCapacity = count;
+		}
+		else {
+			for (; first != last; ++first) {
+				Push(T(*first));
+			}
+		}
+	}
+
+	/** Append
+	 * @brief Copies count elements starting at first to the end of the Datum, growing the storage at most once
+	 * @tparam T : element type, has to match the Datum's type, std::string_view for PooledString Datums whose
+	 * characters are copied into the pool with a single growth too
+	 * @param first : first element to copy
+	 * @param count : number of elements to copy
+	*/
+	template<class T>
+	void Datum::Append(const T* first, size_t count) {
+		static_assert(!std::is_same_v<T, const char*>, "Append std::strings to String Datums");
+		if (externalStorage) {
+			throw std::runtime_error("Can't manipulate external storage");
+		}
+		if (count == 0) {
+			return;
+		}
+		Detach();
+		if (_type == Unknown) {
+			SetType(*first);
+		}
+		if (!CheckType(*first)) {
+			throw std::runtime_error("Value entered does not match with Datum's current type");
+		}
+		if (_DatumSize + count > _DatumCapacity) {
+			// Still grows geometrically so many small Appends stay cheap
+			Reallocate(std::max(_DatumSize + count, (_DatumCapacity * 2) + 1));
+		}
+		if constexpr (std::is_same_v<T, std::string_view>) {
+			StoreStrings(first, count);
+		}
+		else {
+			std::uninitialized_copy_n(first, count, static_cast<T*>(_mData) + _DatumSize);
+			_DatumSize += count;
+		}
+	}
+
+	/** Assign
+	 * @brief Replaces the contents of the Datum with a copy of values
+	 * @tparam T : element type, has to match the Datum's type
+	 * @param values
+	*/
+	template<class T>
+	void Datum::Assign(std::span<const T> values) {
+		if (externalStorage) {
+			throw std::runtime_error("Can't manipulate external storage");
+		}
+		// Check before clearing so a mismatched Assign leaves the Datum untouched
+		if (!values.empty() && _type != Unknown && !CheckType(values.front())) {
+			throw std::runtime_error("Value entered does not match with Datum's current type");
+		}
+		Clear();
+		Append(values.data(), values.size());
+	}
+
 	/** Set
 	 * @brief Takes an int index and a reference to a value, which it uses to set the element at index
 	 * @tparam T 
@@ -185,6 +227,12 @@ namespace Fiea::GameEngine {
 	*/
 	template<class T>
 	void Datum::Set(size_t idx, T& valueRef) {
+		if constexpr (std::is_same_v<std::remove_cv_t<T>, std::string_view>) {
+			// The characters go into the pool, the element only refers to them
+			SetString(idx, valueRef);
+			return;
+		}
+		Detach();
 		// If Setting to an empty Datum, setup the Datum
 		if (_DatumSize == 0 && idx == 0) {
 			Push(valueRef);
@@ -268,6 +316,15 @@ namespace Fiea::GameEngine {
 				return false;
 			}
 		}
+		case Datum::PooledString:
+		{
+			if constexpr (std::is_same<T, std::string_view>::value) {
+				return true;
+			}
+			else {
+				return false;
+			}
+		}
 		default:
 			throw std::runtime_error("Datum was not initialized");
 		}
@@ -371,6 +428,7 @@ namespace Fiea::GameEngine {
 				throw std::out_of_range("index out of range");
 			}
 			else {
+				Detach();
 				RTTI** rPtr = static_cast<RTTI**>(_mData);
 				return rPtr[idx];
 			}
@@ -378,6 +436,56 @@ namespace Fiea::GameEngine {
 	}
 
 
+	/** AsSpan
+	 * @brief Views every element of the Datum as a contiguous array of T, checking the type only once.
+	 * Elements shared with a copy-on-write clone are copied first, use AsConstSpan to only read them.
+	 * @tparam T : element type matching the Datum's type
+	 * @return span over the Datum's elements, invalidated by anything that reallocates the Datum
+	*/
+	template<class T>
+	std::span<T> Datum::AsSpan() {
+		if (_type != TypeOf<T>()) {
+			throw std::runtime_error("Datum is either uninitialized or not of the requested type");
+		}
+		Detach();
+		return std::span<T>(static_cast<T*>(_mData), _DatumSize);
+	}
+
+	template<class T>
+	std::span<const T> Datum::AsSpan() const {
+		return AsConstSpan<T>();
+	}
+
+	/** AsConstSpan
+	 * @brief Read only version of AsSpan
+	 * @tparam T : element type matching the Datum's type
+	 * @return span over the Datum's elements
+	*/
+	template<class T>
+	std::span<const T> Datum::AsConstSpan() const {
+		if (_type != TypeOf<T>()) {
+			throw std::runtime_error("Datum is either uninitialized or not of the requested type");
+		}
+		return std::span<const T>(static_cast<const T*>(_mData), _DatumSize);
+	}
+
+	/** TypeOf
+	 * @brief Maps an element type to its DatumType at compile time
+	 * @tparam T : one of the types a Datum can hold
+	 * @return DatumType storing T
+	*/
+	template<class T>
+	constexpr Datum::DatumType Datum::TypeOf() {
+		if constexpr (std::is_same_v<T, int>) return Int;
+		else if constexpr (std::is_same_v<T, float>) return Float;
+		else if constexpr (std::is_same_v<T, std::string>) return String;
+		else if constexpr (std::is_same_v<T, glm::vec4>) return Vector;
+		else if constexpr (std::is_same_v<T, glm::mat4>) return Matrix;
+		else if constexpr (std::is_same_v<T, Scope*>) return Table;
+		else if constexpr (std::is_same_v<T, RTTI*>) return Pointer;
+		else static_assert(sizeof(T) == 0, "Type is not supported by Datum");
+	}
+
 	/** SetType
 	 * @brief Determines the type the Datum is containing/will contain based on the type passed to the method
 	 * @param type: const type_info& used to determing the type of a variable/input
@@ -421,6 +529,10 @@ namespace Fiea::GameEngine {
 				_type = DatumType::Pointer;
 				return;
 			}
+			else if constexpr (std::is_same<T, std::string_view>::value) {
+				_type = DatumType::PooledString;
+				return;
+			}
 			else {
 				throw std::runtime_error("Type entered is not supported by current implemntation");
 			}
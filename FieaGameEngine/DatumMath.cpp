@@ -0,0 +1,357 @@
+#include "pch.h"
+#include "DatumMath.h"
+#include <cmath>
+#include <stdexcept>
+
+// AVX when the build targets it (/arch:AVX, -mavx), otherwise SSE which every x64 target has
+#if !defined(FIEA_DATUM_MATH_SCALAR)
+#if defined(__AVX__)
+#include <immintrin.h>
+#define FIEA_DATUM_MATH_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FIEA_DATUM_MATH_SSE
+#endif
+#endif
+
+namespace Fiea::GameEngine {
+	namespace {
+		namespace Simd {
+			// Scalar versions of the lane operations, also used for the elements left after the last full lane
+			inline float Add(float a, float b) { return a + b; }
+			inline float Sub(float a, float b) { return a - b; }
+			inline float Mul(float a, float b) { return a * b; }
+			// Same operand order as _mm_min_ps/_mm_max_ps so NaNs clamp the same way in both paths
+			inline float Min(float a, float b) { return a < b ? a : b; }
+			inline float Max(float a, float b) { return a > b ? a : b; }
+			inline float MulAdd(float a, float b, float c) {
+#if defined(__FMA__)
+				return std::fma(a, b, c);
+#else
+				return a * b + c;
+#endif
+			}
+
+#if defined(FIEA_DATUM_MATH_AVX)
+			using Lanes = __m256;
+			constexpr size_t LaneCount = 8;
+			inline Lanes Load(const float* p) { return _mm256_loadu_ps(p); }
+			inline void Store(float* p, Lanes v) { _mm256_storeu_ps(p, v); }
+			inline Lanes Splat(float f) { return _mm256_set1_ps(f); }
+			inline Lanes Add(Lanes a, Lanes b) { return _mm256_add_ps(a, b); }
+			inline Lanes Sub(Lanes a, Lanes b) { return _mm256_sub_ps(a, b); }
+			inline Lanes Mul(Lanes a, Lanes b) { return _mm256_mul_ps(a, b); }
+			inline Lanes Min(Lanes a, Lanes b) { return _mm256_min_ps(a, b); }
+			inline Lanes Max(Lanes a, Lanes b) { return _mm256_max_ps(a, b); }
+#if defined(__FMA__)
+			inline Lanes MulAdd(Lanes a, Lanes b, Lanes c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+			inline Lanes MulAdd(Lanes a, Lanes b, Lanes c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+#elif defined(FIEA_DATUM_MATH_SSE)
+			using Lanes = __m128;
+			constexpr size_t LaneCount = 4;
+			inline Lanes Load(const float* p) { return _mm_loadu_ps(p); }
+			inline void Store(float* p, Lanes v) { _mm_storeu_ps(p, v); }
+			inline Lanes Splat(float f) { return _mm_set1_ps(f); }
+			inline Lanes Add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+			inline Lanes Sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+			inline Lanes Mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+			inline Lanes Min(Lanes a, Lanes b) { return _mm_min_ps(a, b); }
+			inline Lanes Max(Lanes a, Lanes b) { return _mm_max_ps(a, b); }
+			inline Lanes MulAdd(Lanes a, Lanes b, Lanes c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+#endif
+		}
+
+		using namespace Simd;
+
+		// Turns a scalar argument into the type an operation is being applied to, float or Lanes
+		template<class T>
+		inline T Broadcast(float f) {
+#if defined(FIEA_DATUM_MATH_AVX) || defined(FIEA_DATUM_MATH_SSE)
+			if constexpr (std::is_same_v<T, Lanes>) {
+				return Splat(f);
+			}
+			else
+#endif
+			{
+				return f;
+			}
+		}
+
+		/** ForEach
+		 * @brief data[i] = op(data[i]), a full lane at a time and then one float at a time for the rest
+		 * @param op : generic callable taking and returning float or Lanes
+		*/
+		template<class Op>
+		void ForEach(float* data, size_t count, Op op) {
+			size_t i = 0;
+#if defined(FIEA_DATUM_MATH_AVX) || defined(FIEA_DATUM_MATH_SSE)
+			for (; i + LaneCount <= count; i += LaneCount) {
+				Store(data + i, op(Load(data + i)));
+			}
+#endif
+			for (; i < count; ++i) {
+				data[i] = op(data[i]);
+			}
+		}
+
+		/** ForEach
+		 * @brief data[i] = op(data[i], other[i])
+		*/
+		template<class Op>
+		void ForEach(float* data, const float* other, size_t count, Op op) {
+			size_t i = 0;
+#if defined(FIEA_DATUM_MATH_AVX) || defined(FIEA_DATUM_MATH_SSE)
+			for (; i + LaneCount <= count; i += LaneCount) {
+				Store(data + i, op(Load(data + i), Load(other + i)));
+			}
+#endif
+			for (; i < count; ++i) {
+				data[i] = op(data[i], other[i]);
+			}
+		}
+
+		/** TransformVectors
+		 * @brief vectors[i] = transform * vectors[i], as a sum of the matrix columns scaled by each component
+		*/
+		void TransformVectors(glm::vec4* vectors, size_t count, const glm::mat4& transform) {
+#if defined(FIEA_DATUM_MATH_AVX) || defined(FIEA_DATUM_MATH_SSE)
+			const __m128 c0 = _mm_loadu_ps(&transform[0].x);
+			const __m128 c1 = _mm_loadu_ps(&transform[1].x);
+			const __m128 c2 = _mm_loadu_ps(&transform[2].x);
+			const __m128 c3 = _mm_loadu_ps(&transform[3].x);
+			for (size_t i = 0; i < count; ++i) {
+				float* v = &vectors[i].x;
+				__m128 x = _mm_loadu_ps(v);
+				__m128 result = _mm_mul_ps(c0, _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 0, 0, 0)));
+				result = _mm_add_ps(result, _mm_mul_ps(c1, _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 1, 1, 1))));
+				result = _mm_add_ps(result, _mm_mul_ps(c2, _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 2, 2, 2))));
+				result = _mm_add_ps(result, _mm_mul_ps(c3, _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3))));
+				_mm_storeu_ps(v, result);
+			}
+#else
+			for (size_t i = 0; i < count; ++i) {
+				vectors[i] = transform * vectors[i];
+			}
+#endif
+		}
+
+		// Float, Vector and Matrix Datums viewed as their components
+		std::span<float> FloatsOf(Datum& datum) {
+			if (datum.CheckType(Datum::Float)) {
+				return datum.AsSpan<float>();
+			}
+			if (datum.CheckType(Datum::Vector)) {
+				std::span<glm::vec4> vectors = datum.AsSpan<glm::vec4>();
+				return std::span<float>(reinterpret_cast<float*>(vectors.data()), vectors.size() * 4);
+			}
+			if (datum.CheckType(Datum::Matrix)) {
+				std::span<glm::mat4> matrices = datum.AsSpan<glm::mat4>();
+				return std::span<float>(reinterpret_cast<float*>(matrices.data()), matrices.size() * 16);
+			}
+			throw std::runtime_error("Datum is not of type Float, Vector or Matrix");
+		}
+
+		std::span<const float> FloatsOf(const Datum& datum) {
+			if (datum.CheckType(Datum::Float)) {
+				return datum.AsConstSpan<float>();
+			}
+			if (datum.CheckType(Datum::Vector)) {
+				std::span<const glm::vec4> vectors = datum.AsConstSpan<glm::vec4>();
+				return std::span<const float>(reinterpret_cast<const float*>(vectors.data()), vectors.size() * 4);
+			}
+			if (datum.CheckType(Datum::Matrix)) {
+				std::span<const glm::mat4> matrices = datum.AsConstSpan<glm::mat4>();
+				return std::span<const float>(reinterpret_cast<const float*>(matrices.data()), matrices.size() * 16);
+			}
+			throw std::runtime_error("Datum is not of type Float, Vector or Matrix");
+		}
+
+		// Binary operations need both Datums to hold the same type and number of elements
+		void CheckOperands(const Datum& datum, const Datum& other) {
+			if (datum.GetType() != other.GetType()) {
+				throw std::runtime_error("Datums are of different types");
+			}
+			if (datum.Size() != other.Size()) {
+				throw std::invalid_argument("Datums are of different sizes");
+			}
+		}
+	}
+
+	/** Add
+	 * @brief Adds scalar to every element (every component of Vectors and Matrices)
+	 * @param datum : Int, Float, Vector or Matrix Datum
+	 * @param scalar
+	*/
+	void DatumMath::Add(Datum& datum, float scalar) {
+		if (datum.CheckType(Datum::Int)) {
+			const int value = (int)scalar;
+			for (int& element : datum.AsSpan<int>()) {
+				element += value;
+			}
+			return;
+		}
+		std::span<float> floats = FloatsOf(datum);
+		ForEach(floats.data(), floats.size(), [scalar](auto x) { return Simd::Add(x, Broadcast<decltype(x)>(scalar)); });
+	}
+
+	/** Add
+	 * @brief Adds other to datum element by element
+	 * @param datum : Int, Float, Vector or Matrix Datum
+	 * @param other : Datum of the same type and size
+	*/
+	void DatumMath::Add(Datum& datum, const Datum& other) {
+		CheckOperands(datum, other);
+		if (datum.CheckType(Datum::Int)) {
+			std::span<int> lhs = datum.AsSpan<int>();
+			std::span<const int> rhs = other.AsConstSpan<int>();
+			for (size_t i = 0; i < lhs.size(); ++i) {
+				lhs[i] += rhs[i];
+			}
+			return;
+		}
+		std::span<float> floats = FloatsOf(datum);
+		ForEach(floats.data(), FloatsOf(other).data(), floats.size(), [](auto x, auto y) { return Simd::Add(x, y); });
+	}
+
+	/** Multiply
+	 * @brief Multiplies every element by scalar
+	 * @param datum : Int, Float, Vector or Matrix Datum
+	 * @param scalar
+	*/
+	void DatumMath::Multiply(Datum& datum, float scalar) {
+		if (datum.CheckType(Datum::Int)) {
+			const int value = (int)scalar;
+			for (int& element : datum.AsSpan<int>()) {
+				element *= value;
+			}
+			return;
+		}
+		std::span<float> floats = FloatsOf(datum);
+		ForEach(floats.data(), floats.size(), [scalar](auto x) { return Simd::Mul(x, Broadcast<decltype(x)>(scalar)); });
+	}
+
+	/** Multiply
+	 * @brief Multiplies datum by other element by element (component wise for Vectors and Matrices)
+	 * @param datum : Int, Float, Vector or Matrix Datum
+	 * @param other : Datum of the same type and size
+	*/
+	void DatumMath::Multiply(Datum& datum, const Datum& other) {
+		CheckOperands(datum, other);
+		if (datum.CheckType(Datum::Int)) {
+			std::span<int> lhs = datum.AsSpan<int>();
+			std::span<const int> rhs = other.AsConstSpan<int>();
+			for (size_t i = 0; i < lhs.size(); ++i) {
+				lhs[i] *= rhs[i];
+			}
+			return;
+		}
+		std::span<float> floats = FloatsOf(datum);
+		ForEach(floats.data(), FloatsOf(other).data(), floats.size(), [](auto x, auto y) { return Simd::Mul(x, y); });
+	}
+
+	/** MultiplyAdd
+	 * @brief Scales every element and adds offset, fused when the target has FMA
+	 * @param datum : Int, Float, Vector or Matrix Datum
+	 * @param scale
+	 * @param offset
+	*/
+	void DatumMath::MultiplyAdd(Datum& datum, float scale, float offset) {
+		if (datum.CheckType(Datum::Int)) {
+			const int intScale = (int)scale;
+			const int intOffset = (int)offset;
+			for (int& element : datum.AsSpan<int>()) {
+				element = element * intScale + intOffset;
+			}
+			return;
+		}
+		std::span<float> floats = FloatsOf(datum);
+		ForEach(floats.data(), floats.size(), [scale, offset](auto x) {
+			using T = decltype(x);
+			return Simd::MulAdd(x, Broadcast<T>(scale), Broadcast<T>(offset));
+		});
+	}
+
+	/** MultiplyAdd
+	 * @brief Adds other scaled by scale to datum, element by element
+	 * @param datum : Int, Float, Vector or Matrix Datum
+	 * @param other : Datum of the same type and size
+	 * @param scale
+	*/
+	void DatumMath::MultiplyAdd(Datum& datum, const Datum& other, float scale) {
+		CheckOperands(datum, other);
+		if (datum.CheckType(Datum::Int)) {
+			const int intScale = (int)scale;
+			std::span<int> lhs = datum.AsSpan<int>();
+			std::span<const int> rhs = other.AsConstSpan<int>();
+			for (size_t i = 0; i < lhs.size(); ++i) {
+				lhs[i] += rhs[i] * intScale;
+			}
+			return;
+		}
+		std::span<float> floats = FloatsOf(datum);
+		ForEach(floats.data(), FloatsOf(other).data(), floats.size(), [scale](auto x, auto y) {
+			return Simd::MulAdd(y, Broadcast<decltype(x)>(scale), x);
+		});
+	}
+
+	/** Clamp
+	 * @brief Clamps every element to [min, max]
+	 * @param datum : Int, Float, Vector or Matrix Datum
+	 * @param min
+	 * @param max
+	*/
+	void DatumMath::Clamp(Datum& datum, float min, float max) {
+		if (min > max) {
+			throw std::invalid_argument("min is larger than max");
+		}
+		if (datum.CheckType(Datum::Int)) {
+			const int intMin = (int)min;
+			const int intMax = (int)max;
+			for (int& element : datum.AsSpan<int>()) {
+				element = std::min(std::max(element, intMin), intMax);
+			}
+			return;
+		}
+		std::span<float> floats = FloatsOf(datum);
+		ForEach(floats.data(), floats.size(), [min, max](auto x) {
+			using T = decltype(x);
+			return Simd::Min(Simd::Max(x, Broadcast<T>(min)), Broadcast<T>(max));
+		});
+	}
+
+	/** Lerp
+	 * @brief Moves every element of datum towards target by t
+	 * @param datum : Float, Vector or Matrix Datum
+	 * @param target : Datum of the same type and size
+	 * @param t : 0 leaves datum as is, 1 copies target
+	*/
+	void DatumMath::Lerp(Datum& datum, const Datum& target, float t) {
+		CheckOperands(datum, target);
+		std::span<float> floats = FloatsOf(datum);
+		ForEach(floats.data(), FloatsOf(target).data(), floats.size(), [t](auto x, auto y) {
+			return Simd::MulAdd(Simd::Sub(y, x), Broadcast<decltype(x)>(t), x);
+		});
+	}
+
+	/** Transform
+	 * @brief Multiplies every Vector or Matrix in datum by transform, transform on the left
+	 * @param datum : Vector or Matrix Datum
+	 * @param transform
+	*/
+	void DatumMath::Transform(Datum& datum, const glm::mat4& transform) {
+		if (datum.CheckType(Datum::Vector)) {
+			std::span<glm::vec4> vectors = datum.AsSpan<glm::vec4>();
+			TransformVectors(vectors.data(), vectors.size(), transform);
+		}
+		else if (datum.CheckType(Datum::Matrix)) {
+			// Column j of transform * m is transform * m[j], so every column is transformed as a vector
+			std::span<glm::mat4> matrices = datum.AsSpan<glm::mat4>();
+			TransformVectors(reinterpret_cast<glm::vec4*>(matrices.data()), matrices.size() * 4, transform);
+		}
+		else {
+			throw std::runtime_error("Datum is not of type Vector or Matrix");
+		}
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "Datum.h"
+
+namespace Fiea::GameEngine {
+
+	/** DatumMath
+	 * @brief Bulk arithmetic over every element of a numeric Datum. Float, Vector and Matrix Datums are
+	 * processed as flat float arrays (component wise) with SSE, or AVX when the build targets it, and a
+	 * scalar loop for the remainder or when no SIMD is available. Int Datums use integer loops with the
+	 * scalar arguments truncated to int, the same way ActionIncrement treats its Value.
+	 * Everything works in place, so external storage (prescribed attributes) can be updated too.
+	*/
+	class DatumMath final {
+	public:
+		DatumMath() = delete;
+
+		// datum[i] += scalar
+		static void Add(Datum& datum, float scalar);
+		// datum[i] += other[i]
+		static void Add(Datum& datum, const Datum& other);
+
+		// datum[i] *= scalar
+		static void Multiply(Datum& datum, float scalar);
+		// datum[i] *= other[i]
+		static void Multiply(Datum& datum, const Datum& other);
+
+		// datum[i] = datum[i] * scale + offset
+		static void MultiplyAdd(Datum& datum, float scale, float offset);
+		// datum[i] += other[i] * scale, e.g. positions += velocities * deltaTime
+		static void MultiplyAdd(Datum& datum, const Datum& other, float scale);
+
+		// datum[i] = min(max(datum[i], min), max)
+		static void Clamp(Datum& datum, float min, float max);
+
+		// datum[i] += (target[i] - datum[i]) * t, Float, Vector and Matrix only
+		static void Lerp(Datum& datum, const Datum& target, float t);
+
+		// Vector Datums: v = transform * v, Matrix Datums: m = transform * m
+		static void Transform(Datum& datum, const glm::mat4& transform);
+	};
+}
@@ -0,0 +1,304 @@
+#include "pch.h"
+#include "EntityStore.h"
+#include "GameObject.h"
+#include <algorithm>
+
+namespace Fiea::GameEngine {
+	namespace {
+		/** MakeValues
+		 * @brief Sets values to an empty column holding attributes of type
+		 * @return false if no column holds type
+		*/
+		template<class Values>
+		bool MakeValues(Datum::DatumType type, Values& values) {
+			switch (type) {
+			case Datum::DatumType::Int: values.template emplace<std::vector<int>>(); return true;
+			case Datum::DatumType::Float: values.template emplace<std::vector<float>>(); return true;
+			case Datum::DatumType::String: values.template emplace<std::vector<std::string>>(); return true;
+			case Datum::DatumType::Vector: values.template emplace<std::vector<glm::vec4>>(); return true;
+			case Datum::DatumType::Matrix: values.template emplace<std::vector<glm::mat4>>(); return true;
+			default: return false;
+			}
+		}
+
+		// Address of the first element of row
+		template<class Values>
+		char* RowOf(Values& values, std::uint32_t size, std::uint32_t row) {
+			return std::visit([size, row](auto& column) { return reinterpret_cast<char*>(column.data() + std::size_t(row) * size); }, values);
+		}
+	}
+
+	// Destructor, hands every object its attributes back
+	EntityStore::~EntityStore()
+	{
+		Clear();
+	}
+
+	/** FindColumn
+	 * @param key : prescribed attribute
+	 * @return its column, nullptr if the archetype has none for it
+	*/
+	const EntityStore::Archetype::ColumnData* EntityStore::Archetype::FindColumn(Symbol key) const
+	{
+		for (const ColumnData& column : _columns) {
+			if (column.Key == key) {
+				return &column;
+			}
+		}
+		return nullptr;
+	}
+
+	/** Add
+	 * @brief Stores the prescribed attributes of object in the columns of its type's Archetype, copied over from its
+	 * members. Its attributes view its row from now on. Objects already in this store are skipped, one in another
+	 * store, or a GameObject managed by a TransformSystem, throws runtime_error.
+	 * @param object : Attributed to store
+	*/
+	void EntityStore::Add(Attributed& object)
+	{
+		if (object._entityBinding.Store == this) {
+			return;
+		}
+		if (object._entityBinding.Store != nullptr) {
+			throw std::runtime_error("Attributed is stored in another EntityStore");
+		}
+		const GameObject* gameObject = object.As<GameObject>();
+		if (gameObject != nullptr && gameObject->GetTransformSystem() != nullptr) {
+			throw std::runtime_error("GameObject is managed by a TransformSystem");
+		}
+
+		Archetype& archetype = ArchetypeOf(object);
+		const std::uint32_t row = static_cast<std::uint32_t>(archetype._objects.size());
+		const char* members = reinterpret_cast<const char*>(&object);
+		bool moved = false;
+		for (Archetype::ColumnData& column : archetype._columns) {
+			std::visit([&column, &moved, members](auto& values) {
+				using T = typename std::remove_reference_t<decltype(values)>::value_type;
+				const T* first = reinterpret_cast<const T*>(members + column.Offset);
+				const T* data = values.data();
+				values.insert(values.end(), first, first + column.Size);
+				moved |= values.data() != data;
+			}, column.Data);
+		}
+		archetype._objects.push_back(&object);
+		object._entityBinding.Store = this;
+		object._entityBinding.Archetype = _index.at(archetype._type);
+		object._entityBinding.Row = row;
+		++_size;
+
+		// Growing may have moved the columns every stored attribute views
+		if (moved) {
+			BindAll(archetype);
+		}
+		else {
+			Bind(archetype, row);
+		}
+	}
+
+	/** Remove
+	 * @brief Stops storing object, its row moves back into its members, which the attributes view again. The last row
+	 * of the Archetype fills the gap. Throws invalid_argument if object is not in this store.
+	 * @param object : stored Attributed
+	*/
+	void EntityStore::Remove(Attributed& object)
+	{
+		if (object._entityBinding.Store != this) {
+			throw std::invalid_argument("Attributed is not in this EntityStore");
+		}
+		Release(object);
+		Erase(object);
+	}
+
+	/** Clear
+	 * @brief Stops storing every object, see Remove. The Archetypes stay, empty.
+	*/
+	void EntityStore::Clear()
+	{
+		for (const std::unique_ptr<Archetype>& archetype : _archetypes) {
+			for (Attributed* object : archetype->_objects) {
+				Release(*object);
+				object->_entityBinding.Store = nullptr;
+			}
+			archetype->_objects.clear();
+			for (Archetype::ColumnData& column : archetype->_columns) {
+				std::visit([](auto& values) { values.clear(); }, column.Data);
+			}
+		}
+		_size = 0;
+	}
+
+	/** Reserve
+	 * @brief Makes room for capacity objects of type so adding them never moves the columns
+	 * @param type : type id of the objects, registered with TypeManager
+	 * @param capacity : number of objects
+	*/
+	void EntityStore::Reserve(RTTI::IdType type, std::size_t capacity)
+	{
+		Archetype* archetype = Find(type);
+		if (archetype == nullptr) {
+			// Made the way ArchetypeOf makes it, from the type's layout
+			_index.emplace(type, static_cast<std::uint32_t>(_archetypes.size()));
+			archetype = _archetypes.emplace_back(std::unique_ptr<Archetype>(new Archetype(type))).get();
+			for (const AttributeLayout::Entry& entry : TypeManager::layout(type).Entries()) {
+				Archetype::ColumnData column{ entry.Key, entry.Type, entry.Size, entry.Offset };
+				if (entry.Offset != 0 && MakeValues(entry.Type, column.Data)) {
+					archetype->_columns.push_back(std::move(column));
+				}
+			}
+		}
+		bool moved = false;
+		for (Archetype::ColumnData& column : archetype->_columns) {
+			std::visit([&column, &moved, capacity](auto& values) {
+				const auto* data = values.data();
+				values.reserve(capacity * column.Size);
+				moved |= values.data() != data;
+			}, column.Data);
+		}
+		archetype->_objects.reserve(capacity);
+		if (moved) {
+			BindAll(*archetype);
+		}
+	}
+
+	/** Sync
+	 * @brief Copies the row of a stored object into its members, for code reading them directly
+	 * @param object : Attributed in this store
+	*/
+	void EntityStore::Sync(const Attributed& object) const
+	{
+		if (object._entityBinding.Store != this) {
+			throw std::invalid_argument("Attributed is not in this EntityStore");
+		}
+		// The members are a stale copy of the row while the object is stored, bringing them up to date changes
+		// nothing the object's attributes show
+		char* members = reinterpret_cast<char*>(const_cast<Attributed*>(&object));
+		const Archetype& archetype = *_archetypes[object._entityBinding.Archetype];
+		const std::size_t row = object._entityBinding.Row;
+		for (const Archetype::ColumnData& column : archetype._columns) {
+			std::visit([&column, members, row](const auto& values) {
+				using T = typename std::remove_reference_t<decltype(values)>::value_type;
+				std::copy_n(values.data() + row * column.Size, column.Size, reinterpret_cast<T*>(members + column.Offset));
+			}, column.Data);
+		}
+	}
+
+	/** Sync
+	 * @brief Syncs every stored object
+	*/
+	void EntityStore::Sync() const
+	{
+		for (const std::unique_ptr<Archetype>& archetype : _archetypes) {
+			for (const Attributed* object : archetype->_objects) {
+				Sync(*object);
+			}
+		}
+	}
+
+	/** Find
+	 * @param type : type id of stored objects
+	 * @return the Archetype of type, nullptr if no object of type was stored or reserved for yet
+	*/
+	EntityStore::Archetype* EntityStore::Find(RTTI::IdType type)
+	{
+		const auto found = _index.find(type);
+		return found != _index.end() ? _archetypes[found->second].get() : nullptr;
+	}
+
+	const EntityStore::Archetype* EntityStore::Find(RTTI::IdType type) const
+	{
+		return const_cast<EntityStore*>(this)->Find(type);
+	}
+
+	/** ArchetypeOf
+	 * @brief The Archetype of object's type, made on first use with a column for each prescribed attribute kept in a
+	 * member, apart from Pointers. The type's registered layout decides which attributes those are.
+	 * @param object : Attributed about to be stored
+	 * @return its Archetype
+	*/
+	EntityStore::Archetype& EntityStore::ArchetypeOf(const Attributed& object)
+	{
+		const RTTI::IdType type = object.TypeIdInstance();
+		Archetype* archetype = Find(type);
+		if (archetype == nullptr) {
+			Reserve(type, 0);
+			archetype = Find(type);
+		}
+		return *archetype;
+	}
+
+	/** Bind
+	 * @brief Points the attributes of the object in row at its row
+	 * @param archetype : Archetype holding the row
+	 * @param row : row of the object
+	*/
+	void EntityStore::Bind(Archetype& archetype, std::uint32_t row)
+	{
+		Attributed& object = *archetype._objects[row];
+		for (Archetype::ColumnData& column : archetype._columns) {
+			Datum* attribute = object.Find(column.Key);
+			if (attribute != nullptr) {
+				attribute->SetStorage(RowOf(column.Data, column.Size, row), column.Size, column.Type);
+			}
+		}
+	}
+
+	/** BindAll
+	 * @brief Binds every row of archetype, after its columns moved
+	 * @param archetype : Archetype to bind
+	*/
+	void EntityStore::BindAll(Archetype& archetype)
+	{
+		for (std::uint32_t row = 0; row < archetype._objects.size(); ++row) {
+			Bind(archetype, row);
+		}
+	}
+
+	/** Release
+	 * @brief Moves the row of object into its members and points its attributes back at them, the row stays
+	 * @param object : stored Attributed
+	*/
+	void EntityStore::Release(Attributed& object)
+	{
+		char* members = reinterpret_cast<char*>(&object);
+		Archetype& archetype = *_archetypes[object._entityBinding.Archetype];
+		const std::size_t row = object._entityBinding.Row;
+		for (Archetype::ColumnData& column : archetype._columns) {
+			std::visit([&column, members, row](auto& values) {
+				using T = typename std::remove_reference_t<decltype(values)>::value_type;
+				T* first = values.data() + row * column.Size;
+				std::move(first, first + column.Size, reinterpret_cast<T*>(members + column.Offset));
+			}, column.Data);
+			Datum* attribute = object.Find(column.Key);
+			if (attribute != nullptr) {
+				attribute->SetStorage(members + column.Offset, column.Size, column.Type);
+			}
+		}
+	}
+
+	/** Erase
+	 * @brief Drops the row of object without touching the object, the last row fills the gap
+	 * @param object : stored Attributed, possibly being destroyed
+	*/
+	void EntityStore::Erase(Attributed& object)
+	{
+		Archetype& archetype = *_archetypes[object._entityBinding.Archetype];
+		const std::uint32_t row = object._entityBinding.Row;
+		const std::uint32_t last = static_cast<std::uint32_t>(archetype._objects.size() - 1);
+		for (Archetype::ColumnData& column : archetype._columns) {
+			std::visit([&column, row, last](auto& values) {
+				if (row != last) {
+					std::move(values.begin() + std::size_t(last) * column.Size, values.end(), values.begin() + std::size_t(row) * column.Size);
+				}
+				values.resize(std::size_t(last) * column.Size);
+			}, column.Data);
+		}
+		if (row != last) {
+			archetype._objects[row] = archetype._objects[last];
+			archetype._objects[row]->_entityBinding.Row = row;
+			Bind(archetype, row);
+		}
+		archetype._objects.pop_back();
+		object._entityBinding.Store = nullptr;
+		--_size;
+	}
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include "Attributed.h"
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace Fiea::GameEngine {
+
+	/** EntityStore
+	 * @brief Optional archetype storage for the prescribed attributes of Attributed objects. The stored objects of one
+	 * type form an Archetype, and every prescribed attribute the type keeps in a member gets a column there: one
+	 * contiguous array holding that attribute for each of the archetype's objects. The attributes of a stored object
+	 * view its row, so the Scope and Datum API stays the same while systems walk a whole column without touching the
+	 * objects. The members behind the attributes are out of date while an object is stored, Sync and Remove copy the
+	 * columns back into them. Code that may run on stored objects reads the attributes instead (see GameObject's
+	 * GetTransform). A GameObject is either in a TransformSystem or stored here, not both.
+	*/
+	class EntityStore final {
+	public:
+		/** Archetype
+		 * @brief The stored objects of one type and their columns, row i of every column belongs to Objects()[i].
+		 * Adding objects may move the columns, spans from Column last until the next Add or Remove.
+		*/
+		class Archetype final {
+		public:
+			RTTI::IdType Type() const { return _type; };
+			std::size_t Size() const { return _objects.size(); };
+			std::span<Attributed* const> Objects() const { return _objects; };
+			bool HasColumn(Symbol key) const { return FindColumn(key) != nullptr; };
+
+			template<class T>
+			std::span<T> Column(Symbol key);
+			template<class T>
+			std::span<const T> Column(Symbol key) const;
+
+		private:
+			friend EntityStore;
+			using Values = std::variant<std::vector<int>, std::vector<float>, std::vector<std::string>, std::vector<glm::vec4>, std::vector<glm::mat4>>;
+
+			// One prescribed attribute, Size elements per row
+			struct ColumnData {
+				Symbol Key;
+				Datum::DatumType Type;
+				std::uint32_t Size;
+				std::size_t Offset;
+				Values Data;
+			};
+
+			explicit Archetype(RTTI::IdType type) : _type(type) {};
+			const ColumnData* FindColumn(Symbol key) const;
+
+			RTTI::IdType _type;
+			std::vector<ColumnData> _columns;
+			std::vector<Attributed*> _objects;
+		};
+
+		EntityStore() = default;
+		~EntityStore();
+
+		// Objects point back at the store, which can't be copied or moved
+		EntityStore(const EntityStore& other) = delete;
+		EntityStore& operator=(const EntityStore& rhs) = delete;
+		EntityStore(EntityStore&& other) = delete;
+		EntityStore& operator=(EntityStore&& rhs) = delete;
+
+		void Add(Attributed& object);
+		void Remove(Attributed& object);
+		void Clear();
+		void Reserve(RTTI::IdType type, std::size_t capacity);
+
+		void Sync(const Attributed& object) const;
+		void Sync() const;
+
+		bool Contains(const Attributed& object) const { return object._entityBinding.Store == this; };
+		std::size_t Size() const { return _size; };
+
+		Archetype* Find(RTTI::IdType type);
+		const Archetype* Find(RTTI::IdType type) const;
+
+	private:
+		friend Attributed;
+
+		Archetype& ArchetypeOf(const Attributed& object);
+		void Bind(Archetype& archetype, std::uint32_t row);
+		void BindAll(Archetype& archetype);
+		void Release(Attributed& object);
+		void Erase(Attributed& object);
+
+		std::vector<std::unique_ptr<Archetype>> _archetypes;
+		std::unordered_map<RTTI::IdType, std::uint32_t> _index; // type id to its Archetype
+		std::size_t _size = 0;
+	};
+
+	/** Column
+	 * @brief Every row of one attribute, Size elements of the attribute per row
+	 * @tparam T : element type of the attribute
+	 * @param key : prescribed attribute of the archetype's type, invalid_argument if it has no column
+	 * @return span over the column, runtime_error if T is not its element type
+	*/
+	template<class T>
+	std::span<T> EntityStore::Archetype::Column(Symbol key)
+	{
+		const std::span<const T> column = std::as_const(*this).Column<T>(key);
+		return std::span<T>(const_cast<T*>(column.data()), column.size());
+	}
+
+	template<class T>
+	std::span<const T> EntityStore::Archetype::Column(Symbol key) const
+	{
+		const ColumnData* column = FindColumn(key);
+		if (column == nullptr) {
+			throw std::invalid_argument("Archetype has no column " + key.Name());
+		}
+		const std::vector<T>* values = std::get_if<std::vector<T>>(&column->Data);
+		if (values == nullptr) {
+			throw std::runtime_error("Column is not of the requested type");
+		}
+		return std::span<const T>(values->data(), values->size());
+	}
+}
@@ -0,0 +1,244 @@
+#include "pch.h"
+#include "FlatScopeStorage.h"
+
+namespace Fiea::GameEngine {
+
+	/** Capacity constructor
+	 * @brief Allocates room for initCapacity entries up front
+	 * @param initCapacity : number of entries to reserve
+	*/
+	FlatScopeStorage::FlatScopeStorage(std::size_t initCapacity) {
+		Reserve(initCapacity);
+	}
+
+	/** Resource constructor
+	 * @brief Allocates everything from resource, nullptr picks the heap
+	 * @param resource
+	*/
+	FlatScopeStorage::FlatScopeStorage(std::pmr::memory_resource* resource) :
+		_resource(resource != nullptr ? resource : HeapResource::Get()), _segments(_resource), _slots(_resource) {}
+
+	// Destructor
+	FlatScopeStorage::~FlatScopeStorage() {
+		Release();
+	}
+
+	/**
+	 * @brief Move constructor, steals other's segments and index along with the resource they came from
+	 * @param other
+	*/
+	FlatScopeStorage::FlatScopeStorage(FlatScopeStorage&& other) noexcept : _resource(other._resource),
+		_segments(std::move(other._segments)), _slots(std::move(other._slots)), _firstSegmentShift(other._firstSegmentShift),
+		_slotShift(other._slotShift), _size(other._size) {
+		other._segments.clear();
+		other._slots.clear();
+		other._slotShift = 0;
+		other._size = 0;
+	}
+
+	/**
+	 * @brief Move assignment, releases current entries before stealing rhs'. Segments from another resource can't be
+	 * adopted, rhs' entries are moved one by one into this storage's own memory instead.
+	 * @param rhs
+	 * @return this storage
+	*/
+	FlatScopeStorage& FlatScopeStorage::operator=(FlatScopeStorage&& rhs) noexcept {
+		if (&rhs != this && *rhs._resource != *_resource) {
+			Release();
+			Reserve(rhs._size);
+			for (std::size_t i = 0; i < rhs._size; ++i) {
+				new(Claim(rhs[i].Key)) Entry{ rhs[i].Key, Datum(std::allocator_arg, Datum::allocator_type(_resource), std::move(rhs[i].Value)) };
+			}
+			rhs.Release();
+		}
+		else if (&rhs != this) {
+			Release();
+			_segments = std::move(rhs._segments);
+			_slots = std::move(rhs._slots);
+			_firstSegmentShift = rhs._firstSegmentShift;
+			_slotShift = rhs._slotShift;
+			_size = rhs._size;
+			rhs._segments.clear();
+			rhs._slots.clear();
+			rhs._slotShift = 0;
+			rhs._size = 0;
+		}
+		return *this;
+	}
+
+	/** Find
+	 * @brief Probes the index for key
+	 * @param key
+	 * @return Datum* of the entry with key, nullptr if there is none
+	*/
+	Datum* FlatScopeStorage::Find(Symbol key) {
+		return const_cast<Datum*>(static_cast<const FlatScopeStorage&>(*this).Find(key));
+	}
+
+	const Datum* FlatScopeStorage::Find(Symbol key) const {
+		if (_slots.empty()) {
+			return nullptr;
+		}
+		const std::size_t mask = _slots.size() - 1;
+		for (std::size_t slot = SlotOf(key.Id()); ; slot = (slot + 1) & mask) {
+			// Key 0 marks an empty slot, so an invalid key never matches one
+			const Slot& current = _slots[slot];
+			if (current.Key == 0) {
+				return nullptr;
+			}
+			if (current.Key == key.Id()) {
+				return &(*this)[current.Index].Value;
+			}
+		}
+	}
+
+	/** Append
+	 * @brief Returns the entry associated with key, constructing a new empty one at the end if needed
+	 * @param key
+	 * @param created : optional output set to true if a new entry was made
+	 * @return Entry& associated with key
+	*/
+	FlatScopeStorage::Entry& FlatScopeStorage::Append(Symbol key, bool* created) {
+		if (!key.IsValid()) {
+			throw std::invalid_argument("Can't append an invalid Symbol");
+		}
+		Datum* existing = Find(key);
+		if (existing != nullptr) {
+			if (created != nullptr) *created = false;
+			// Value is the second member of Entry, step back to the entry itself
+			return *reinterpret_cast<Entry*>(reinterpret_cast<char*>(existing) - offsetof(Entry, Value));
+		}
+		if (created != nullptr) *created = true;
+		return *new(Claim(key)) Entry{ key, Datum(std::allocator_arg, Datum::allocator_type(_resource)) };
+	}
+
+	/** Claim
+	 * @brief Makes room for a new entry at the end and indexes it under key, key must not be in the storage yet
+	 * @param key
+	 * @return uninitialized memory the caller constructs the Entry in
+	*/
+	FlatScopeStorage::Entry* FlatScopeStorage::Claim(Symbol key) {
+		if (_size == Capacity()) {
+			if (_segments.empty()) {
+				Reserve(4);
+			}
+			else {
+				AddSegment();
+			}
+		}
+		// Keep the index at most 3/4 full so probe sequences stay short
+		if ((_size + 1) * 4 > _slots.size() * 3) {
+			Rehash(_slots.empty() ? 8 : _slots.size() * 2);
+		}
+
+		Entry* entry = &(*this)[_size];
+
+		const std::size_t mask = _slots.size() - 1;
+		std::size_t slot = SlotOf(key.Id());
+		while (_slots[slot].Key != 0) {
+			slot = (slot + 1) & mask;
+		}
+		_slots[slot] = { key.Id(), static_cast<std::uint32_t>(_size) };
+		++_size;
+		return entry;
+	}
+
+	/** Capacity
+	 * @return number of entries the allocated segments can hold
+	*/
+	std::size_t FlatScopeStorage::Capacity() const {
+		return (((std::size_t)1 << _segments.size()) - 1) << _firstSegmentShift;
+	}
+
+	/** Reserve
+	 * @brief Makes sure capacity entries fit without allocating again
+	 * @param capacity
+	*/
+	void FlatScopeStorage::Reserve(std::size_t capacity) {
+		if (_segments.empty()) {
+			// The first segment decides the size of all the following ones
+			_firstSegmentShift = std::countr_zero(std::bit_ceil(capacity < 4 ? (std::size_t)4 : capacity));
+			AddSegment();
+		}
+		while (Capacity() < capacity) {
+			AddSegment();
+		}
+		// Never fewer than the 8 slots Append starts with, SlotOf can't shift by the full 32 bits of a single slot index
+		std::size_t slotCount = std::bit_ceil(std::max((capacity * 4) / 3 + 1, (std::size_t)8));
+		if (slotCount > _slots.size()) {
+			Rehash(slotCount);
+		}
+	}
+
+	/** CopyFrom
+	 * @brief Copy constructs other's entries at the same positions and takes over its index, so nothing is hashed or
+	 * probed. Nested Tables are copied like any other Datum, cloning them is up to the Scope.
+	 * @param other : storage to copy
+	*/
+	void FlatScopeStorage::CopyFrom(const FlatScopeStorage& other) {
+		Clear();
+		if (_segments.empty()) {
+			_firstSegmentShift = std::countr_zero(std::bit_ceil(other._size < 4 ? (std::size_t)4 : other._size));
+		}
+		while (Capacity() < other._size) {
+			AddSegment();
+		}
+		for (std::size_t i = 0; i < other._size; ++i) {
+			new(&(*this)[i]) Entry{ other[i].Key, Datum(std::allocator_arg, Datum::allocator_type(_resource), other[i].Value) };
+			++_size;
+		}
+		// Positions match other's, so its index is valid for this storage too
+		_slots.assign(other._slots.begin(), other._slots.end());
+		_slotShift = other._slotShift;
+	}
+
+	/** Clear
+	 * @brief Destroys every entry but keeps the segments and index allocated
+	*/
+	void FlatScopeStorage::Clear() {
+		for (std::size_t i = 0; i < _size; ++i) {
+			(*this)[i].~Entry();
+		}
+		_size = 0;
+		std::fill(_slots.begin(), _slots.end(), Slot{ 0, 0 });
+	}
+
+	// Fibonacci hashing, Symbol ids are sequential so the multiply spreads them over the table
+	std::size_t FlatScopeStorage::SlotOf(Symbol::IdType key) const {
+		return (std::size_t)((key * 2654435769u) >> (32 - _slotShift));
+	}
+
+	/** Rehash
+	 * @brief Rebuilds the index with slotCount slots
+	 * @param slotCount : power of two number of slots
+	*/
+	void FlatScopeStorage::Rehash(std::size_t slotCount) {
+		_slots.assign(slotCount, Slot{ 0, 0 });
+		_slotShift = std::countr_zero(slotCount);
+		const std::size_t mask = slotCount - 1;
+		for (std::size_t i = 0; i < _size; ++i) {
+			Symbol::IdType key = (*this)[i].Key.Id();
+			std::size_t slot = SlotOf(key);
+			while (_slots[slot].Key != 0) {
+				slot = (slot + 1) & mask;
+			}
+			_slots[slot] = { key, static_cast<std::uint32_t>(i) };
+		}
+	}
+
+	// Allocates the next segment, twice the size of the previous one
+	void FlatScopeStorage::AddSegment() {
+		_segments.push_back(static_cast<Entry*>(_resource->allocate(SegmentBytes(_segments.size()), alignof(Entry))));
+	}
+
+	// Destroys every entry and frees all memory
+	void FlatScopeStorage::Release() {
+		Clear();
+		for (std::size_t i = 0; i < _segments.size(); ++i) {
+			_resource->deallocate(_segments[i], SegmentBytes(i), alignof(Entry));
+		}
+		_segments.clear();
+		_slots.clear();
+		_slotShift = 0;
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "Datum.h"
+#include "Symbol.h"
+#include "HeapResource.h"
+#include <vector>
+#include <bit>
+#include <memory_resource>
+
+namespace Fiea::GameEngine {
+
+	/** FlatScopeStorage
+	 * @brief Attribute storage for Scopes created with Scope::Storage::Flat. Entries (key + Datum) live
+	 * contiguously in insertion order and a compact open addressing index of (key, position) pairs maps keys
+	 * to them, so Find, iteration by index and copying touch a few cache lines instead of hash map nodes.
+	 * Entries are allocated in segments that double in size, growing never moves an existing Datum so
+	 * Datum pointers stay valid just like with the node based layout. Segments, the index and the entries' Datums
+	 * all allocate from the memory_resource given at construction (the HeapResource otherwise).
+	*/
+	class FlatScopeStorage final {
+	public:
+		struct Entry {
+			Symbol Key;
+			Datum Value;
+		};
+
+		FlatScopeStorage() = default;
+		explicit FlatScopeStorage(std::size_t initCapacity);
+		explicit FlatScopeStorage(std::pmr::memory_resource* resource);
+		~FlatScopeStorage();
+
+		// Copying is driven by Scope since nested tables have to be cloned
+		FlatScopeStorage(const FlatScopeStorage& other) = delete;
+		FlatScopeStorage& operator=(const FlatScopeStorage& rhs) = delete;
+
+		FlatScopeStorage(FlatScopeStorage&& other) noexcept;
+		FlatScopeStorage& operator=(FlatScopeStorage&& rhs) noexcept;
+
+		Datum* Find(Symbol key);
+		const Datum* Find(Symbol key) const;
+
+		// Returns the entry for key, creating an empty Datum at the end if key is new
+		Entry& Append(Symbol key, bool* created = nullptr);
+
+		// Entry at idx in insertion order, segment k starts at ((1 << k) - 1) << _firstSegmentShift
+		Entry& operator[](std::size_t idx) { return const_cast<Entry&>(static_cast<const FlatScopeStorage&>(*this)[idx]); };
+		const Entry& operator[](std::size_t idx) const {
+			std::size_t segment = std::bit_width((idx >> _firstSegmentShift) + 1) - 1;
+			return _segments[segment][idx - ((((std::size_t)1 << segment) - 1) << _firstSegmentShift)];
+		};
+
+		std::size_t Size() const { return _size; };
+		std::size_t Capacity() const;
+
+		void Reserve(std::size_t capacity);
+
+		// Replaces the entries with copies of other's, reusing other's index as is
+		void CopyFrom(const FlatScopeStorage& other);
+
+		// Destroys every entry, keeping the allocated segments for reuse
+		void Clear();
+
+		std::pmr::memory_resource* GetResource() const { return _resource; };
+
+	private:
+		struct Slot {
+			Symbol::IdType Key;
+			std::uint32_t Index;
+		};
+
+		std::size_t SlotOf(Symbol::IdType key) const;
+		void Rehash(std::size_t slotCount);
+		Entry* Claim(Symbol key);
+		std::size_t SegmentBytes(std::size_t segment) const { return sizeof(Entry) * (((std::size_t)1 << _firstSegmentShift) << segment); };
+		void AddSegment();
+		void Release();
+
+		std::pmr::memory_resource* _resource = HeapResource::Get();
+		std::pmr::vector<Entry*> _segments{ _resource };	// segment k holds (1 << _firstSegmentShift) << k entries
+		std::pmr::vector<Slot> _slots{ _resource };			// power of two sized, Key 0 marks an empty slot
+		std::size_t _firstSegmentShift = 2;
+		std::size_t _slotShift = 0;
+		std::size_t _size = 0;
+	};
+}
@@ -2,12 +2,117 @@
 #include "GameObject.h"
 #include "Action.h"
 #include "Factory.h"
+#include "TransformSystem.h"
+#include "JobSystem.h"
+#include <utility>
+#include <algorithm>
+#include <atomic>
 
 using namespace std::string_literals;
 
 namespace Fiea::GameEngine {
 	RTTI_DEFINITIONS(GameObject);
 
+	const Symbol GameObject::ChildrenKey("Children");
+	const Symbol GameObject::ActionsKey("Actions");
+	const Symbol GameObject::PositionKey("Position");
+	const Symbol GameObject::RotationKey("Rotation");
+	const Symbol GameObject::ScaleKey("Scale");
+
+	// Destructor, leaves the TransformSystem managing this object and the Update lists holding it
+	GameObject::~GameObject()
+	{
+		GameObject* parent = ParentObject();
+		if (parent != nullptr) {
+			parent->InvalidateUpdateList();
+		}
+		if (_transformBinding.System != nullptr) {
+			_transformBinding.System->Remove(*this);
+		}
+	}
+
+	/**
+	 * @brief Copy constructor, the copy's ObjTransform holds rhs' current transform
+	 * @param rhs
+	*/
+	GameObject::GameObject(const GameObject& rhs) : Attributed(rhs), Name(rhs.Name), ObjTransform(rhs.GetTransform()), Updated(rhs.Updated) {}
+
+	/**
+	 * @brief Move constructor, rhs stays in its TransformSystem
+	 * @param rhs
+	*/
+	GameObject::GameObject(GameObject&& rhs) noexcept : Attributed(std::move(rhs)), Name(std::move(rhs.Name)), ObjTransform(rhs.GetTransform()), Updated(rhs.Updated) {}
+
+	/**
+	 * @brief Copy assignment, a managed object keeps its slot and takes rhs' transform there
+	 * @param rhs
+	 * @return this object
+	*/
+	GameObject& GameObject::operator=(const GameObject& rhs)
+	{
+		if (&rhs != this) {
+			const Transform transform = rhs.GetTransform();
+			Attributed::operator=(rhs);
+			Name = rhs.Name;
+			Updated = rhs.Updated;
+			SetTransform(transform);
+			InvalidateUpdateList();
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Move assignment, a managed object keeps its slot and takes rhs' transform there
+	 * @param rhs
+	 * @return this object
+	*/
+	GameObject& GameObject::operator=(GameObject&& rhs) noexcept
+	{
+		if (&rhs != this) {
+			const Transform transform = rhs.GetTransform();
+			Attributed::operator=(std::move(rhs));
+			Name = std::move(rhs.Name);
+			Updated = rhs.Updated;
+			SetTransform(transform);
+			InvalidateUpdateList();
+		}
+		return *this;
+	}
+
+	/** GetTransform
+	 * @brief Local transform of the object, read from its TransformSystem or EntityStore when it has one
+	 * @return Position, Rotation and Scale
+	*/
+	Transform GameObject::GetTransform() const
+	{
+		if (_transformBinding.System != nullptr) {
+			return _transformBinding.System->Local(*this);
+		}
+		if (GetEntityStore() != nullptr) {
+			return { Find(PositionKey)->Get<Vec4>(), Find(RotationKey)->Get<Vec4>(), Find(ScaleKey)->Get<Vec4>() };
+		}
+		return ObjTransform;
+	}
+
+	/** SetTransform
+	 * @brief Sets the local transform, in the object's TransformSystem or EntityStore when it has one
+	 * @param transform : Position, Rotation and Scale
+	*/
+	void GameObject::SetTransform(const Transform& transform)
+	{
+		if (_transformBinding.System != nullptr) {
+			_transformBinding.System->SetLocal(*this, transform);
+			return;
+		}
+		if (GetEntityStore() != nullptr) {
+			Find(PositionKey)->Get<Vec4>() = transform.Position;
+			Find(RotationKey)->Get<Vec4>() = transform.Rotation;
+			Find(ScaleKey)->Get<Vec4>() = transform.Scale;
+			return;
+		}
+		ObjTransform = transform;
+	}
+
 	/** Clone
 	 * @brief Clone method to replicate GameObjects 
 	 * @return new GameObject pointer
@@ -17,28 +122,293 @@ namespace Fiea::GameEngine {
 		return new GameObject(*this);
 	}
 
+	/** ForEachChild
+	 * @brief Calls visit on every child GameObject, looking through the wrapper Scopes AddChild puts them in
+	 * @param visit : callable taking GameObject&
+	*/
+	template<class Visit>
+	void GameObject::ForEachChild(Visit&& visit)
+	{
+		Datum* children = Find(ChildrenKey);
+		for (size_t idx = 0; idx < children->Size(); ++idx) {
+			Scope* wrapper = children->GetScope(idx);
+			for (std::uint32_t named = 0; named < wrapper->GetSize(); ++named) {
+				Datum& datum = (*wrapper)[named];
+				for (size_t element = 0; element < datum.Size(); ++element) {
+					// No need to check if it is a Game Object since Add Child checks for that
+					visit(*datum.GetScope(element)->As<GameObject>());
+				}
+			}
+		}
+	}
+
 	/** Update
-	 * @brief Update method
+	 * @brief Updates the Actions of this object and its descendants, parents before their children, by ticking the
+	 * list of the awake ones in one loop. The list is only made again after the subtree's Children or Actions changed
+	 * or something in it slept or woke, changes Actions make take effect next Update.
 	 * @param time 
 	*/
 	void Fiea::GameEngine::GameObject::Update(const GameTime& time)
 	{
-		if (Actions()->Size() > 0) {
-			for (int action = 0; action < (int) Actions()->GetScope()->GetSize(); ++action) {
-				Action* currentAction = Actions(action)->GetScope()->As<Action>();
-				currentAction->SetParent(this);
-				currentAction->Update(time);
+		Schedule(time.Game());
+		for (const UpdateEntry& entry : _activeList) {
+			if (entry.Step == nullptr) {
+				entry.Object->Updated = true;
+				continue;
 			}
+			entry.Step->SetParent(entry.Object);
+			entry.Step->Update(time);
 		}
+	}
+
+	/** RebuildUpdateList
+	 * @brief Lists the subtree in the order the recursive Update visited it, walking it without recursion
+	*/
+	void GameObject::RebuildUpdateList()
+	{
+		_updateList.clear();
+		std::vector<std::pair<GameObject*, std::uint32_t>> pending{ { this, 0 } };
+		while (!pending.empty()) {
+			const auto [object, depth] = pending.back();
+			pending.pop_back();
+
+			Datum* actions = object->Find(ActionsKey);
+			if (actions->Size() > 0) {
+				Scope* list = actions->GetScope();
+				for (std::uint32_t idx = 0; idx < list->GetSize(); ++idx) {
+					Datum& named = (*list)[idx];
+					for (size_t element = 0; element < named.Size(); ++element) {
+						Action* action = named.GetScope(element)->As<Action>();
+						if (action == nullptr) {
+							throw std::invalid_argument("Non-Action in the Actions of GameObject " + object->Name);
+						}
+						_updateList.push_back({ object, action, depth });
+					}
+				}
+			}
+			_updateList.push_back({ object, nullptr, depth });
 
-		for (int i = 0; i < (int)Find("Children")->Size(); ++i) {
-			Scope* childScope = Find("Children")->GetScope();
-			GameObject* currentObj = (*childScope)[i].GetScope()->As<GameObject>();
-			// No need to check if it is a Game Object since Add Child checks for that
-			currentObj->Update(time);
+			// Reversed on the stack so the first child comes off it first
+			const std::size_t first = pending.size();
+			object->ForEachChild([&pending, depth](GameObject& child) { pending.push_back({ &child, depth + 1 }); });
+			std::reverse(pending.begin() + first, pending.end());
+		}
+		_updateListStale = false;
+		_activeListStale = true;
+	}
+
+	/** Schedule
+	 * @brief Brings the Update and active lists up to date and wakes the sleepers that are due
+	 * @param now : game time of the Update
+	*/
+	void GameObject::Schedule(Millis now)
+	{
+		if (_updateListStale) {
+			RebuildUpdateList();
+		}
+		if (_activeListStale) {
+			RebuildActiveList(now);
+			return;
+		}
+		// The lists are current, so every sleeper in them is still asleep and alive
+		while (!_timers.empty() && _timers.back()->_until <= now) {
+			_timers.back()->Wake();
+			_timers.pop_back();
+		}
+		for (Sleeper* watcher : _watchers) {
+			if (watcher->Due(now)) {
+				watcher->Wake();
+			}
+		}
+		if (_activeListStale) {
+			RebuildActiveList(now);
+		}
+	}
+
+	/** RebuildActiveList
+	 * @brief Lists the entries of the Update list that are awake and collects the sleepers that may wake on their own.
+	 * Sleepers already due are woken here. Costs a pass over the Update list, made only when something slept or woke.
+	 * @param now : game time of the Update
+	*/
+	void GameObject::RebuildActiveList(Millis now)
+	{
+		_activeList.clear();
+		_timers.clear();
+		_watchers.clear();
+		const auto asleep = [this, now](Sleeper& sleeper) {
+			if (!sleeper.IsAsleep()) {
+				return false;
+			}
+			if (sleeper.Due(now)) {
+				sleeper.Wake();
+				return false;
+			}
+			if (sleeper._until != Never) {
+				_timers.push_back(&sleeper);
+			}
+			if (sleeper._watched != nullptr) {
+				_watchers.push_back(&sleeper);
+			}
+			return true;
 		};
-		Updated = true;
 
+		// Entries of a sleeping object and deeper ones after them belong to its subtree
+		const GameObject* sleeping = nullptr;
+		std::uint32_t sleepingDepth = 0;
+		const GameObject* previous = nullptr;
+		for (const UpdateEntry& entry : _updateList) {
+			if (sleeping != nullptr && (entry.Object == sleeping || entry.Depth > sleepingDepth)) {
+				continue;
+			}
+			sleeping = nullptr;
+			// An object's entries follow each other, its first one decides if it sleeps
+			if (entry.Object != previous) {
+				previous = entry.Object;
+				if (asleep(*entry.Object)) {
+					sleeping = entry.Object;
+					sleepingDepth = entry.Depth;
+					continue;
+				}
+			}
+			if (entry.Step != nullptr && asleep(*entry.Step)) {
+				continue;
+			}
+			_activeList.push_back(entry);
+		}
+		std::sort(_timers.begin(), _timers.end(), [](const Sleeper* lhs, const Sleeper* rhs) { return lhs->_until > rhs->_until; });
+		_activeListStale = false;
+	}
+
+	/** InvalidateActiveList
+	 * @brief Makes the next Update of this object and of every ancestor check which of their subtree sleeps again.
+	 * Actions of the parallel Update may sleep at the same time, so the flags are set atomically.
+	*/
+	void GameObject::InvalidateActiveList()
+	{
+		for (GameObject* object = this; object != nullptr; object = object->ParentObject()) {
+			std::atomic_ref<bool>(object->_activeListStale).store(true, std::memory_order_relaxed);
+		}
+	}
+
+	/** InvalidateUpdateList
+	 * @brief Makes the next Update of this object and of every ancestor list their subtree again
+	*/
+	void GameObject::InvalidateUpdateList()
+	{
+		for (GameObject* object = this; object != nullptr; object = object->ParentObject()) {
+			object->_updateListStale = true;
+		}
+	}
+
+	/** NestedScopesChanged
+	 * @brief Lists the subtree again once Children or Actions, or a wrapper Scope in them, gained or lost a Scope
+	 * @param key : Table of this object that changed
+	*/
+	void GameObject::NestedScopesChanged(Symbol key)
+	{
+		if (key == ChildrenKey || key == ActionsKey) {
+			InvalidateUpdateList();
+		}
+	}
+
+	/** ParentObject
+	 * @return the GameObject holding this one in its Children, nullptr if there is none
+	*/
+	GameObject* GameObject::ParentObject()
+	{
+		Scope* wrapper = GetParent();
+		Scope* owner = wrapper != nullptr ? wrapper->GetParent() : nullptr;
+		return owner != nullptr ? owner->As<GameObject>() : nullptr;
+	}
+
+	/** Update
+	 * @brief Updates this object and its descendants, handing whole subtrees to jobs' workers while some of them
+	 * are idle. Actions whose GetReach is Ancestors are held back and updated on this thread after every subtree
+	 * is done, in tree order. Everything else may only touch its own subtree, and nothing may add or remove
+	 * GameObjects or Actions outside its own subtree while the update runs. Sleepers are skipped as in Update.
+	 * @param time
+	 * @param jobs : workers to use, with none this is the plain Update apart from the held back Actions
+	*/
+	void GameObject::Update(const GameTime& time, JobSystem& jobs)
+	{
+		Schedule(time.Game());
+		if (IsAsleep()) {
+			return;
+		}
+		std::vector<Action*> deferred;
+		UpdateSubtree(time, jobs, deferred);
+		for (Action* action : deferred) {
+			action->Update(time);
+		}
+	}
+
+	/** UpdateSubtree
+	 * @brief One object of the parallel Update, its children are updated here or in jobs
+	 * @param time
+	 * @param jobs : workers to hand children to
+	 * @param deferred : Actions reaching ancestors, appended in tree order
+	*/
+	void GameObject::UpdateSubtree(const GameTime& time, JobSystem& jobs, std::vector<Action*>& deferred)
+	{
+		Datum* actions = Find(ActionsKey);
+		if (actions->Size() > 0) {
+			Scope* list = actions->GetScope();
+			for (std::uint32_t idx = 0; idx < list->GetSize(); ++idx) {
+				Datum& named = (*list)[idx];
+				for (size_t element = 0; element < named.Size(); ++element) {
+					Action* action = named.GetScope(element)->As<Action>();
+					if (action == nullptr) {
+						throw std::invalid_argument("Non-Action in the Actions of GameObject " + Name);
+					}
+					if (action->IsAsleep()) {
+						continue;
+					}
+					action->SetParent(this);
+					if (action->GetReach() == Action::Reach::Ancestors) {
+						deferred.push_back(action);
+					}
+					else {
+						action->Update(time);
+					}
+				}
+			}
+		}
+
+		// From the first child handed to a job on, every child collects its held back Actions apart so they can be
+		// appended in order once the jobs are done
+		JobSystem::Group group;
+		std::vector<std::unique_ptr<std::vector<Action*>>> parts;
+		try {
+			ForEachChild([&time, &jobs, &deferred, &group, &parts](GameObject& child) {
+				if (child.IsAsleep()) {
+					return;
+				}
+				if (parts.empty() && !jobs.Hungry()) {
+					child.UpdateSubtree(time, jobs, deferred);
+					return;
+				}
+				std::vector<Action*>& part = *parts.emplace_back(std::make_unique<std::vector<Action*>>());
+				if (jobs.Hungry()) {
+					jobs.Run(group, [&time, &jobs, &child, &part]() { child.UpdateSubtree(time, jobs, part); });
+				}
+				else {
+					child.UpdateSubtree(time, jobs, part);
+				}
+			});
+		}
+		catch (...) {
+			// The jobs still use this frame's locals
+			try {
+				jobs.Wait(group);
+			}
+			catch (...) {}
+			throw;
+		}
+		jobs.Wait(group);
+		for (const auto& part : parts) {
+			deferred.insert(deferred.end(), part->begin(), part->end());
+		}
+		Updated = true;
 	}
 
 	/** AddChild
@@ -51,9 +421,11 @@ namespace Fiea::GameEngine {
 		// Check if it is a game object
 		GameObject* objectTest = child->As<GameObject>();
 		if (objectTest == nullptr) return false;
+		// Parents changed, TransformSystems reorder. Adopting it makes the Update lists again, see NestedScopesChanged
+		InvalidateTransforms(*objectTest);
 		// Due to how you can't have named objects directly in an object array in json
 		// Object arrays or Table arrays will contain wrapper Objects which contain the named Scope
-		Datum* ChildrenDatum = Find("Children"); // Retrieving Children Datum
+		Datum* ChildrenDatum = Find(ChildrenKey); // Retrieving Children Datum
 
 		// Check for any empty wrapper scopes
 		for (int i = 0; i < (int) ChildrenDatum->Size(); ++i) {
@@ -65,8 +437,8 @@ namespace Fiea::GameEngine {
 
 		// Creating and pushing a new Scope as the wrapper of the child
 		Scope* newScope = new Scope; 
-		newScope->SetParent(this);
 		ChildrenDatum->Push(newScope);
+		AttachChild(*newScope, ChildrenKey, ChildrenDatum->Size() - 1);
 		
 		// Wrapper Adopting child
 		newScope->Adopt(*child, objectTest->Name);
@@ -83,31 +455,33 @@ namespace Fiea::GameEngine {
 	*/
 	bool GameObject::RemoveChild(Scope* child)
 	{
+		// Children sit in wrapper Scopes held by the Children Datum, both know where they are held
 		uint32_t idx;
-		Datum* ChildrenDatum = Find("Children");
-		for (int i = 0; i < (int) ChildrenDatum->Size(); ++i) {
-			if (ChildrenDatum->GetScope(i)->FindContainedScope(child, idx) != nullptr) {
-				Scope* ChildScope = ChildrenDatum->GetScope(i);
-				Datum& Child = (*ChildScope)[idx];
-				Child.GetScope()->Orphan();
-				return true;
-			}
+		Scope* wrapper = child->GetParent();
+		if (wrapper == nullptr || wrapper->GetParent() != this || wrapper->FindContainingDatum(idx) != std::as_const(*this).Find(ChildrenKey)) {
+			return false;
+		}
+		GameObject* object = child->As<GameObject>();
+		if (object != nullptr) {
+			InvalidateTransforms(*object);
 		}
-		return false;
+		return child->Orphan() != nullptr;
 	}
 
 	/**
-	 * @brief Returns Actions Datum, and if given an index will return the specific Datum of the Action at that index
+	 * @brief Returns Actions Datum, and if given an index will return the specific Datum of the Action at that index.
+	 * Actions may be added or removed through it, so the next Update lists them again.
 	 * @param idx (optional)
 	 * @return Actions Datum or if index provided will retreive the exact Action's Datum at that index
 	*/
 	Datum* GameObject::Actions(int idx)
 	{
+		InvalidateUpdateList();
 		if (idx == -1) {
-			return Find("Actions");
+			return Find(ActionsKey);
 		}
 		else {
-			Datum* dt = Find("Actions");
+			Datum* dt = Find(ActionsKey);
 			Scope* st = dt->GetScope(0);
 			return &(*st)[idx];
 		}
@@ -136,7 +510,7 @@ namespace Fiea::GameEngine {
 				return false;
 			}
 
-			Adopt(*ActionCreated, "Actions");
+			Adopt(*ActionCreated, ActionsKey);
 			return true;
 		}
 		else {
@@ -146,16 +520,29 @@ namespace Fiea::GameEngine {
 		return true;
 	}
 
-	std::vector<Signature> GameObject::Signatures() {
-		return std::vector<Signature> {
-			{ "Name"s, Datum::DatumType::String, 1, offsetof(GameObject, Name) },
-			{ "Position"s, Datum::DatumType::Vector, 1, offsetof(GameObject, ObjTransform.Position) },
-			{ "Rotation"s, Datum::DatumType::Vector, 1, offsetof(GameObject, ObjTransform.Rotation) },
-			{ "Scale"s, Datum::DatumType::Vector, 1, offsetof(GameObject, ObjTransform.Scale) },
-			{ "Children"s, Datum::DatumType::Table, 0, 0 },
-			{ "Actions"s, Datum::DatumType::Table, 0, 0}
-		};
+	std::span<const Signature> GameObject::Signatures() {
+		static constexpr auto signatures = MakeSignatures({
+			SIGNATURE(GameObject, Name, "Name"),
+			SIGNATURE(GameObject, ObjTransform.Position, "Position"),
+			SIGNATURE(GameObject, ObjTransform.Rotation, "Rotation"),
+			SIGNATURE(GameObject, ObjTransform.Scale, "Scale"),
+			{ "Children", Datum::DatumType::Table, 0, 0 },
+			{ "Actions", Datum::DatumType::Table, 0, 0 }
+		});
+		return signatures;
 	}
 
-
+	/** InvalidateTransforms
+	 * @brief Tells the TransformSystems of this object and child that child is being reparented
+	 * @param child : GameObject added or removed
+	*/
+	void GameObject::InvalidateTransforms(GameObject& child) const
+	{
+		if (_transformBinding.System != nullptr) {
+			_transformBinding.System->Invalidate();
+		}
+		if (child._transformBinding.System != nullptr) {
+			child._transformBinding.System->Invalidate();
+		}
+	}
 }
@@ -2,12 +2,15 @@
 #include "Attributed.h"
 #include "Signature.h"
 #include "GameClock.h"
+#include "Sleeper.h"
 
 using string = std::string;
 using Vec4 = glm::vec4;
 
 namespace Fiea::GameEngine {
-	
+	class TransformSystem;
+	class JobSystem;
+	class Action;
 
 	struct Transform {
 		Vec4 Position;
@@ -15,7 +18,7 @@ namespace Fiea::GameEngine {
 		Vec4 Scale;
 	};
 
-	class GameObject : public Attributed
+	class GameObject : public Attributed, public Sleeper
 	{
 		RTTI_DECLARATIONS(GameObject, Attributed);
 
@@ -23,33 +26,97 @@ namespace Fiea::GameEngine {
 		GameObject() : Attributed(TypeIdClass(), nullptr) {};
 
 		// Constructor Override if called from child
-		GameObject(std::vector<RTTI::IdType>* childIds) : Attributed(TypeIdClass(), childIds) {};
-		virtual ~GameObject() = default;
-		
-		// Doesn't deal with any of it's own copying or moving
-		GameObject(const GameObject& rhs) = default;
-		GameObject(GameObject&& rhs) noexcept = default;
-		GameObject& operator=(const GameObject& rhs) = default;
-		GameObject& operator=(GameObject&& rhs) noexcept = default;
+		GameObject(const TypeIdList* childIds) : Attributed(TypeIdClass(), childIds) {};
+		virtual ~GameObject();
+
+		// Copies take the transform from rhs' TransformSystem if it has one, but are never managed by it themselves
+		GameObject(const GameObject& rhs);
+		GameObject(GameObject&& rhs) noexcept;
+		GameObject& operator=(const GameObject& rhs);
+		GameObject& operator=(GameObject&& rhs) noexcept;
 		[[nodiscard]] GameObject* Clone() const override;
 
-		// Takes takes a const reference to a GameTime instance and calls Update on all of its children.
+		// Takes takes a const reference to a GameTime instance and calls Update on all of its children. Sleeping
+		// GameObjects, with their subtrees, and sleeping Actions are skipped, see Sleeper
 		void Update(const GameTime& time);
+		// Same, with subtrees updated in parallel on jobs' workers
+		void Update(const GameTime& time, JobSystem& jobs);
 
 		bool AddChild(Scope* child);
 
 		bool RemoveChild(Scope* child);
 
+		// Update ticks a list of this object's subtree made on its first call. Adopting or orphaning Scopes in Children
+		// or Actions, through any API, keeps it current. Call this after pushing Scopes into their Datums directly
+		void InvalidateUpdateList();
+
 		// Action Methods
 
 		Datum* Actions(int idx = -1);
 
 		bool CreateAction(const string& className, const string& instanceName);
 
+		// Local transform, ObjTransform unless a TransformSystem keeps it
+		Transform GetTransform() const;
+		void SetTransform(const Transform& transform);
+		TransformSystem* GetTransformSystem() const { return _transformBinding.System; };
+
 		string Name;
+		// Out of date while a TransformSystem manages the object, the Position, Rotation and Scale attributes view the system's copy
 		Transform ObjTransform;
 		// This Boolean is solely for testing Update
 		bool Updated = false;
-		static std::vector<Signature> Signatures();
+		static std::span<const Signature> Signatures();
+
+		// Interned keys of the prescribed Table attributes walked every Update
+		static const Symbol ChildrenKey;
+		static const Symbol ActionsKey;
+		// Interned keys of the transform attributes
+		static const Symbol PositionKey;
+		static const Symbol RotationKey;
+		static const Symbol ScaleKey;
+
+	protected:
+		GameObject* SleepOwner() override { return this; };
+
+	private:
+		friend TransformSystem;
+		friend Sleeper;
+
+		// The TransformSystem managing this object and its slot there, copying never carries it over
+		struct TransformBinding {
+			TransformSystem* System = nullptr;
+			std::uint32_t Slot = 0;
+
+			TransformBinding() = default;
+			TransformBinding(const TransformBinding&) {};
+			TransformBinding& operator=(const TransformBinding&) { return *this; };
+		};
+		TransformBinding _transformBinding;
+
+		// One step of Update: an Action of Object, or marking Object updated once its Actions are done (Step nullptr)
+		struct UpdateEntry {
+			GameObject* Object;
+			Action* Step;
+			std::uint32_t Depth; // of Object below this one
+		};
+		std::vector<UpdateEntry> _updateList; // this subtree in Update order, parents before their children
+		bool _updateListStale = true;
+		std::vector<UpdateEntry> _activeList; // _updateList without the sleepers
+		bool _activeListStale = true;
+		std::vector<Sleeper*> _timers; // sleepers with a timer, latest first
+		std::vector<Sleeper*> _watchers; // sleepers watching an attribute
+
+		void NestedScopesChanged(Symbol key) override;
+		void InvalidateTransforms(GameObject& child) const;
+		void RebuildUpdateList();
+		void Schedule(Millis now);
+		void RebuildActiveList(Millis now);
+		void InvalidateActiveList();
+		GameObject* ParentObject();
+		void UpdateSubtree(const GameTime& time, JobSystem& jobs, std::vector<Action*>& deferred);
+
+		template<class Visit>
+		void ForEachChild(Visit&& visit);
 	};
 }
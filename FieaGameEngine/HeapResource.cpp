@@ -0,0 +1,25 @@
+#include "pch.h"
+#include "HeapResource.h"
+
+namespace Fiea::GameEngine {
+
+	void* HeapResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+		if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+			return ::operator new(bytes, std::align_val_t(alignment));
+		}
+		return ::operator new(bytes);
+	}
+
+	void HeapResource::do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) {
+		if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+			::operator delete(ptr, std::align_val_t(alignment));
+		}
+		else {
+			::operator delete(ptr);
+		}
+	}
+
+	bool HeapResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+		return this == &other;
+	}
+}
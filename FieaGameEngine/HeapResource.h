@@ -0,0 +1,26 @@
+#pragma once
+#include <memory_resource>
+
+namespace Fiea::GameEngine {
+
+	/** HeapResource
+	 * @brief memory_resource used by Scopes (and their Datums and FlatScopeStorage) that weren't given one. Plain
+	 * operator new/delete, only over-aligned requests take the aligned overloads, unlike new_delete_resource which
+	 * may always use them, so heap Scopes allocate the same way they did before memory resources were supported.
+	*/
+	class HeapResource final : public std::pmr::memory_resource {
+	public:
+		// The single instance, it has no state so every heap Scope shares it
+		static HeapResource* Get() {
+			static HeapResource instance;
+			return &instance;
+		};
+
+	private:
+		HeapResource() = default;
+
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+		void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+	};
+}
@@ -7,28 +7,13 @@ using namespace std::string_literals;
 namespace Fiea::GameEngine{
 	RTTI_DEFINITIONS(Hero);
 
-	Hero::~Hero()
+	std::span<const Signature> Hero::Signatures()
 	{
-		delete HeroID;
-	}
-
-	std::vector<Signature> Hero::Signatures()
-	{
-		return std::vector<Signature> {
-			{ "PassiveName"s, Datum::DatumType::String, 1, offsetof(Hero, PassiveName) },
-			{ "HeroName"s, Datum::DatumType::String, 1, offsetof(Hero, HeroName) }
-		};
-	}
-
-	std::vector<RTTI::IdType>* Hero::AppendId(std::vector<RTTI::IdType>* Ids)
-	{
-		if (Ids == nullptr) {
-			HeroID = new std::vector<RTTI::IdType>();
-			HeroID->push_back(TypeIdClass());
-			return HeroID;
-		}
-		Ids->push_back(TypeIdClass());
-		return Ids;
+		static constexpr auto signatures = MakeSignatures({
+			SIGNATURE(Hero, PassiveName, "PassiveName"),
+			SIGNATURE(Hero, HeroName, "HeroName")
+		});
+		return signatures;
 	}
 
 }
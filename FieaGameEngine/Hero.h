@@ -9,17 +9,13 @@ namespace Fiea::GameEngine {
 
 	public:
 
-		Hero(std::vector<RTTI::IdType>* Ids = nullptr) : GameObject(AppendId(Ids)) {};
-		virtual ~Hero();
+		Hero(TypeIdList* Ids = nullptr) : GameObject(AppendTypeId(Ids, TypeIdClass())) {};
+		virtual ~Hero() = default;
 
 		string PassiveName;
 		string HeroName;
 		
-		static std::vector<Signature> Signatures();
-
-	private:
-		std::vector<RTTI::IdType>* AppendId(std::vector<RTTI::IdType>* Ids);
-		std::vector<RTTI::IdType>* HeroID;
+		static std::span<const Signature> Signatures();
 	};
 }
 
@@ -0,0 +1,170 @@
+#include "pch.h"
+#include "JobSystem.h"
+#include <utility>
+
+namespace Fiea::GameEngine {
+
+	/**
+	 * @brief Starts the workers
+	 * @param workers : number of worker threads, 0 runs every job on the thread that Waits for it
+	*/
+	JobSystem::JobSystem(std::size_t workers)
+	{
+		for (std::size_t idx = 0; idx <= workers; ++idx) {
+			_queues.push_back(std::make_unique<Queue>());
+		}
+		_threads.reserve(workers);
+		for (std::size_t idx = 0; idx < workers; ++idx) {
+			_threads.emplace_back(&JobSystem::Work, this, idx);
+		}
+	}
+
+	// Destructor, stops and joins the workers. Jobs still queued are dropped, Wait for them first.
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_sleepLock);
+			_stopping.store(true);
+		}
+		_wake.notify_all();
+		for (std::thread& thread : _threads) {
+			thread.join();
+		}
+	}
+
+	/** DefaultWorkers
+	 * @return hardware threads minus the calling one, 0 if that can't be told
+	*/
+	std::size_t JobSystem::DefaultWorkers()
+	{
+		const unsigned int hardware = std::thread::hardware_concurrency();
+		return hardware > 1 ? hardware - 1 : 0;
+	}
+
+	/** Run
+	 * @brief Queues job in group. A worker pushes to its own deque, any other thread to the shared one.
+	 * @param group : batch the job belongs to, has to outlive it
+	 * @param job : work to run on some thread
+	*/
+	void JobSystem::Run(Group& group, Job job)
+	{
+		group._pending.fetch_add(1, std::memory_order_relaxed);
+		// Counted before it is pushed, so the count never drops below the jobs actually queued
+		_queued.fetch_add(1);
+		Queue& queue = *_queues[QueueOfThisThread()];
+		{
+			std::lock_guard<std::mutex> lock(queue.Lock);
+			queue.Tasks.push_back(Task{ std::move(job), &group });
+		}
+		if (_sleeping.load() > 0) {
+			// A worker between checking for work and sleeping holds the lock, it sees the job once we get it
+			{ std::lock_guard<std::mutex> lock(_sleepLock); }
+			_wake.notify_one();
+		}
+	}
+
+	/** Wait
+	 * @brief Runs queued jobs, of any group, on this thread until every job of group is done
+	 * @param group : batch to wait for, rethrows the first exception one of its jobs threw
+	*/
+	void JobSystem::Wait(Group& group)
+	{
+		const std::size_t index = QueueOfThisThread();
+		while (!group.Done()) {
+			if (!RunOne(index)) {
+				std::this_thread::yield();
+			}
+		}
+		std::exception_ptr error;
+		{
+			std::lock_guard<std::mutex> lock(group._errorLock);
+			error = std::exchange(group._error, nullptr);
+		}
+		if (error != nullptr) {
+			std::rethrow_exception(error);
+		}
+	}
+
+	/** Work
+	 * @brief Worker loop, runs jobs and sleeps while there are none
+	 * @param index : the worker's queue
+	*/
+	void JobSystem::Work(std::size_t index)
+	{
+		_currentSystem = this;
+		_currentQueue = index;
+		while (!_stopping.load(std::memory_order_relaxed)) {
+			if (RunOne(index)) {
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(_sleepLock);
+			_sleeping.fetch_add(1);
+			_wake.wait(lock, [this]() { return _stopping.load() || _queued.load() > 0; });
+			_sleeping.fetch_sub(1);
+		}
+	}
+
+	/** RunOne
+	 * @brief Takes one job and runs it, exceptions end up in its group
+	 * @param index : queue of the running thread
+	 * @return false if no job was queued anywhere
+	*/
+	bool JobSystem::RunOne(std::size_t index)
+	{
+		Task task;
+		if (!Take(index, task)) {
+			return false;
+		}
+		try {
+			task.Work();
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(task.Owner->_errorLock);
+			if (task.Owner->_error == nullptr) {
+				task.Owner->_error = std::current_exception();
+			}
+		}
+		task.Owner->_pending.fetch_sub(1, std::memory_order_release);
+		return true;
+	}
+
+	/** Take
+	 * @brief Pops the newest job of the thread's own queue, or steals the oldest of another one
+	 * @param index : queue of the running thread
+	 * @param task : set to the job taken
+	 * @return false if every queue was empty
+	*/
+	bool JobSystem::Take(std::size_t index, Task& task)
+	{
+		if (_queued.load(std::memory_order_relaxed) == 0) {
+			return false;
+		}
+		{
+			Queue& own = *_queues[index];
+			std::lock_guard<std::mutex> lock(own.Lock);
+			if (!own.Tasks.empty()) {
+				task = std::move(own.Tasks.back());
+				own.Tasks.pop_back();
+				_queued.fetch_sub(1);
+				return true;
+			}
+		}
+		for (std::size_t offset = 1; offset < _queues.size(); ++offset) {
+			Queue& victim = *_queues[(index + offset) % _queues.size()];
+			std::lock_guard<std::mutex> lock(victim.Lock);
+			if (!victim.Tasks.empty()) {
+				task = std::move(victim.Tasks.front());
+				victim.Tasks.pop_front();
+				_queued.fetch_sub(1);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Own queue of a worker, the shared one for every other thread
+	std::size_t JobSystem::QueueOfThisThread() const
+	{
+		return _currentSystem == this ? _currentQueue : _queues.size() - 1;
+	}
+}
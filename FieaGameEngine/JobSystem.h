@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Fiea::GameEngine {
+
+	/** JobSystem
+	 * @brief Fixed pool of worker threads running small jobs. Every worker owns a deque: it pushes and pops its own
+	 * jobs at the back (newest first, still warm in cache) and, once it runs dry, steals the oldest job from the front
+	 * of another worker's deque. Threads outside the pool push to a shared deque the workers steal from too.
+	 * Jobs are batched in Groups, Wait runs queued jobs on the waiting thread until its Group is done, so jobs can
+	 * fork more jobs and wait for them without tying up a worker.
+	*/
+	class JobSystem final {
+	public:
+		using Job = std::function<void()>;
+
+		/** Group
+		 * @brief Unfinished jobs of one batch. The first exception a job throws is rethrown by Wait.
+		*/
+		class Group final {
+		public:
+			Group() = default;
+			Group(const Group& other) = delete;
+			Group& operator=(const Group& rhs) = delete;
+
+			bool Done() const { return _pending.load(std::memory_order_acquire) == 0; };
+
+		private:
+			friend JobSystem;
+			std::atomic<std::size_t> _pending{ 0 };
+			std::mutex _errorLock;
+			std::exception_ptr _error;
+		};
+
+		explicit JobSystem(std::size_t workers = DefaultWorkers());
+		~JobSystem();
+
+		// Workers point back at the system, which can't be copied or moved
+		JobSystem(const JobSystem& other) = delete;
+		JobSystem& operator=(const JobSystem& rhs) = delete;
+		JobSystem(JobSystem&& other) = delete;
+		JobSystem& operator=(JobSystem&& rhs) = delete;
+
+		void Run(Group& group, Job job);
+		void Wait(Group& group);
+
+		std::size_t WorkerCount() const { return _threads.size(); };
+		// Fewer jobs are queued than there are workers to take them, splitting work further pays off
+		bool Hungry() const { return _queued.load(std::memory_order_relaxed) < _threads.size(); };
+
+		// One worker per hardware thread besides the calling one
+		static std::size_t DefaultWorkers();
+
+	private:
+		struct Task {
+			Job Work;
+			Group* Owner = nullptr;
+		};
+
+		struct Queue {
+			std::mutex Lock;
+			std::deque<Task> Tasks;
+		};
+
+		void Work(std::size_t index);
+		bool RunOne(std::size_t index);
+		bool Take(std::size_t index, Task& task);
+		std::size_t QueueOfThisThread() const;
+
+		std::vector<std::unique_ptr<Queue>> _queues; // one per worker, the last one is shared by outside threads
+		std::vector<std::thread> _threads;
+		std::atomic<std::size_t> _queued{ 0 };
+		std::atomic<std::size_t> _sleeping{ 0 };
+		std::atomic<bool> _stopping{ false };
+		std::mutex _sleepLock;
+		std::condition_variable _wake;
+
+		// The system and queue of the worker running on this thread
+		inline static thread_local const JobSystem* _currentSystem = nullptr;
+		inline static thread_local std::size_t _currentQueue = 0;
+	};
+}
@@ -0,0 +1,41 @@
+#include "pch.h"
+#include "LevelArena.h"
+
+namespace Fiea::GameEngine {
+
+	/** Constructor
+	 * @brief Creates the arena and an empty root Scope inside it
+	 * @param initialBlockSize : bytes of the first block, later blocks grow geometrically
+	 * @param storage : attribute layout of the root Scope
+	*/
+	LevelArena::LevelArena(std::size_t initialBlockSize, Scope::Storage storage) : _arena(initialBlockSize), _storage(storage) {
+		_root = CreateRoot();
+	}
+
+	// Destructor
+	LevelArena::~LevelArena() {
+		DestroyRoot();
+	}
+
+	/** Reset
+	 * @brief Destroys the whole tree, which only runs destructors since the arena ignores frees, then hands
+	 * every block back in one go and starts a new empty root
+	*/
+	void LevelArena::Reset() {
+		DestroyRoot();
+		_arena.release();
+		_root = CreateRoot();
+	}
+
+	// Places the root in the arena so its own attributes and children end up there too
+	Scope* LevelArena::CreateRoot() {
+		void* memory = _arena.allocate(sizeof(Scope), alignof(Scope));
+		return new(memory) Scope(0, _storage, &_arena);
+	}
+
+	// The root's memory belongs to the arena, only its destructor needs to run
+	void LevelArena::DestroyRoot() {
+		_root->~Scope();
+		_root = nullptr;
+	}
+}
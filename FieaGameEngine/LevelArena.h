@@ -0,0 +1,43 @@
+#pragma once
+#include "Scope.h"
+#include <memory_resource>
+
+namespace Fiea::GameEngine {
+
+	/** LevelArena
+	 * @brief Monotonic memory for one level's Scope tree. The root Scope and everything built under it through
+	 * Append/AppendScope (child Scopes, hash nodes, attribute storage) is carved out of a few large blocks, so a load
+	 * doesn't scatter tens of thousands of small allocations over the heap and the frees made while tearing the tree
+	 * down are no-ops. Reset destroys the tree and returns every block at once.
+	 * Objects created by factories and the characters of long strings still live on the heap.
+	*/
+	class LevelArena final {
+	public:
+		static constexpr std::size_t DefaultBlockSize = 64 * 1024;
+
+		explicit LevelArena(std::size_t initialBlockSize = DefaultBlockSize, Scope::Storage storage = Scope::Storage::Hashed);
+		~LevelArena();
+
+		LevelArena(const LevelArena& other) = delete;
+		LevelArena& operator=(const LevelArena& rhs) = delete;
+		LevelArena(LevelArena&& other) = delete;
+		LevelArena& operator=(LevelArena&& rhs) = delete;
+
+		// Root of the level, allocates from the arena
+		Scope& Root() { return *_root; };
+		const Scope& Root() const { return *_root; };
+
+		std::pmr::memory_resource* Resource() { return &_arena; };
+
+		// Destroys the level and releases all of its memory, leaving an empty root to load the next one into
+		void Reset();
+
+	private:
+		Scope* CreateRoot();
+		void DestroyRoot();
+
+		std::pmr::monotonic_buffer_resource _arena;
+		Scope::Storage _storage;
+		Scope* _root;
+	};
+}
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <string>
+#include <array>
 
 namespace Fiea::GameEngine
 {
@@ -17,8 +18,27 @@ namespace Fiea::GameEngine
 		RTTI& operator=(RTTI&&) noexcept = default;
 		virtual ~RTTI() = default;
 
+		/** Ancestry
+		 * @brief Where a type's ids live: Ids[0] is its root class (right below RTTI), Ids[Depth - 1] the type itself.
+		 * The entries are the addresses of each class' _typeId, so they are fixed at compile time and a class at
+		 * depth d always sits in slot d - 1 of every descendant's Ancestry.
+		*/
+		struct Ancestry {
+			const IdType* const* Ids;
+			std::size_t Depth;
+		};
+
+		// RTTI itself is not part of any Ancestry
+		static constexpr std::size_t TypeDepth = 0;
+		static constexpr std::array<const IdType*, 0> AncestryClass() { return {}; }
+
 		virtual IdType TypeIdInstance() const = 0;
-		virtual bool Is(IdType) const;
+		virtual Ancestry AncestryInstance() const = 0;
+
+		bool Is(IdType id) const;
+
+		template <typename T>
+		bool Is() const;
 
 		template <typename T>
 		T* As();
@@ -28,16 +48,34 @@ namespace Fiea::GameEngine
 
 		virtual std::string ToString() const;
 		virtual bool Equals(const RTTI* rhs) const;
+
+	protected:
+		// A parent's ancestry followed by a new type id, used to build each class' Ancestry at compile time
+		template <std::size_t N>
+		static constexpr std::array<const IdType*, N + 1> Extend(const std::array<const IdType*, N>& ancestry, const IdType* id) {
+			std::array<const IdType*, N + 1> extended{};
+			for (std::size_t i = 0; i < N; ++i) {
+				extended[i] = ancestry[i];
+			}
+			extended[N] = id;
+			return extended;
+		}
 	};
 }
 
-#define RTTI_DECLARATIONS(Type, ParentType)																							\
-	public:																													\
-		static std::string TypeName() { return std::string(#Type); }														\
-		static Fiea::GameEngine::RTTI::IdType TypeIdClass() { return _typeId; }												\
-		Fiea::GameEngine::RTTI::IdType TypeIdInstance() const override { return TypeIdClass(); }								\
-		bool Is(Fiea::GameEngine::RTTI::IdType id) const override { return (id == _typeId ? true : ParentType::Is(id)); }		\
-	private:																												\
+#define RTTI_DECLARATIONS(Type, ParentType)																								\
+	public:																																\
+		static std::string TypeName() { return std::string(#Type); }																	\
+		static Fiea::GameEngine::RTTI::IdType TypeIdClass() { return _typeId; }															\
+		static constexpr const Fiea::GameEngine::RTTI::IdType* TypeIdAddress() { return &_typeId; }										\
+		static constexpr std::size_t TypeDepth = ParentType::TypeDepth + 1;																\
+		static constexpr std::array<const Fiea::GameEngine::RTTI::IdType*, TypeDepth> AncestryClass() { return Extend(ParentType::AncestryClass(), &_typeId); }	\
+		Fiea::GameEngine::RTTI::IdType TypeIdInstance() const override { return TypeIdClass(); }										\
+		Fiea::GameEngine::RTTI::Ancestry AncestryInstance() const override {															\
+			static constexpr std::array<const Fiea::GameEngine::RTTI::IdType*, TypeDepth> ancestry = AncestryClass();					\
+			return { ancestry.data(), TypeDepth };																						\
+		}																																\
+	private:																															\
 		static const Fiea::GameEngine::RTTI::IdType _typeId
 
 #define RTTI_DEFINITIONS(Type)																								\
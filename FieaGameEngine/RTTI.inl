@@ -2,20 +2,48 @@
 
 namespace Fiea::GameEngine
 {
-	inline bool RTTI::Is(IdType) const
+	/** Is
+	 * @brief Whether this is an instance of the type with id, or of a type derived from it
+	 * @param id : TypeIdClass of the type
+	 * @return true if id is in this instance's Ancestry
+	*/
+	inline bool RTTI::Is(IdType id) const
 	{
+		Ancestry ancestry = AncestryInstance();
+		for (std::size_t i = 0; i < ancestry.Depth; ++i) {
+			if (*ancestry.Ids[i] == id) {
+				return true;
+			}
+		}
 		return false;
 	}
 
+	/** Is
+	 * @brief Constant time Is for a type known at compile time: T can only be at slot T::TypeDepth - 1
+	 * @tparam T : RTTI type
+	 * @return true if this is a T or derived from T
+	*/
+	template <typename T>
+	inline bool RTTI::Is() const
+	{
+		if constexpr (T::TypeDepth == 0) {
+			return true;
+		}
+		else {
+			Ancestry ancestry = AncestryInstance();
+			return T::TypeDepth <= ancestry.Depth && ancestry.Ids[T::TypeDepth - 1] == T::TypeIdAddress();
+		}
+	}
+
 	template <typename T>
 	inline const T* RTTI::As() const
 	{
-		return (Is(T::TypeIdClass()) ? reinterpret_cast<const T*>(this) : nullptr);
+		return (Is<T>() ? static_cast<const T*>(this) : nullptr);
 	}
 
 	template <typename T>
 	inline T* RTTI::As()
 	{
-		return (Is(T::TypeIdClass()) ? reinterpret_cast<T*>(const_cast<RTTI*>(this)) : nullptr);
+		return (Is<T>() ? static_cast<T*>(this) : nullptr);
 	}
 }
\ No newline at end of file
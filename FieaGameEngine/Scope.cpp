@@ -1,18 +1,36 @@
 #include "pch.h"
 #include "Scope.h"
 #include <sstream>
+#include <algorithm>
+#include <utility>
+#include <atomic>
 
 namespace Fiea::GameEngine{
 	RTTI_DEFINITIONS(Scope);
 
+	namespace {
+		// pmr containers always need a resource, Scopes without one use the heap
+		std::pmr::memory_resource* ResourceOrHeap(std::pmr::memory_resource* resource) {
+			return resource != nullptr ? resource : HeapResource::Get();
+		}
+	}
+
 	/** Capacity constructor (Parameterized Constructor)
 	 * @brief Constructs a scope with _data and v_data containing an initial capacity
 	 * of initCapactiy and sets the Parent to nullptr
 	 * @param std::uint32_t initCapacity: initial capacity of Scope's content
+	 * @param Storage storage: attribute layout of this Scope, Hashed by default
+	 * @param resource: memory the attributes and child Scopes are allocated from, the heap when nullptr
 	*/
-	Scope::Scope(std::uint32_t initCapacity){
-		_data.reserve(initCapacity);
-		v_data.reserve(initCapacity);
+	Scope::Scope(std::uint32_t initCapacity, Storage storage, std::pmr::memory_resource* resource) :
+		_data(ResourceOrHeap(resource)), v_data(ResourceOrHeap(resource)), _flat(resource), _storage(storage), _resource(resource) {
+		if (_storage == Storage::Flat) {
+			_flat.Reserve(initCapacity);
+		}
+		else {
+			_data.reserve(initCapacity);
+			v_data.reserve(initCapacity);
+		}
 		Parent = nullptr;
 	};
 
@@ -27,45 +45,15 @@ namespace Fiea::GameEngine{
 	 * @brief Deep copy constructor
 	 * @param other 
 	 */
-	Scope::Scope(const Scope& other) {
+	Scope::Scope(const Scope& other) : _storage(other._storage) {
 		// Deep copy other Scope
 		Parent = nullptr;
-		_data = other._data;
-		v_data = other.v_data;
-		for (const auto& pair : other._data) {
-			if (pair.second._type == Datum::DatumType::Table) {
-				const Datum& datum = pair.second;
-				Datum* thisDat = Find(pair.first);
-				assert(thisDat != nullptr);
-				for (size_t i = 0; i < datum.Size(); ++i) {
-					Scope* newScope = datum.GetScope(i)->Clone();
-					newScope->Parent = this;
-					thisDat->Set(i, newScope);
-				}
-				// Update v_data to maintain the same order
-				for (size_t i = 0; i < v_data.size(); ++i) {
-					// since v_data's Datum*s still point to other's Datums
-					// use that to recreate the order
-					if (v_data[i] == &datum) {
-						v_data[i] = thisDat;
-					}
-				}
-			}
-			else {
-				Datum& dt = Append(pair.first);
-				dt = pair.second;
-
-				// Update v_data to maintain the same order
-				for (size_t i = 0; i < v_data.size(); ++i) {
-					// since v_data's Datum*s still point to other's Datums
-					// use that to recreate the order
-					if (v_data[i] == &pair.second) {
-						v_data[i] = &dt;
-					}
-				}
-			}
+		if (_storage == Storage::Flat) {
+			CopyFlat(other);
+		}
+		else {
+			CopyHashed(other);
 		}
-
 	};
 
 
@@ -76,46 +64,21 @@ namespace Fiea::GameEngine{
 	 */
 	Scope& Scope::operator=(const Scope& rhs) {
 		// Guard against self assignment
-		if (rhs == *this) {
+		if (&rhs == this) {
 			return *this;
 		}
 		// Clears the current content of this Scope
 		Clear();
-		// Copy Scope Contents;
-		_data = rhs._data;
-		v_data = rhs.v_data;
-		for (const auto& pair : rhs._data) {
-			if (pair.second._type == Datum::DatumType::Table) {
-				const Datum& datum = pair.second;
-				Datum* thisDat = Find(pair.first);
-				assert(thisDat != nullptr);
-				for (size_t i = 0; i < datum.Size(); ++i) {
-					Scope* newScope = datum.GetScope(i)->Clone();
-					newScope->Parent = this;
-					thisDat->Set(i, newScope);
-				}
-				// Update v_data to maintain the same order
-				for (size_t i = 0; i < v_data.size(); ++i) {
-					// since v_data's Datum*s still point to other's Datums
-					// use that to recreate the order
-					if (v_data[i] == &datum) {
-						v_data[i] = thisDat;
-					}
-				}
-			}
-			else {
-				Datum& dt = Append(pair.first);
-				dt = pair.second;
-
-				// Update v_data to maintain the same order
-				for (size_t i = 0; i < v_data.size(); ++i) {
-					// since v_data's Datum*s still point to other's Datums
-					// use that to recreate the order
-					if (v_data[i] == &pair.second) {
-						v_data[i] = &dt;
-					}
-				}
-			}
+		InvalidateSearches();
+		_data.clear();
+		v_data.clear();
+		_flat.Clear();
+		_storage = rhs._storage;
+		if (_storage == Storage::Flat) {
+			CopyFlat(rhs);
+		}
+		else {
+			CopyHashed(rhs);
 		}
 		return *this;
 	}
@@ -125,15 +88,15 @@ namespace Fiea::GameEngine{
 	 * @brief Move Constructor
 	 * @param other 
 	 */
-	Scope::Scope(Scope&& other) noexcept : _data(std::move(other._data)), v_data(std::move(other.v_data)), Parent(nullptr) {
+	Scope::Scope(Scope&& other) noexcept : _data(std::move(other._data)), v_data(std::move(other.v_data)),
+		_flat(std::move(other._flat)), _storage(other._storage), Parent(nullptr), _resource(other._resource) {
+		for (size_t i = 0; i < _flat.Size(); ++i) {
+			AdoptChildren(_flat[i].Value);
+		}
 		for (const auto& pair : _data) {
-			if (pair.second._type == Datum::DatumType::Table) {
-				Datum* datum = Find(pair.first);
-				for (size_t x = 0; x < datum->Size(); ++x) {
-					datum->GetScope(x)->Parent = this;
-				}
-			}
+			AdoptChildren(pair.second);
 		}
+		other.InvalidateSearches();
 	}
 
 
@@ -143,20 +106,43 @@ namespace Fiea::GameEngine{
 	 * @return Moved rhs Scope
 	 */
 	Scope& Scope::operator=(Scope&& rhs) noexcept {
-		_data = std::move(rhs._data);
-		v_data = std::move(rhs.v_data);
+		InvalidateSearches();
+		if (_data.get_allocator() == rhs._data.get_allocator()) {
+			_data = std::move(rhs._data);
+			v_data = std::move(rhs.v_data);
+		}
+		else {
+			MoveHashed(rhs);
+		}
+		_flat = std::move(rhs._flat);
+		_storage = rhs._storage;
 		Parent = nullptr;
+		for (size_t i = 0; i < _flat.Size(); ++i) {
+			AdoptChildren(_flat[i].Value);
+		}
 		for (const auto& pair : _data) {
-			if (pair.second._type == Datum::DatumType::Table) {
-				Datum* datum = Find(pair.first);
-				for (size_t x = 0; x < datum->Size(); ++x) {
-					datum->GetScope(x)->Parent = this;
-				}
-			}
+			AdoptChildren(pair.second);
 		}
+		rhs.InvalidateSearches();
 		return *this;
 	}
 
+	/** AdoptChildren
+	 * @brief Parents the nested Scopes of a Table Datum that moved here from another Scope
+	 * @param datum : Datum now held by this Scope
+	*/
+	void Scope::AdoptChildren(const Datum& datum) {
+		if (datum._type != Datum::DatumType::Table) {
+			return;
+		}
+		for (Scope* child : datum.AsConstSpan<Scope*>()) {
+			if (child != nullptr) {
+				child->Parent = this;
+				child->InvalidateSearches();
+			}
+		}
+	}
+
 	/** Clone
 	 * @brief Creates a Clone of the current Scope 
 	 * @return a Scope reference to a new but identical Scope
@@ -166,110 +152,328 @@ namespace Fiea::GameEngine{
 		return NEW Scope(*this);
 	};
 
+	/** CloneShared
+	 * @brief Copy-on-write Clone, for spawning many instances of a prototype. Datums on the heap are shared with this
+	 * Scope rather than copied; whichever of them is accessed mutably first (non-const Find, Append, operator[],
+	 * Search...) gets copied then. Reading through const access never copies. This Scope's elements stay where they
+	 * are, the clones share a copy of them made by the first CloneShared (see Datum::Share). Nested Scopes are
+	 * CloneShared right away, so every Scope still has a single parent and Orphan, Adopt and Search behave as they do
+	 * after Clone.
+	 * @return a Scope reference to a new but identical Scope, of the same type as Clone makes
+	*/
+	Scope* Scope::CloneShared() const {
+		bool sharing = _shareOnCopy;
+		_shareOnCopy = true;
+		try {
+			Scope* clone = Clone();
+			_shareOnCopy = sharing;
+			return clone;
+		}
+		catch (...) {
+			_shareOnCopy = sharing;
+			throw;
+		}
+	}
+
+	/** CopyHashed
+	 * @brief Copies other's hashed entries in a single pass over its order index, cloning nested Scopes (sharing
+	 * the other Datums while CloneShared runs, see Datum::Share). v_data holds the map entries themselves,
+	 * so each key comes with its Datum and the new index is built alongside the map.
+	 * @param other : Scope using Storage::Hashed
+	*/
+	void Scope::CopyHashed(const Scope& other) {
+		_data.reserve(other._data.size());
+		v_data.reserve(other.v_data.size());
+		for (const HashedEntry* entry : other.v_data) {
+			// Adopt may list a Table more than once, it's copied the first time
+			auto it = _data.find(entry->first);
+			if (it == _data.end()) {
+				if (_shareOnCopy && entry->second._type != Datum::DatumType::Table) {
+					it = _data.try_emplace(entry->first).first;
+					it->second.Share(entry->second);
+				}
+				else {
+					it = _data.try_emplace(entry->first, entry->second).first;
+					Datum& dt = it->second;
+					if (dt._type == Datum::DatumType::Table) {
+						for (size_t j = 0; j < dt.Size(); ++j) {
+							Scope* newScope = entry->second.GetScope(j)->Clone();
+							dt.Set(j, newScope);
+							AttachChild(*newScope, entry->first, j);
+						}
+					}
+				}
+			}
+			v_data.push_back(&*it);
+		}
+	}
+
+	/** MoveHashed
+	 * @brief Moves rhs' hashed entries into this Scope's own resource one Datum at a time. Moving the map
+	 * wholesale would copy its nodes anyway and leave v_data pointing into rhs, so it's rebuilt in rhs' order.
+	 * @param rhs : Scope allocating from a different resource, left empty
+	*/
+	void Scope::MoveHashed(Scope& rhs) {
+		_data.clear();
+		v_data.clear();
+		for (HashedEntry* entry : rhs.v_data) {
+			auto [it, inserted] = _data.try_emplace(entry->first, std::move(entry->second));
+			v_data.push_back(&*it);
+		}
+		rhs._data.clear();
+		rhs.v_data.clear();
+	}
+
+	/** CopyFlat
+	 * @brief Deep copies other's flat entries with a block copy of the storage (entries at the same positions, the
+	 * index taken over as is), then clones nested Scopes. While CloneShared runs the other Datums are shared instead.
+	 * @param other : Scope using Storage::Flat
+	*/
+	void Scope::CopyFlat(const Scope& other) {
+		if (!_shareOnCopy) {
+			// Block copy of the entries and their index, only the nested Scopes need fixing up
+			_flat.CopyFrom(other._flat);
+		}
+		else {
+			_flat.Reserve(other._flat.Size());
+			for (size_t i = 0; i < other._flat.Size(); ++i) {
+				const FlatScopeStorage::Entry& entry = other._flat[i];
+				Datum& value = _flat.Append(entry.Key).Value;
+				if (entry.Value._type == Datum::DatumType::Table) {
+					value = entry.Value;
+				}
+				else {
+					value.Share(entry.Value);
+				}
+			}
+		}
+		for (size_t i = 0; i < _flat.Size(); ++i) {
+			FlatScopeStorage::Entry& entry = _flat[i];
+			if (entry.Value._type == Datum::DatumType::Table) {
+				for (size_t j = 0; j < entry.Value.Size(); ++j) {
+					// Clone shares too while CloneShared runs
+					Scope* newScope = other._flat[i].Value.GetScope(j)->Clone();
+					entry.Value.Set(j, newScope);
+					AttachChild(*newScope, entry.Key, j);
+				}
+			}
+		}
+	}
+
 	/** Find
 	 * @brief Searches the current scope's hash map for the key and returns the corresponding Datum 
-	 * @param key 
+	 * @param key : interned key
 	 * @return Datum* pointing to the Datum associated with the key, or nullptr if the key is not in the map.
 	*/
-	Datum* Scope::Find(const std::string key)
+	Datum* Scope::Find(Symbol key)
 	{
-		// Looks into _data for the key
-		for (auto& pair : _data) {
-			if (pair.first == key) {
-				return &pair.second;
+		if (_storage == Storage::Flat) {
+			Datum* datum = _flat.Find(key);
+			if (datum != nullptr) {
+				Unshare(*datum);
 			}
+			return datum;
+		}
+		auto it = _data.find(key);
+		if (it != _data.end()) {
+			Unshare(it->second);
+			return &it->second;
 		}
 		return nullptr;
 	}
 
 	// const Find
-	const Datum* Scope::Find(const std::string key) const
+	const Datum* Scope::Find(Symbol key) const
 	{
-		// Looks into _data for the key
-		for (auto& pair : _data) {
-			if (pair.first == key) {
-				return &pair.second;
-			}
+		if (_storage == Storage::Flat) {
+			return _flat.Find(key);
+		}
+		auto it = _data.find(key);
+		if (it != _data.end()) {
+			return &it->second;
 		}
 		return nullptr;
 	}
 
+	/** Find
+	 * @brief Resolves key in the symbol table then searches the hash map with it. A key that was never
+	 * interned can't be in any Scope, so it returns without touching _data.
+	 * @param key 
+	 * @return Datum* pointing to the Datum associated with the key, or nullptr if the key is not in the map.
+	*/
+	Datum* Scope::Find(std::string_view key)
+	{
+		Symbol symbol = Symbol::Find(key);
+		return symbol.IsValid() ? Find(symbol) : nullptr;
+	}
+
+	// const Find
+	const Datum* Scope::Find(std::string_view key) const
+	{
+		Symbol symbol = Symbol::Find(key);
+		return symbol.IsValid() ? Find(symbol) : nullptr;
+	}
+
 	/** Search
-	 * @brief A more advanced form of Find which looks through the current scope and it's ancestros for the key
-	 * @param key : const std::string
+	 * @brief A more advanced form of Find which looks through the current scope and it's ancestros for the key.
+	 * Results are cached per Scope, repeating a Search costs a generation check until a Scope up the chain
+	 * gains a key or this Scope is moved in the hierarchy.
+	 * @param key : interned key
 	 * @param scope : Scope** used as output if a scope is provided to indicate the containing scope of the Datum if found
 	 * @return Datum* to Datum associated with key, and if Scope** is not nullptr it is populated with the containing scope
 	*/
-	Datum* Scope::Search(const std::string key, Scope** scope) {
-		// Uses Find to try and find Datum value with Key in this scope
-		Datum* d = Find(key);
-		if (d == nullptr) {
-			// if this scope has a parent have them call search
-			if (GetParent() != nullptr) {
-				d = Parent->Search(key, scope);
-				return d;
-			}
-			else {
-				return nullptr;
-			}
-		}
-		else {
+	Datum* Scope::Search(Symbol key, Scope** scope) {
+		Scope* owner = nullptr;
+		Datum* d = ResolveSearch(key, owner);
+		if (d != nullptr) {
+			// Writable access copies a shared Datum like Find does
+			owner->Unshare(*d);
 			if (scope != nullptr) {
-				*scope = this;
+				*scope = owner;
 			}
-			return d;
+		}
+		return d;
+	};
 
+	const Datum* Scope::Search(Symbol key, const Scope** scope) const{
+		Scope* owner = nullptr;
+		const Datum* d = ResolveSearch(key, owner);
+		if (d != nullptr && scope != nullptr) {
+			*scope = owner;
 		}
+		return d;
 	};
 
-	const Datum* Scope::Search(const std::string key, const Scope** scope) const{
-		// Uses Find to try and find Datum value with Key in this scope
-		const Datum* d = Find(key);
-		if (d == nullptr) {
-			// if this scope has a parent have them call search
-			if (GetParent() != nullptr) {
-				d = Parent->Search(key, scope);
-				return d;
-			}
-			else {
-				return nullptr;
+	/** ResolveSearch
+	 * @brief Looks key up in the Search cache, or walks up the parents with the const Find and caches what it finds
+	 * (including nothing). Filling the cache flags every ancestor so InvalidateSearches knows to visit this Scope.
+	 * @param key : interned key
+	 * @param owner : set to the Scope holding the Datum
+	 * @return the Datum, nullptr if no Scope up the chain has key
+	*/
+	Datum* Scope::ResolveSearch(Symbol key, Scope*& owner) const {
+		SearchCache::Entry* entry = nullptr;
+		if (_searchCache != nullptr) {
+			entry = &_searchCache->Entries[key.Id() % SearchCache::Slots];
+			if (entry->Key == key && entry->Generation == _generation) {
+				++_searchStats.Hits;
+				owner = entry->Owner;
+				return entry->Found;
 			}
 		}
 		else {
-			if (scope != nullptr) {
-				*scope = this;
+			_searchCache = std::make_unique<SearchCache>();
+			entry = &_searchCache->Entries[key.Id() % SearchCache::Slots];
+		}
+		++_searchStats.Misses;
+
+		Datum* found = nullptr;
+		owner = nullptr;
+		for (const Scope* current = this; current != nullptr; current = current->Parent) {
+			const Datum* d = current->Find(key);
+			if (d != nullptr) {
+				// Search only hands out Datums of Scopes reachable from a writable this
+				found = const_cast<Datum*>(d);
+				owner = const_cast<Scope*>(current);
+				break;
 			}
-			return d;
+		}
+		*entry = { key, _generation, found, owner };
+		WatchedGeneration();
+		return found;
+	}
 
+	/** WatchedGeneration
+	 * @brief Flags this Scope and its ancestors so the next change InvalidateSearches sees bumps the generation
+	 * @return the current generation, anything resolved through this Scope stays valid while it matches
+	*/
+	std::uint64_t Scope::WatchedGeneration() const {
+		for (const Scope* current = this; current != nullptr; current = current->Parent) {
+			// Objects updated in parallel flag their shared ancestors from several threads
+			std::atomic_ref<bool> flagged(current->_searchCached);
+			if (flagged.load(std::memory_order_relaxed)) {
+				break;
+			}
+			flagged.store(true, std::memory_order_relaxed);
 		}
-	};
+		return _generation;
+	}
+
+	/** InvalidateSearches
+	 * @brief Drops the cached Search results of this Scope and its descendants, called when this Scope gains a key,
+	 * is reparented, or has its content replaced. Subtrees nothing was cached in are skipped.
+	*/
+	void Scope::InvalidateSearches() {
+		if (!_searchCached) {
+			return;
+		}
+		_searchCached = false;
+		_generation = NextGeneration();
+		for (size_t i = 0; i < GetSize(); ++i) {
+			const Datum& datum = StoredAt(i);
+			if (datum._type == Datum::DatumType::Table) {
+				for (Scope* child : datum.AsConstSpan<Scope*>()) {
+					if (child != nullptr && child->Parent == this) {
+						child->InvalidateSearches();
+					}
+				}
+			}
+		}
+	}
+
+	// Search by name, resolving the key in the symbol table once for the whole parent chain
+	Datum* Scope::Search(std::string_view key, Scope** scope) {
+		Symbol symbol = Symbol::Find(key);
+		return symbol.IsValid() ? Search(symbol, scope) : nullptr;
+	}
+
+	const Datum* Scope::Search(std::string_view key, const Scope** scope) const {
+		Symbol symbol = Symbol::Find(key);
+		return symbol.IsValid() ? Search(symbol, scope) : nullptr;
+	}
 
 	/** Append
 	 * @brief Takes the key, tries to find it in the hashmap and returns it or if it doesn't exist, creates a new one and adds it
 	 * to the map with given key. Returns created Datum
-	 * @param key : std::string 
+	 * @param key : interned key
 	 * @return Datum& of existing Datum or newly constructed Datum inserted in map
 	*/
-	Datum& Scope::Append(const std::string key) {
+	Datum& Scope::Append(Symbol key) {
+		if (_storage == Storage::Flat) {
+			bool created = false;
+			Datum& datum = _flat.Append(key, &created).Value;
+			if (created) {
+				// A new key can hide an ancestor's for Searches below, and may have moved the flat entries
+				InvalidateSearches();
+			}
+			Unshare(datum);
+			return datum;
+		}
 		// Looks into _data for the key
 		auto it = _data.find(key);
 		if (it != _data.end()) {
+			Unshare(it->second);
 			return it->second;
 		}
 		else {
-			Datum newDatum;
-			auto temp = _data.insert(std::make_pair(key, newDatum));
-			v_data.push_back(&temp.first->second);
+			auto temp = _data.try_emplace(key);
+			v_data.push_back(&*temp.first);
+			InvalidateSearches();
 			return temp.first->second;
 		}
 	}
 
+	// Append by name, interning the key if it is new
+	Datum& Scope::Append(std::string_view key) {
+		return Append(Symbol(key));
+	}
+
 	/**
 	 * @brief Treats Scope as a hash map and returns Datum ref associated with key
-	 * @param key : const std::string
+	 * @param key : std::string_view
 	 * @return Datum&
 	*/
-	Datum& Scope::operator[](const std::string key) {
+	Datum& Scope::operator[](std::string_view key) {
 		return Append(key);
 	}
 
@@ -279,29 +483,55 @@ namespace Fiea::GameEngine{
 	 * @return Datum&
 	*/
 	Datum& Scope::operator[](std::uint32_t idx) {
-		return *v_data[idx];
+		return DatumAt(idx);
+	}
+
+	// const access by index, never copies a shared Datum
+	const Datum& Scope::operator[](std::uint32_t idx) const {
+		return DatumAt(idx);
+	}
+
+	/** DatumAt
+	 * @brief Retrieves the Datum at idx in insertion order, whatever the storage
+	 * @param idx
+	 * @return Datum&
+	*/
+	Datum& Scope::DatumAt(size_t idx) {
+		Datum& datum = StoredAt(idx);
+		Unshare(datum);
+		return datum;
+	}
+
+	// DatumAt without copying shared Datums, for walking a Scope's own bookkeeping
+	Datum& Scope::StoredAt(size_t idx) {
+		return _storage == Storage::Flat ? _flat[idx].Value : v_data[idx]->second;
+	}
+
+	const Datum& Scope::DatumAt(size_t idx) const {
+		return _storage == Storage::Flat ? _flat[idx].Value : v_data[idx]->second;
 	}
 
 	/** AppendScope:
 	 * @brief Appends a Scope into the Datum associated with the key, if it does not exist it Creates a new one
-	 * @param key : std::string
+	 * @param key : std::string_view
 	 * @return Scope&
 	*/
-	Scope& Scope::AppendScope(const std::string key, Scope* s) {
-		Datum& dt = Append(key);
+	Scope& Scope::AppendScope(std::string_view key, Scope* s) {
+		Symbol symbol(key);
+		Datum& dt = Append(symbol);
 		if (s == nullptr) {
 			// If type is already set to Table then it's not a new Datum
 			if (dt._type == Datum::DatumType::Table) {
-				Scope* sc = NEW Scope;
+				Scope* sc = CreateChild();
 				dt.Push(sc);
-				sc->Parent = this;
+				AttachChild(*sc, symbol, dt.Size() - 1);
 				return *sc;
 			}
 			else if (dt._type == Datum::DatumType::Unknown) {
-				Scope* sc = NEW Scope;
+				Scope* sc = CreateChild();
 				dt.SetType(sc);
 				dt.Push(sc);
-				sc->Parent = this;
+				AttachChild(*sc, symbol, dt.Size() - 1);
 				return *sc;
 			}
 			else {
@@ -312,13 +542,13 @@ namespace Fiea::GameEngine{
 			// If type is already set to Table then it's not a new Datum
 			if (dt._type == Datum::DatumType::Table) {
 				dt.Push(s);
-				s->Parent = this;
+				AttachChild(*s, symbol, dt.Size() - 1);
 				return *s;
 			}
 			else if (dt._type == Datum::DatumType::Unknown) {
 				dt.SetType(s);
 				dt.Push(s);
-				s->Parent = this;
+				AttachChild(*s, symbol, dt.Size() - 1);
 				return *s;
 			}
 			else {
@@ -330,9 +560,9 @@ namespace Fiea::GameEngine{
 	/** Adopt
 	 * @brief Appends a Scope into this scope's children
 	 * @param Scope& scope: Reference to scope you want to Adopt
-	 * @param std::string key: Key for the Datum you want to Append the Adopted Scope to
+	 * @param Symbol key: Key for the Datum you want to Append the Adopted Scope to
 	*/
-	void Scope::Adopt(Scope& scope, const std::string key) {
+	void Scope::Adopt(Scope& scope, Symbol key) {
 		if (!isAncestorOf(&scope)) { // Prevents Circualar parentage
 			if (scope.Parent != nullptr) { // If not allready orphaned from parent
 				scope.Orphan();
@@ -342,22 +572,29 @@ namespace Fiea::GameEngine{
 			if (ds == nullptr) {
 				Datum& newDatum = Append(key);
 				newDatum.Push(&scope);
-				scope.Parent = this;
+				AttachChild(scope, key, newDatum.Size() - 1);
 			}
 			else {
 				ds->Push(&scope);
-				v_data.push_back(ds);
-				scope.Parent = this;
+				if (_storage == Storage::Hashed) {
+					v_data.push_back(&*_data.find(key));
+				}
+				AttachChild(scope, key, ds->Size() - 1);
 			}
 		}
 	}
 
+	// Adopt by name
+	void Scope::Adopt(Scope& scope, std::string_view key) {
+		Adopt(scope, Symbol(key));
+	}
+
 	/**
 	 * @brief Checks if the 
 	 * @return 
 	*/
 	bool Scope::isEmpty() {
-		if (_data.size() == 0 && v_data.size() == 0) {
+		if (_data.size() == 0 && v_data.size() == 0 && _flat.Size() == 0) {
 			return true;
 		}
 		else {
@@ -371,18 +608,18 @@ namespace Fiea::GameEngine{
 	*/
 	std::string Scope::ToString() const {
 		std::stringstream ss;
-		for (size_t i = 0; i < v_data.size(); ++i) {
-			ss << v_data[i]->ToString();
+		for (size_t i = 0; i < GetSize(); ++i) {
+			ss << DatumAt(i).ToString();
 			ss << " // ";
 		}
 		return ss.str();
 	}
 
 	size_t Scope::GetCapacity() {
-		return v_data.capacity();
+		return _storage == Storage::Flat ? _flat.Capacity() : v_data.capacity();
 	};
 	const size_t Scope::GetCapacity() const {
-		return v_data.capacity();
+		return _storage == Storage::Flat ? _flat.Capacity() : v_data.capacity();
 	}
 
 	/** Comparison Operator
@@ -396,14 +633,16 @@ namespace Fiea::GameEngine{
 		}
 		else {
 			for (size_t i = 0; i < GetSize(); ++i) {
-				if (v_data[i]->_type != Datum::DatumType::Table && scope.v_data[i]->_type != Datum::DatumType::Table) {
-					if (*v_data[i] != *scope.v_data[i]) {
+				const Datum& lhsDatum = DatumAt(i);
+				const Datum& rhsDatum = scope.DatumAt(i);
+				if (lhsDatum._type != Datum::DatumType::Table && rhsDatum._type != Datum::DatumType::Table) {
+					if (lhsDatum != rhsDatum) {
 						return false;
 					}
 				}
 				else {
-					for (size_t j = 0; j < v_data[i]->Size(); ++j) {
-						if (*v_data[i]->GetScope(j) != *scope.v_data[i]->GetScope(j)) {
+					for (size_t j = 0; j < lhsDatum.Size(); ++j) {
+						if (*lhsDatum.GetScope(j) != *rhsDatum.GetScope(j)) {
 							return false;
 						}
 					}
@@ -429,47 +668,135 @@ namespace Fiea::GameEngine{
 	 * @return Datum *: datum pointer of containing Datum; idx: index of Scope in returned Datum
 	*/
 	Datum* Scope::FindContainedScope(const Scope* scope, std::uint32_t& idx) {
+		// Children know where they are held
+		if (scope->Parent == this) {
+			Datum* datum = const_cast<Scope*>(scope)->FindContainingDatum(idx);
+			if (datum != nullptr) {
+				return datum;
+			}
+		}
 		// Loops through all Datums in Scope
-		for (std::uint32_t i = 0; i < v_data.size(); ++i) {
-			if (v_data[i]->_type == Datum::DatumType::Table) { // If Datum is of type Table
-				// Loop through Scopes in Datum
-				for (std::uint32_t j = 0; j < v_data[i]->Size(); ++j) {
-					// If Scope was found return index(idx) and Datum*
-					if (v_data[i]->GetScope(j) == scope) {
-						idx = j;
-						return v_data[i];
-					}
+		for (std::uint32_t i = 0; i < GetSize(); ++i) {
+			Datum& datum = DatumAt(i);
+			if (datum._type == Datum::DatumType::Table) { // If Datum is of type Table
+				// Look for the Scope among the Datum's Scopes
+				std::span<Scope*> scopes = datum.AsSpan<Scope*>();
+				auto found = std::find(scopes.begin(), scopes.end(), scope);
+				// If Scope was found return index(idx) and Datum*
+				if (found != scopes.end()) {
+					idx = static_cast<std::uint32_t>(found - scopes.begin());
+					return &datum;
 				}
 			}
 		}
 		return nullptr;
 	};
 
+	/** FindContainingDatum
+	 * @brief Finds the Table Datum in the Parent that holds this Scope. The key and index recorded when this Scope
+	 * was parented make it a single lookup, a Table changed directly through Datum falls back to searching the Parent.
+	 * @param std::uint32_t idx: set to the index of this Scope in the returned Datum
+	 * @return Datum * holding this Scope, nullptr if there is no Parent or it doesn't hold this Scope
+	*/
+	Datum* Scope::FindContainingDatum(std::uint32_t& idx) {
+		if (Parent == nullptr) {
+			return nullptr;
+		}
+		Datum* recorded = Parent->Find(_parentKey);
+		if (recorded != nullptr && recorded->_type == Datum::DatumType::Table && _parentSlot < recorded->Size()
+			&& static_cast<Scope* const*>(recorded->_mData)[_parentSlot] == this) {
+			idx = _parentSlot;
+			return recorded;
+		}
+		for (size_t i = 0; i < Parent->GetSize(); ++i) {
+			Datum& temp = Parent->StoredAt(i);
+			if (temp._type == Datum::DatumType::Table) {
+				std::span<Scope* const> scopes = temp.AsConstSpan<Scope*>();
+				auto found = std::find(scopes.begin(), scopes.end(), this);
+				if (found != scopes.end()) {
+					idx = static_cast<std::uint32_t>(found - scopes.begin());
+					return &temp;
+				}
+			}
+		}
+		return nullptr;
+	}
+
 	/** Orphan
-	 * @brief Orphan's this Scope from it's Parent
-	 * @param scope 
-	 * @return 
+	 * @brief Orphan's this Scope from it's Parent in constant time. The last Scope of the Table takes this one's place,
+	 * so the order of the siblings isn't kept.
+	 * @return this, or nullptr if the Parent doesn't hold this Scope
 	*/
 	Scope* Scope::Orphan() {
 		if (Parent == nullptr) {
 			return this;
 		}
+		std::uint32_t slot = 0;
+		Datum* temp = FindContainingDatum(slot);
+		if (temp == nullptr) {
+			return nullptr;
+		}
+		Scope* parent = Parent;
+		parent->RemoveChildAt(*temp, slot);
+		Parent = nullptr;
+		InvalidateSearches();
+		parent->ScopesChanged(_parentKey);
+		return this;
+	}
+
+	/** Reserve
+	 * @brief Makes room for capacity attributes up front, used by Attributed which knows how many it prescribes
+	 * @param capacity : number of attributes
+	*/
+	void Scope::Reserve(size_t capacity) {
+		if (_storage == Storage::Flat) {
+			_flat.Reserve(capacity);
+		}
 		else {
-			for (size_t i = 0; i < Parent->v_data.size(); ++i) {
-				if (Parent->v_data[i]->_type == Datum::DatumType::Table) {
-					Datum& temp = *Parent->v_data[i];
-					for (size_t j = 0; j < temp.Size(); ++j) {
-						if (temp.GetScope(j) == this) {
-							temp.RemoveAt(j);
-							Parent = nullptr;
-							return this;
-						}
-					}
+			_data.reserve(capacity);
+			v_data.reserve(capacity);
+		}
+	}
 
-				}
+	/** AttachChild
+	 * @brief Parents child, which has just been stored at slot in the Table Datum at key, and records where it is
+	 * so Orphan doesn't have to search for it
+	 * @param child : Scope held by this one
+	 * @param key : key of the Table Datum holding child
+	 * @param slot : index of child in that Datum
+	*/
+	void Scope::AttachChild(Scope& child, Symbol key, size_t slot) {
+		child.Parent = this;
+		child._parentKey = key;
+		child._parentSlot = static_cast<std::uint32_t>(slot);
+		child.InvalidateSearches();
+		ScopesChanged(key);
+	}
+
+	/** ScopesChanged
+	 * @brief Tells this Scope, and the one holding it, that the Table at key gained or lost a Scope
+	 * @param key : key of the Table Datum in this Scope
+	*/
+	void Scope::ScopesChanged(Symbol key) {
+		NestedScopesChanged(key);
+		if (Parent != nullptr) {
+			Parent->NestedScopesChanged(_parentKey);
+		}
+	}
+
+	/** RemoveChildAt
+	 * @brief Swap removes slot from one of this Scope's Table Datums and updates the index of the Scope moved into it
+	 * @param table : Table Datum of this Scope
+	 * @param slot : index to remove
+	*/
+	void Scope::RemoveChildAt(Datum& table, size_t slot) {
+		table.RemoveAtUnordered(slot);
+		if (slot < table.Size()) {
+			Scope* moved = static_cast<Scope**>(table._mData)[slot];
+			if (moved != nullptr && moved->Parent == this) {
+				moved->_parentSlot = static_cast<std::uint32_t>(slot);
 			}
 		}
-		return nullptr;
 	}
 
 	/** isDescendantOf
@@ -486,7 +813,7 @@ namespace Fiea::GameEngine{
 			return true;
 		}
 		else {
-			return Parent->isAncestorOf(scope);
+			return Parent->isDescendantOf(scope);
 		}
 	}
 
@@ -503,17 +830,50 @@ namespace Fiea::GameEngine{
 	 * @brief destroys all the children and content of this Scope wiping it clean 
 	*/
 	void Scope::Clear() {
-		for (size_t i = 0; i < v_data.size(); ++i) {
+		for (size_t i = 0; i < GetSize(); ++i) {
 			// Delete all scopes in the Table types
-			if (v_data[i]->_type == Datum::DatumType::Table) {
-				Scope** scopePtr = static_cast<Scope**>(v_data[i]->_mData);
-				while(!v_data[i]->Empty())
+			Datum& datum = StoredAt(i);
+			if (datum._type == Datum::DatumType::Table) {
+				Scope** scopePtr = static_cast<Scope**>(datum._mData);
+				while(!datum.Empty())
 				{
 					if (scopePtr[0] == nullptr) break;
-					delete scopePtr[0];
+					Destroy(scopePtr[0]);
 				}
 			}
 		}
 	}
 
-}
\ No newline at end of file
+	/** CreateChild
+	 * @brief Makes a new empty child Scope. Without a resource it's NEW'd, otherwise it is placed in the resource
+	 * and shares it, so a whole tree built through AppendScope lives in one arena.
+	 * @return the child, still to be parented
+	*/
+	Scope* Scope::CreateChild() {
+		if (_resource == nullptr) {
+			return NEW Scope;
+		}
+		void* memory = _resource->allocate(sizeof(Scope), alignof(Scope));
+		Scope* child = new(memory) Scope(0, Storage::Hashed, _resource);
+		child->_owner = _resource;
+		return child;
+	}
+
+	/** Destroy
+	 * @brief Deletes scope, handing its memory back to the resource it was created in if AppendScope placed it
+	 * in one. Scopes that may come from a resource must be released through here rather than delete.
+	 * @param scope
+	*/
+	void Scope::Destroy(Scope* scope) {
+		if (scope == nullptr) {
+			return;
+		}
+		std::pmr::memory_resource* owner = scope->_owner;
+		if (owner == nullptr) {
+			delete scope;
+			return;
+		}
+		scope->~Scope();
+		owner->deallocate(scope, sizeof(Scope), alignof(Scope));
+	}
+}
@@ -1,17 +1,45 @@
 #pragma once
 #include "RTTI.h"
 #include "Datum.h"
+#include "Symbol.h"
+#include "FlatScopeStorage.h"
+#include "HeapResource.h"
 #include <unordered_map>
+#include <string_view>
+#include <memory_resource>
+#include <memory>
+#include <atomic>
 
 namespace Fiea::GameEngine {
+	class AttributePath;
+
 	class Scope : public RTTI {
 		RTTI_DECLARATIONS(Scope, RTTI);
+		friend AttributePath;
 
 	public:
+		/** Storage
+		 * @brief Attribute layout of a Scope, picked at construction and kept by copies and clones.
+		 * Hashed keeps every Datum in its own hash map node, Flat packs them contiguously with a small
+		 * open addressing index (see FlatScopeStorage).
+		*/
+		enum class Storage {
+			Hashed,
+			Flat
+		};
+
+		/** SearchStats
+		 * @brief How many Search calls were answered from the Scopes' caches and how many walked the parents
+		*/
+		struct SearchStats {
+			std::size_t Hits;
+			std::size_t Misses;
+		};
+
 		// Default ctor
-		Scope() : Parent(nullptr), _data(), v_data() {};
+		Scope() : Parent(nullptr) {};
 
-		Scope(std::uint32_t initCapacity);
+		Scope(std::uint32_t initCapacity, Storage storage = Storage::Hashed, std::pmr::memory_resource* resource = nullptr);
 
 		~Scope();
 
@@ -23,26 +51,33 @@ namespace Fiea::GameEngine {
 
 		Scope& operator=(Scope&& rhs) noexcept;
 
-		Datum* Find(const std::string key);
-		const Datum* Find(const std::string key) const;
+		Datum* Find(Symbol key);
+		const Datum* Find(Symbol key) const;
+		Datum* Find(std::string_view key);
+		const Datum* Find(std::string_view key) const;
 
-		Datum* Search(const std::string key, Scope** scope = nullptr);
-		const Datum* Search(const std::string key, const Scope** scope = nullptr) const;
+		Datum* Search(Symbol key, Scope** scope = nullptr);
+		const Datum* Search(Symbol key, const Scope** scope = nullptr) const;
+		Datum* Search(std::string_view key, Scope** scope = nullptr);
+		const Datum* Search(std::string_view key, const Scope** scope = nullptr) const;
 
-		Datum& Append(const std::string key);
+		Datum& Append(Symbol key);
+		Datum& Append(std::string_view key);
 
-		Scope& AppendScope(const std::string key, Scope* s = nullptr);
+		Scope& AppendScope(std::string_view key, Scope* s = nullptr);
 
-		void Adopt(Scope& scope, std::string key);
+		void Adopt(Scope& scope, Symbol key);
+		void Adopt(Scope& scope, std::string_view key);
 
 		Scope* GetParent() { return Parent; };
 		const Scope* GetParent() const { return Parent; };
 
-		void SetParent(Scope* parent) { Parent = parent; };
+		void SetParent(Scope* parent) { Parent = parent; InvalidateSearches(); };
 
-		Datum& operator[](std::string key);
+		Datum& operator[](std::string_view key);
 
 		Datum& operator[](std::uint32_t idx);
+		const Datum& operator[](std::uint32_t idx) const;
 
 		bool operator==(const Scope& scope) const;
 
@@ -50,13 +85,20 @@ namespace Fiea::GameEngine {
 
 		Datum* FindContainedScope(const Scope*, std::uint32_t& idx);
 
+		Datum* FindContainingDatum(std::uint32_t& idx);
+
 		bool isEmpty();
 
 		size_t GetCapacity();
 		const size_t GetCapacity() const;
 
-		size_t GetSize() { return v_data.size(); };
-		const size_t GetSize() const { return v_data.size(); };
+		size_t GetSize() { return _storage == Storage::Flat ? _flat.Size() : v_data.size(); };
+		const size_t GetSize() const { return _storage == Storage::Flat ? _flat.Size() : v_data.size(); };
+
+		Storage GetStorage() const { return _storage; };
+
+		// Resource this Scope's attributes and child Scopes allocate from, nullptr for the heap
+		std::pmr::memory_resource* GetResource() const { return _resource; };
 
 		std::string ToString() const override;
 		//bool Equals(const RTTI* rhs) const override;
@@ -67,12 +109,73 @@ namespace Fiea::GameEngine {
 
 		virtual Scope* Clone() const;
 
+		Scope* CloneShared() const;
+
+		static void Destroy(Scope* scope);
+
+		// Search cache counters of the calling thread since its last reset, shared by every Scope
+		static SearchStats GetSearchStats() { return _searchStats; };
+		static void ResetSearchStats() { _searchStats = SearchStats{}; };
+
 		bool isAncestorOf(Scope* scope);
 		bool isDescendantOf(Scope* scope);
 
+	protected:
+		void AttachChild(Scope& child, Symbol key, size_t slot);
+		void Reserve(size_t capacity);
+
+		// Called after a Scope was attached to or orphaned from the Table at key, of this Scope or of a Scope it holds
+		virtual void NestedScopesChanged(Symbol) {};
+
 	private:
-		std::unordered_map<std::string, Datum> _data;
-		std::vector<Datum*>v_data;
+		Datum& DatumAt(size_t idx);
+		const Datum& DatumAt(size_t idx) const;
+		Datum& StoredAt(size_t idx);
+		void CopyFlat(const Scope& other);
+		void CopyHashed(const Scope& other);
+		void MoveHashed(Scope& rhs);
+		Scope* CreateChild();
+		void Unshare(Datum& datum) { datum.Detach(); };
+		void AdoptChildren(const Datum& datum);
+		void RemoveChildAt(Datum& table, size_t slot);
+		void ScopesChanged(Symbol key);
+		Datum* ResolveSearch(Symbol key, Scope*& owner) const;
+		void InvalidateSearches();
+		std::uint64_t WatchedGeneration() const;
+		static std::uint64_t NextGeneration() { return _nextGeneration.fetch_add(1, std::memory_order_relaxed); };
+
+		// Set while CloneShared runs, makes the copy constructors share instead of deep copy
+		inline static thread_local bool _shareOnCopy = false;
+		inline static thread_local SearchStats _searchStats; // per thread so parallel updates don't race on it
+		inline static std::atomic<std::uint64_t> _nextGeneration{ 1 };
+
+		// A few direct mapped Search results, indexed by key
+		struct SearchCache {
+			static constexpr std::size_t Slots = 8;
+			struct Entry {
+				Symbol Key;
+				std::uint64_t Generation = 0;
+				Datum* Found = nullptr;
+				Scope* Owner = nullptr;
+			};
+			Entry Entries[Slots];
+		};
+
+		using HashedEntry = std::pair<const Symbol, Datum>;
+
+		std::pmr::unordered_map<Symbol, Datum> _data{ HeapResource::Get() };
+		std::pmr::vector<HashedEntry*>v_data{ HeapResource::Get() }; // insertion order, map nodes never move
+		FlatScopeStorage _flat;
+		Storage _storage = Storage::Hashed;
 		Scope* Parent;
+		Symbol _parentKey; // Table Datum in Parent holding this Scope, see AttachChild
+		std::uint32_t _parentSlot = 0; // index in that Datum
+		mutable std::unique_ptr<SearchCache> _searchCache; // recent Search results, made by the first Search
+		// Cached results are valid while their generation matches. Drawn from one counter for every Scope, so a Scope
+		// made later at the same address never has a generation some cache remembers
+		mutable std::uint64_t _generation = NextGeneration();
+		mutable bool _searchCached = false; // set when this Scope or a descendant may hold valid cached results
+		std::pmr::memory_resource* _resource = nullptr; // handed to attributes and children, nullptr for the heap
+		std::pmr::memory_resource* _owner = nullptr; // resource this Scope itself was allocated from, nullptr if it was NEW'd
 	};
 }
\ No newline at end of file
@@ -1,16 +1,103 @@
 #pragma once
 
 #include "Datum.h"
+#include "Symbol.h"
+#include <array>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
 using string = std::string;
 
 namespace Fiea::GameEngine {
+	/** Signature
+	 * @brief One prescribed attribute of an Attributed type. Offset is where it lives in the object, 0 when the Scope
+	 * owns it instead. A literal type, so every type declares its Signatures as a constexpr table (see MakeSignatures)
+	 * that is checked while compiling and costs nothing to register. Name only views its characters: string literals
+	 * in those tables, the interned copy for a name given as a std::string.
+	*/
 	class Signature
 	{
-	public: 
-		string Name;
-		Datum::DatumType Type;
-		uint32_t size;
-		size_t Offset;
+	public:
+		constexpr Signature() = default;
+		constexpr Signature(std::string_view name, Datum::DatumType type, uint32_t count, size_t offset) : Name(name), Type(type), size(count), Offset(offset) {};
+		constexpr Signature(const char* name, Datum::DatumType type, uint32_t count, size_t offset) : Signature(std::string_view(name), type, count, offset) {};
+		// Runtime names are interned, the Signature may outlive name
+		Signature(const std::string& name, Datum::DatumType type, uint32_t count, size_t offset) : Signature(std::string_view(Symbol(name).Name()), type, count, offset) {};
+
+		std::string_view Name;
+		Datum::DatumType Type = Datum::DatumType::Unknown;
+		uint32_t size = 0;
+		size_t Offset = 0;
+
+		template<class Member>
+		static consteval Signature Of(std::string_view name, size_t offset, size_t objectSize);
+
+		template<class T>
+		static consteval Datum::DatumType TypeOf();
 	};
+
+	/** TypeOf
+	 * @brief DatumType of a member that can back a prescribed attribute, anything else does not compile
+	 * @tparam T : member (element) type
+	 * @return DatumType storing T
+	*/
+	template<class T>
+	consteval Datum::DatumType Signature::TypeOf() {
+		if constexpr (std::is_same_v<T, int>) return Datum::DatumType::Int;
+		else if constexpr (std::is_same_v<T, float>) return Datum::DatumType::Float;
+		else if constexpr (std::is_same_v<T, std::string>) return Datum::DatumType::String;
+		else if constexpr (std::is_same_v<T, glm::vec4>) return Datum::DatumType::Vector;
+		else if constexpr (std::is_same_v<T, glm::mat4>) return Datum::DatumType::Matrix;
+		else if constexpr (std::is_same_v<T, RTTI*>) return Datum::DatumType::Pointer;
+		else static_assert(sizeof(T) == 0, "Member type can't be a prescribed attribute");
+	}
+
+	/** Of
+	 * @brief Signature of an attribute stored in a member, its DatumType and element count come from the member's type.
+	 * Use it through the SIGNATURE macro.
+	 * @tparam Member : declared type of the member, a one dimensional array for several elements
+	 * @param name : attribute name
+	 * @param offset : offsetof the member
+	 * @param objectSize : sizeof the class, the member has to fit in it
+	 * @return the Signature
+	*/
+	template<class Member>
+	consteval Signature Signature::Of(std::string_view name, size_t offset, size_t objectSize) {
+		static_assert(std::rank_v<Member> <= 1, "Prescribed arrays must be one dimensional");
+		if (offset == 0) {
+			// Offset 0 marks Scope owned attributes, Attributed types start with their vtable pointer anyway
+			throw std::invalid_argument("A prescribed member can't be at offset 0");
+		}
+		if (offset + sizeof(Member) > objectSize) {
+			throw std::invalid_argument("Prescribed member lies outside of the object");
+		}
+		return { name, TypeOf<std::remove_cv_t<std::remove_extent_t<Member>>>(), static_cast<uint32_t>(std::is_array_v<Member> ? std::extent_v<Member> : 1), offset };
+	}
+
+	/** MakeSignatures
+	 * @brief Builds a type's Signature table at compile time. An empty name or a name declared twice does not compile.
+	 * @param signatures : the type's Signatures in the order they are appended
+	 * @return the table, meant for a static constexpr variable
+	*/
+	template<size_t N>
+	consteval std::array<Signature, N> MakeSignatures(const Signature (&signatures)[N]) {
+		std::array<Signature, N> table{};
+		for (size_t idx = 0; idx < N; ++idx) {
+			if (signatures[idx].Name.empty()) {
+				throw std::invalid_argument("Signature without a name");
+			}
+			for (size_t other = 0; other < idx; ++other) {
+				if (signatures[other].Name == signatures[idx].Name) {
+					throw std::invalid_argument("Signature name declared twice");
+				}
+			}
+			table[idx] = signatures[idx];
+		}
+		return table;
+	}
 }
 
+// Signature of the attribute Name stored in Class::Member
+#define SIGNATURE(Class, Member, Name) ::Fiea::GameEngine::Signature::Of<decltype(std::declval<Class&>().Member)>(Name, offsetof(Class, Member), sizeof(Class))
@@ -0,0 +1,83 @@
+#include "pch.h"
+#include "Sleeper.h"
+#include "GameObject.h"
+
+namespace Fiea::GameEngine {
+
+	/** Sleep
+	 * @brief Sleeps until Wake is called
+	*/
+	void Sleeper::Sleep()
+	{
+		_asleep = true;
+		_until = Never;
+		_watched = nullptr;
+		_last.reset();
+		Changed();
+	}
+
+	/** SleepUntil
+	 * @brief Sleeps until the first Update at or after gameTime, or until Wake
+	 * @param gameTime : milliseconds since start, as GameTime::Game
+	*/
+	void Sleeper::SleepUntil(Millis gameTime)
+	{
+		Sleep();
+		_until = gameTime;
+	}
+
+	/** SleepFor
+	 * @brief Sleeps for duration from time on, or until Wake
+	 * @param duration : milliseconds
+	 * @param time : the current time
+	*/
+	void Sleeper::SleepFor(Millis duration, const GameTime& time)
+	{
+		SleepUntil(time.Game() + duration);
+	}
+
+	/** SleepUntilChanged
+	 * @brief Sleeps until an Update finds watched changed, or until Wake. Every Update compares it to its value
+	 * right now, so watch attributes of the sleeper's own GameObject (or of anything else sure to outlive the sleep).
+	 * @param watched : attribute to watch
+	*/
+	void Sleeper::SleepUntilChanged(const Datum& watched)
+	{
+		Sleep();
+		_watched = &watched;
+		_last.emplace(watched.Owned());
+	}
+
+	/** Wake
+	 * @brief Updates this again from the next Update on, does nothing if it is awake
+	*/
+	void Sleeper::Wake()
+	{
+		if (!_asleep) {
+			return;
+		}
+		_asleep = false;
+		_until = Never;
+		_watched = nullptr;
+		_last.reset();
+		Changed();
+	}
+
+	/** Due
+	 * @param now : game time of the Update
+	 * @return true if the timer ran out or the watched attribute changed
+	*/
+	bool Sleeper::Due(Millis now) const
+	{
+		return (_until != Never && now >= _until) || (_watched != nullptr && *_watched != *_last);
+	}
+
+	// Makes the owner and its ancestors schedule their subtrees again
+	void Sleeper::Changed()
+	{
+		GameObject* owner = SleepOwner();
+		if (owner != nullptr) {
+			owner->InvalidateActiveList();
+		}
+	}
+}
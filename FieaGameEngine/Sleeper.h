@@ -0,0 +1,51 @@
+#pragma once
+#include "Datum.h"
+#include "GameClock.h"
+#include <optional>
+
+namespace Fiea::GameEngine {
+	class GameObject;
+
+	/** Sleeper
+	 * @brief Sleep state shared by GameObjects and Actions. GameObject::Update skips a sleeping Action, and a sleeping
+	 * GameObject together with its whole subtree, until it is woken: by Wake (event handlers call it), by its timer
+	 * running out, or by a write to the attribute it watches. Only the sleepers with a timer or a watched attribute
+	 * cost anything while asleep. Sleeping and waking take effect from the next Update, and only count for Actions
+	 * held directly in a GameObject's Actions.
+	*/
+	class Sleeper {
+	public:
+		using Millis = GameTime::Millis;
+
+		bool IsAsleep() const { return _asleep; };
+
+		void Sleep();
+		void SleepUntil(Millis gameTime);
+		void SleepFor(Millis duration, const GameTime& time);
+		void SleepUntilChanged(const Datum& watched);
+		void Wake();
+
+	protected:
+		Sleeper() = default;
+		// Copies start awake
+		Sleeper(const Sleeper&) noexcept {};
+		Sleeper& operator=(const Sleeper&) noexcept { return *this; };
+		~Sleeper() = default;
+
+		// GameObject scheduling this sleeper, nullptr if there is none
+		virtual GameObject* SleepOwner() = 0;
+
+	private:
+		friend GameObject;
+
+		bool Due(Millis now) const;
+		void Changed();
+
+		static constexpr Millis Never = -1;
+
+		bool _asleep = false;
+		Millis _until = Never; // game time the timer runs out at
+		const Datum* _watched = nullptr; // has to outlive the sleep
+		std::optional<Datum> _last; // _watched as it was when going to sleep, Datums can't be assigned another type
+	};
+}
@@ -0,0 +1,105 @@
+#include "pch.h"
+#include "Symbol.h"
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+
+#ifdef _DEBUG
+#include <crtdbg.h>
+#endif
+
+namespace Fiea::GameEngine {
+
+	/** SymbolTable
+	 * @brief Global storage for interned names. Names live in a deque so the string_view keys of the
+	 * index keep pointing at valid characters as the table grows. Lookups share the lock, interning a new name
+	 * takes it alone, so keys can be interned from jobs running in parallel.
+	*/
+	struct SymbolTable {
+		std::deque<std::string> Names;
+		std::unordered_map<std::string_view, Symbol::IdType> Ids;
+		std::shared_mutex Lock;
+
+		static SymbolTable& Instance() {
+			// Function local static so Symbols can safely be created during static initialization
+			static SymbolTable table;
+			return table;
+		}
+	};
+
+	/** Symbol
+	 * @brief Interns name and stores its handle
+	 * @param name : name to intern
+	*/
+	Symbol::Symbol(std::string_view name) {
+		SymbolTable& table = SymbolTable::Instance();
+		{
+			std::shared_lock<std::shared_mutex> lock(table.Lock);
+			auto it = table.Ids.find(name);
+			if (it != table.Ids.end()) {
+				_id = it->second;
+				return;
+			}
+		}
+
+		// Another thread may have interned name since the lookup
+		std::unique_lock<std::shared_mutex> lock(table.Lock);
+		auto it = table.Ids.find(name);
+		if (it != table.Ids.end()) {
+			_id = it->second;
+			return;
+		}
+#ifdef _DEBUG
+		// The table lives for the whole program, keep its blocks out of the tests' leak checks
+		int dbgFlags = _CrtSetDbgFlag(_CRTDBG_REPORT_FLAG);
+		_CrtSetDbgFlag(dbgFlags & ~_CRTDBG_ALLOC_MEM_DF);
+#endif
+		const std::string& stored = table.Names.emplace_back(name);
+		_id = static_cast<IdType>(table.Names.size());
+		table.Ids.emplace(std::string_view(stored), _id);
+#ifdef _DEBUG
+		_CrtSetDbgFlag(dbgFlags);
+#endif
+	}
+
+	/** Find
+	 * @brief Looks up an already interned name
+	 * @param name : name to look up
+	 * @return Symbol of name, or an invalid Symbol if name was never interned
+	*/
+	Symbol Symbol::Find(std::string_view name) {
+		SymbolTable& table = SymbolTable::Instance();
+		std::shared_lock<std::shared_mutex> lock(table.Lock);
+		Symbol symbol;
+		auto it = table.Ids.find(name);
+		if (it != table.Ids.end()) {
+			symbol._id = it->second;
+		}
+		return symbol;
+	}
+
+	/** Count
+	 * @return number of interned names
+	*/
+	std::size_t Symbol::Count() {
+		SymbolTable& table = SymbolTable::Instance();
+		std::shared_lock<std::shared_mutex> lock(table.Lock);
+		return table.Names.size();
+	}
+
+	/** Name
+	 * @brief Retrieves the interned string
+	 * @return name the Symbol was interned from, empty string for invalid Symbols
+	*/
+	const std::string& Symbol::Name() const {
+		static const std::string empty;
+		if (_id == 0) {
+			return empty;
+		}
+		SymbolTable& table = SymbolTable::Instance();
+		std::shared_lock<std::shared_mutex> lock(table.Lock);
+		// Names never move, the reference outlives the lock
+		return table.Names[_id - 1];
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <functional>
+
+namespace Fiea::GameEngine {
+
+	/** Symbol
+	 * @brief Interned attribute key. Every distinct name is stored once in a global table and a Symbol
+	 * is just the small integer handle into it, so hashing and comparing keys never touches the characters.
+	*/
+	class Symbol final {
+	public:
+		using IdType = std::uint32_t;
+
+		// Default constructed Symbols are invalid (Id 0) and never match an interned name
+		Symbol() = default;
+
+		// Interns name, adding it to the table if it isn't there yet
+		explicit Symbol(std::string_view name);
+		explicit Symbol(const char* name) : Symbol(std::string_view(name)) {};
+		explicit Symbol(const std::string& name) : Symbol(std::string_view(name)) {};
+
+		// Looks up name without interning it, returns an invalid Symbol if name was never interned
+		static Symbol Find(std::string_view name);
+
+		// Number of names currently interned
+		static std::size_t Count();
+
+		IdType Id() const { return _id; };
+		bool IsValid() const { return _id != 0; };
+		const std::string& Name() const;
+
+		bool operator==(const Symbol& rhs) const { return _id == rhs._id; };
+		bool operator!=(const Symbol& rhs) const { return _id != rhs._id; };
+
+	private:
+		IdType _id = 0;
+	};
+}
+
+template<>
+struct std::hash<Fiea::GameEngine::Symbol> {
+	std::size_t operator()(const Fiea::GameEngine::Symbol& symbol) const noexcept { return symbol.Id(); }
+};
@@ -2,6 +2,7 @@
 #include "pch.h"
 #include "TableHelper.h"
 #include <regex>
+#include <vector>
 #include "Factory.h"
 #include "GameObject.h"
 
@@ -17,13 +18,14 @@ namespace Fiea::GameEngine {
 	 * @param key: Key to append under
 	*/
 	void TableHelper::TableWrapper::Append(int& value, const string& key, int idx) {
-		//Datum& newDatum = rootScope->Append(key);
-		// Find out which Class it is
+		// Intern the key once and use the Symbol for every lookup below
+		Symbol symbol(key);
 
+		// Find out which Class it is
 		Attributed* att = rootScope->As<Attributed>();
 		if (att != nullptr) {
-			if (att->IsPrescribedAttribute(key)) {
-				Datum* newDatum = rootScope->Find(key);
+			if (att->IsPrescribedAttribute(symbol)) {
+				Datum* newDatum = rootScope->Find(symbol);
 				if (newDatum->CheckType(Datum::DatumType::Float)) {
 					float floatValue = (float)value;
 					newDatum->Set(idx, floatValue);
@@ -33,12 +35,12 @@ namespace Fiea::GameEngine {
 				}
 			}
 			else {
-				Datum& newDatum = rootScope->Append(key);
+				Datum& newDatum = rootScope->Append(symbol);
 				newDatum.Push(value);
 			}
 		}
 		else {
-			Datum& newDatum = rootScope->Append(key);
+			Datum& newDatum = rootScope->Append(symbol);
 			newDatum.Push(value);
 		}
 	}
@@ -50,19 +52,21 @@ namespace Fiea::GameEngine {
 	*/
 	void TableHelper::TableWrapper::Append(float& value, const std::string& key, int idx)
 	{
+		Symbol symbol(key);
+
 		Attributed* att = rootScope->As<Attributed>();
 		if (att != nullptr) {
-			if (att->IsPrescribedAttribute(key)) {
-				Datum* newDatum = rootScope->Find(key);
+			if (att->IsPrescribedAttribute(symbol)) {
+				Datum* newDatum = rootScope->Find(symbol);
 				newDatum->Set(idx, value);
 			}
 			else {
-				Datum& newDatum = rootScope->Append(key);
+				Datum& newDatum = rootScope->Append(symbol);
 				newDatum.Push(value);
 			}
 		}
 		else {
-			Datum& newDatum = rootScope->Append(key);
+			Datum& newDatum = rootScope->Append(symbol);
 			newDatum.Push(value);
 		}
 	}
@@ -79,6 +83,60 @@ namespace Fiea::GameEngine {
 		newDatum.SetFromString(idx, value);
 	}
 
+	/**
+	 * @brief Appends a whole array of Ints under key, copying them into the Datum in one go
+	 * @param values : first int of the array
+	 * @param count : number of ints
+	 * @param key : Key to append under
+	*/
+	void TableHelper::TableWrapper::Append(const int* values, size_t count, const std::string& key)
+	{
+		Symbol symbol(key);
+
+		Attributed* att = rootScope->As<Attributed>();
+		if (att != nullptr && att->IsPrescribedAttribute(symbol)) {
+			// Prescribed attributes are bound to the object's members, set them element by element
+			Datum* datum = rootScope->Find(symbol);
+			bool isFloat = datum->CheckType(Datum::DatumType::Float);
+			for (size_t idx = 0; idx < count; ++idx) {
+				if (isFloat) {
+					float floatValue = (float)values[idx];
+					datum->Set(idx, floatValue);
+				}
+				else {
+					int value = values[idx];
+					datum->Set(idx, value);
+				}
+			}
+		}
+		else {
+			rootScope->Append(symbol).Append(values, count);
+		}
+	}
+
+	/**
+	 * @brief Appends a whole array of floats under key, copying them into the Datum in one go
+	 * @param values : first float of the array
+	 * @param count : number of floats
+	 * @param key : Key to append under
+	*/
+	void TableHelper::TableWrapper::Append(const float* values, size_t count, const std::string& key)
+	{
+		Symbol symbol(key);
+
+		Attributed* att = rootScope->As<Attributed>();
+		if (att != nullptr && att->IsPrescribedAttribute(symbol)) {
+			Datum* datum = rootScope->Find(symbol);
+			for (size_t idx = 0; idx < count; ++idx) {
+				float value = values[idx];
+				datum->Set(idx, value);
+			}
+		}
+		else {
+			rootScope->Append(symbol).Append(values, count);
+		}
+	}
+
 	/**
 	 * @brief Adds a scope to the current Object(Scope) and sets the scope pointer to the child
 	 * Sets the Wrapper for Depth-first population
@@ -178,17 +236,23 @@ namespace Fiea::GameEngine {
 		if (IsArray) {
 			if (value[0].isInt())
 			{
-				for (int idx = 0; idx < (int)value.size(); ++idx) {
-					int val = value[idx].asInt();
-					Twrapper->Append(val, jsonKey, idx);
+				// Convert the whole array first so the Datum is filled with a single allocation. Iterating
+				// rather than indexing, JsonCpp arrays are maps so value[idx] is a tree lookup
+				std::vector<int> values;
+				values.reserve(value.size());
+				for (const Json::Value& element : value) {
+					values.push_back(element.asInt());
 				}
-					return true;
+				Twrapper->Append(values.data(), values.size(), jsonKey);
+				return true;
 			}
 			else if (value[0].isDouble()) {
-				for (int idx = 0; idx < (int)value.size(); ++idx) {
-					float val = value[idx].asFloat();
-					Twrapper->Append(val, jsonKey, idx);
+				std::vector<float> values;
+				values.reserve(value.size());
+				for (const Json::Value& element : value) {
+					values.push_back(element.asFloat());
 				}
+				Twrapper->Append(values.data(), values.size(), jsonKey);
 				return true;
 			}
 			else if (value[0].isString()) {
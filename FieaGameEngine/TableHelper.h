@@ -15,6 +15,8 @@ namespace Fiea::GameEngine {
 			void Append(int& value, const std::string& key, int idx = 0);
 			void Append(float& value, const std::string& key, int idx = 0);
 			void Append(std::string& value, const std::string& key, int idx = 0);
+			void Append(const int* values, size_t count, const std::string& key);
+			void Append(const float* values, size_t count, const std::string& key);
 			void AppendObject(const std::string& key);
 			void IncrementCurrentDepth();
 			bool Verify(const std::string& key);
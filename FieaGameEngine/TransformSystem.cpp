@@ -0,0 +1,368 @@
+#include "pch.h"
+#include "TransformSystem.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <stdexcept>
+
+// Same switch as DatumMath, SSE on every x64 target unless scalar code is asked for
+#if !defined(FIEA_DATUM_MATH_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define FIEA_TRANSFORM_SSE
+#endif
+
+namespace Fiea::GameEngine {
+	namespace {
+		/** Compose
+		 * @brief Local matrix T * Rz * Ry * Rx * S of one object
+		*/
+		inline glm::mat4 Compose(const glm::vec4& position, const glm::vec4& rotation, const glm::vec4& scale) {
+			const float cx = std::cos(rotation.x), sx = std::sin(rotation.x);
+			const float cy = std::cos(rotation.y), sy = std::sin(rotation.y);
+			const float cz = std::cos(rotation.z), sz = std::sin(rotation.z);
+			return glm::mat4(
+				glm::vec4(cy * cz, cy * sz, -sy, 0.0f) * scale.x,
+				glm::vec4(sx * sy * cz - cx * sz, sx * sy * sz + cx * cz, sx * cy, 0.0f) * scale.y,
+				glm::vec4(cx * sy * cz + sx * sz, cx * sy * sz - sx * cz, cx * cy, 0.0f) * scale.z,
+				glm::vec4(position.x, position.y, position.z, 1.0f));
+		}
+
+		/** Multiply
+		 * @brief result = parent * local, each column of the result is parent's columns scaled by a column of local
+		*/
+		inline void Multiply(const glm::mat4& parent, const glm::mat4& local, glm::mat4& result) {
+#if defined(FIEA_TRANSFORM_SSE)
+			const __m128 c0 = _mm_loadu_ps(&parent[0].x);
+			const __m128 c1 = _mm_loadu_ps(&parent[1].x);
+			const __m128 c2 = _mm_loadu_ps(&parent[2].x);
+			const __m128 c3 = _mm_loadu_ps(&parent[3].x);
+			for (int column = 0; column < 4; ++column) {
+				const __m128 x = _mm_loadu_ps(&local[column].x);
+				__m128 sum = _mm_mul_ps(c0, _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 0, 0, 0)));
+				sum = _mm_add_ps(sum, _mm_mul_ps(c1, _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 1, 1, 1))));
+				sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 2, 2, 2))));
+				sum = _mm_add_ps(sum, _mm_mul_ps(c3, _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3))));
+				_mm_storeu_ps(&result[column].x, sum);
+			}
+#else
+			result = parent * local;
+#endif
+		}
+
+		// Points the transform attributes of object at the given storage
+		void View(GameObject& object, glm::vec4* position, glm::vec4* rotation, glm::vec4* scale) {
+			object.Find(GameObject::PositionKey)->SetStorage(position, 1, Datum::Vector);
+			object.Find(GameObject::RotationKey)->SetStorage(rotation, 1, Datum::Vector);
+			object.Find(GameObject::ScaleKey)->SetStorage(scale, 1, Datum::Vector);
+		}
+	}
+
+	// Destructor, hands every object its transform back
+	TransformSystem::~TransformSystem()
+	{
+		Clear();
+	}
+
+	/** Add
+	 * @brief Starts managing root and every GameObject below it in the Children hierarchy. Objects already in this
+	 * system are skipped, one managed by another system or stored in an EntityStore throws runtime_error. Their
+	 * transforms are copied over from ObjTransform and their attributes view the system from now on.
+	 * @param root : top of the hierarchy to add
+	*/
+	void TransformSystem::Add(GameObject& root)
+	{
+		const std::size_t before = _objects.size();
+		const glm::vec4* positions = _positions.data();
+		try {
+			AddTree(root);
+		}
+		catch (...) {
+			// The objects added so far stay, their attributes still need to view their slots
+			BindAll();
+			_ordered = false;
+			throw;
+		}
+		if (_objects.size() != before) {
+			// Growing may have moved the buffers every attribute views
+			if (_positions.data() != positions) {
+				BindAll();
+			}
+			else {
+				for (std::size_t slot = before; slot < _objects.size(); ++slot) {
+					Bind(static_cast<std::uint32_t>(slot));
+				}
+			}
+			_ordered = false;
+		}
+	}
+
+	/** AddTree
+	 * @brief Appends object and its descendants without binding their attributes
+	 * @param object : GameObject to add
+	*/
+	void TransformSystem::AddTree(GameObject& object)
+	{
+		if (object._transformBinding.System != this) {
+			if (object._transformBinding.System != nullptr) {
+				throw std::runtime_error("GameObject is managed by another TransformSystem");
+			}
+			if (object.GetEntityStore() != nullptr) {
+				throw std::runtime_error("GameObject is stored in an EntityStore");
+			}
+			_positions.push_back(object.ObjTransform.Position);
+			_rotations.push_back(object.ObjTransform.Rotation);
+			_scales.push_back(object.ObjTransform.Scale);
+			_world.push_back(glm::mat4(1.0f));
+			_parents.push_back(NoParent);
+			_objects.push_back(&object);
+			object._transformBinding.System = this;
+			object._transformBinding.Slot = static_cast<std::uint32_t>(_objects.size() - 1);
+		}
+
+		// Children sit in wrapper Scopes, each holding them under their names
+		Datum* children = object.Find(GameObject::ChildrenKey);
+		if (children == nullptr) {
+			return;
+		}
+		for (std::size_t idx = 0; idx < children->Size(); ++idx) {
+			Scope* wrapper = children->GetScope(idx);
+			for (std::uint32_t named = 0; wrapper != nullptr && named < wrapper->GetSize(); ++named) {
+				Datum& datum = (*wrapper)[named];
+				if (!datum.CheckType(Datum::DatumType::Table)) {
+					continue;
+				}
+				for (std::size_t element = 0; element < datum.Size(); ++element) {
+					GameObject* child = datum.GetScope(element)->As<GameObject>();
+					if (child != nullptr) {
+						AddTree(*child);
+					}
+				}
+			}
+		}
+	}
+
+	/** Remove
+	 * @brief Stops managing object alone, its descendants stay and become roots until it is added again. The
+	 * transform is copied back into ObjTransform, which the attributes view again. Throws invalid_argument if
+	 * object is not in this system.
+	 * @param object : managed GameObject
+	*/
+	void TransformSystem::Remove(GameObject& object)
+	{
+		const std::uint32_t slot = SlotOf(object);
+		Release(object);
+
+		// The last slot fills the gap
+		const std::uint32_t last = static_cast<std::uint32_t>(_objects.size() - 1);
+		if (slot != last) {
+			_positions[slot] = _positions[last];
+			_rotations[slot] = _rotations[last];
+			_scales[slot] = _scales[last];
+			_world[slot] = _world[last];
+			_objects[slot] = _objects[last];
+			_objects[slot]->_transformBinding.Slot = slot;
+			Bind(slot);
+		}
+		_positions.pop_back();
+		_rotations.pop_back();
+		_scales.pop_back();
+		_world.pop_back();
+		_parents.pop_back();
+		_objects.pop_back();
+		_ordered = false;
+	}
+
+	/** Clear
+	 * @brief Stops managing every object, see Remove
+	*/
+	void TransformSystem::Clear()
+	{
+		for (GameObject* object : _objects) {
+			Release(*object);
+		}
+		_positions.clear();
+		_rotations.clear();
+		_scales.clear();
+		_world.clear();
+		_parents.clear();
+		_objects.clear();
+		_ordered = true;
+	}
+
+	/** Reserve
+	 * @brief Makes room for capacity objects so adding them never moves the buffers
+	 * @param capacity : number of objects
+	*/
+	void TransformSystem::Reserve(std::size_t capacity)
+	{
+		const glm::vec4* positions = _positions.data();
+		_positions.reserve(capacity);
+		_rotations.reserve(capacity);
+		_scales.reserve(capacity);
+		_world.reserve(capacity);
+		_parents.reserve(capacity);
+		_objects.reserve(capacity);
+		if (_positions.data() != positions) {
+			BindAll();
+		}
+	}
+
+	/** Update
+	 * @brief Computes the world matrix of every object. Slots are in hierarchy order, so a single pass finds each
+	 * parent's matrix already done. Reorders first when objects were added, removed or reparented.
+	*/
+	void TransformSystem::Update()
+	{
+		if (!_ordered) {
+			Order();
+		}
+		const std::size_t count = _objects.size();
+		for (std::size_t slot = 0; slot < count; ++slot) {
+			const glm::mat4 local = Compose(_positions[slot], _rotations[slot], _scales[slot]);
+			const std::uint32_t parent = _parents[slot];
+			if (parent == NoParent) {
+				_world[slot] = local;
+			}
+			else {
+				Multiply(_world[parent], local, _world[slot]);
+			}
+		}
+	}
+
+	/** Order
+	 * @brief Finds every object's parent in the Children hierarchy and sorts the slots by depth, roots first
+	*/
+	void TransformSystem::Order()
+	{
+		const std::size_t count = _objects.size();
+		for (std::size_t slot = 0; slot < count; ++slot) {
+			_parents[slot] = NoParent;
+			Scope* wrapper = _objects[slot]->GetParent();
+			Scope* owner = wrapper != nullptr ? wrapper->GetParent() : nullptr;
+			GameObject* parent = owner != nullptr ? owner->As<GameObject>() : nullptr;
+			if (parent != nullptr && parent->_transformBinding.System == this) {
+				_parents[slot] = parent->_transformBinding.Slot;
+			}
+		}
+
+		// Depths without recursion, hierarchies can be deep
+		constexpr std::uint32_t Unknown = UINT32_MAX;
+		std::vector<std::uint32_t> depths(count, Unknown);
+		std::vector<std::uint32_t> chain;
+		for (std::uint32_t slot = 0; slot < count; ++slot) {
+			std::uint32_t top = slot;
+			chain.clear();
+			while (depths[top] == Unknown && _parents[top] != NoParent) {
+				chain.push_back(top);
+				top = _parents[top];
+			}
+			if (depths[top] == Unknown) {
+				depths[top] = 0;
+			}
+			std::uint32_t depth = depths[top];
+			for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+				depths[*it] = ++depth;
+			}
+		}
+
+		std::vector<std::uint32_t> order(count);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&depths](std::uint32_t lhs, std::uint32_t rhs) { return depths[lhs] < depths[rhs]; });
+		std::vector<std::uint32_t> slots(count);
+		for (std::uint32_t idx = 0; idx < count; ++idx) {
+			slots[order[idx]] = idx;
+		}
+
+		auto permute = [&order](auto& buffer) {
+			std::remove_reference_t<decltype(buffer)> sorted;
+			sorted.reserve(buffer.size());
+			for (std::uint32_t from : order) {
+				sorted.push_back(buffer[from]);
+			}
+			buffer.swap(sorted);
+		};
+		permute(_positions);
+		permute(_rotations);
+		permute(_scales);
+		permute(_world);
+		permute(_objects);
+		permute(_parents);
+		for (std::uint32_t slot = 0; slot < count; ++slot) {
+			if (_parents[slot] != NoParent) {
+				_parents[slot] = slots[_parents[slot]];
+			}
+			_objects[slot]->_transformBinding.Slot = slot;
+		}
+		BindAll();
+		_ordered = true;
+	}
+
+	/** Local
+	 * @brief Local transform of a managed object, throws invalid_argument if object is not in this system
+	 * @param object : managed GameObject
+	 * @return Position, Rotation and Scale
+	*/
+	Transform TransformSystem::Local(const GameObject& object) const
+	{
+		const std::uint32_t slot = SlotOf(object);
+		return Transform{ _positions[slot], _rotations[slot], _scales[slot] };
+	}
+
+	/** SetLocal
+	 * @brief Sets the local transform of a managed object, throws invalid_argument if object is not in this system
+	 * @param object : managed GameObject
+	 * @param transform : Position, Rotation and Scale
+	*/
+	void TransformSystem::SetLocal(GameObject& object, const Transform& transform)
+	{
+		const std::uint32_t slot = SlotOf(object);
+		_positions[slot] = transform.Position;
+		_rotations[slot] = transform.Rotation;
+		_scales[slot] = transform.Scale;
+		// Assigning the object may have pointed its attributes back at ObjTransform
+		Bind(slot);
+	}
+
+	/** World
+	 * @brief World matrix of a managed object as of the last Update, throws invalid_argument if object is not in this system
+	 * @param object : managed GameObject
+	 * @return parent world * local
+	*/
+	const glm::mat4& TransformSystem::World(const GameObject& object) const
+	{
+		return _world[SlotOf(object)];
+	}
+
+	std::uint32_t TransformSystem::SlotOf(const GameObject& object) const
+	{
+		if (object._transformBinding.System != this) {
+			throw std::invalid_argument("GameObject is not managed by this TransformSystem");
+		}
+		return object._transformBinding.Slot;
+	}
+
+	// Points the attributes of the object in slot at the slot
+	void TransformSystem::Bind(std::uint32_t slot)
+	{
+		View(*_objects[slot], &_positions[slot], &_rotations[slot], &_scales[slot]);
+	}
+
+	void TransformSystem::BindAll()
+	{
+		for (std::uint32_t slot = 0; slot < _objects.size(); ++slot) {
+			Bind(slot);
+		}
+	}
+
+	/** Release
+	 * @brief Copies object's transform back into ObjTransform and points its attributes there, the slot stays
+	 * @param object : managed GameObject
+	*/
+	void TransformSystem::Release(GameObject& object)
+	{
+		const std::uint32_t slot = object._transformBinding.Slot;
+		object.ObjTransform = Transform{ _positions[slot], _rotations[slot], _scales[slot] };
+		View(object, &object.ObjTransform.Position, &object.ObjTransform.Rotation, &object.ObjTransform.Scale);
+		object._transformBinding.System = nullptr;
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "GameObject.h"
+#include <vector>
+#include <cstdint>
+
+namespace Fiea::GameEngine {
+
+	/** TransformSystem
+	 * @brief Optional structure of arrays home for the transforms of many GameObjects. Positions, rotations, scales,
+	 * parent slots and world matrices each live in their own contiguous buffer, ordered so parents come before their
+	 * children, and Update computes every world matrix in one linear pass. The Position, Rotation and Scale attributes
+	 * of a managed object view its slot, so scripts and Actions writing them keep working; use GetTransform and
+	 * SetTransform instead of ObjTransform in code that may run on managed objects.
+	 * Rotation holds Euler angles in radians (x, y, z, applied x first), world = parent world * T * R * S.
+	*/
+	class TransformSystem final {
+	public:
+		TransformSystem() = default;
+		~TransformSystem();
+
+		// Objects point back at the system, which can't be copied or moved
+		TransformSystem(const TransformSystem& other) = delete;
+		TransformSystem& operator=(const TransformSystem& rhs) = delete;
+		TransformSystem(TransformSystem&& other) = delete;
+		TransformSystem& operator=(TransformSystem&& rhs) = delete;
+
+		void Add(GameObject& root);
+		void Remove(GameObject& object);
+		void Clear();
+
+		void Update();
+		void Invalidate() { _ordered = false; };
+
+		bool Contains(const GameObject& object) const { return object._transformBinding.System == this; };
+		std::size_t Size() const { return _objects.size(); };
+		void Reserve(std::size_t capacity);
+
+		Transform Local(const GameObject& object) const;
+		void SetLocal(GameObject& object, const Transform& transform);
+		const glm::mat4& World(const GameObject& object) const;
+
+	private:
+		static constexpr std::uint32_t NoParent = UINT32_MAX;
+
+		std::uint32_t SlotOf(const GameObject& object) const;
+		void AddTree(GameObject& object);
+		void Order();
+		void Bind(std::uint32_t slot);
+		void BindAll();
+		void Release(GameObject& object);
+
+		std::vector<glm::vec4> _positions;
+		std::vector<glm::vec4> _rotations;
+		std::vector<glm::vec4> _scales;
+		std::vector<glm::mat4> _world;
+		std::vector<std::uint32_t> _parents; // slot of the parent, always lower than the child's once ordered
+		std::vector<GameObject*> _objects;
+		bool _ordered = true; // false after objects were added, removed or reparented
+	};
+}
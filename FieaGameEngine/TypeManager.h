@@ -1,32 +1,88 @@
 #pragma once
 #include <unordered_map>
 #include <vector>
+#include <span>
+#include <algorithm>
 #include "Signature.h"
+#include "AttributeLayout.h"
 
 class TypeManager{
     public:
-        static const std::vector<Fiea::GameEngine::Signature>& get(size_t typeID)
+        // The type's Signature table as it was declared
+        static std::span<const Fiea::GameEngine::Signature> get(size_t typeID)
         {
-            assert(_map != nullptr);
-            return _map->at(typeID);
+            return _map.at(typeID).Signatures;
         }
 
-        static void add(size_t typeID, const std::vector<Fiea::GameEngine::Signature>& s)
+        // Prescribed attributes of the type and its registered ancestors, compiled when they were added
+        static const Fiea::GameEngine::AttributeLayout& layout(size_t typeID)
         {
-            //lazy initialization
-            if (_map == nullptr) _map = new std::unordered_map<size_t, std::vector<Fiea::GameEngine::Signature>>();
+            return _map.at(typeID).Layout;
+        }
 
-            auto ret = _map->insert(std::make_pair(typeID, s));
+        // Registers a type built at runtime on its own, its layout only holds these signatures. The registration
+        // keeps s and interns the names, so the vector doesn't have to stay alive
+        static void add(size_t typeID, std::vector<Fiea::GameEngine::Signature> s)
+        {
+            for (Fiea::GameEngine::Signature& signature : s) {
+                signature.Name = std::string_view(Fiea::GameEngine::Symbol(signature.Name).Name());
+            }
+            add(typeID, std::span<const Fiea::GameEngine::Signature>(), std::vector<size_t>{ typeID }, std::move(s));
+        }
 
-            assert(ret.second); // avoid double registration
+        // Registers T with T::Signatures(), T's layout also holds the signatures of every registered RTTI ancestor
+        template <typename T>
+        static void add()
+        {
+            std::vector<size_t> ancestry;
+            for (const Fiea::GameEngine::RTTI::IdType* id : T::AncestryClass()) {
+                ancestry.push_back(*id);
+            }
+            add(T::TypeIdClass(), T::Signatures(), std::move(ancestry));
         }
 
         static void Clear() {
-            if (_map != nullptr) {
-                _map->clear();
-            }
+            _map.clear();
         }
 
     private:
-        inline static std::unordered_map<size_t, std::vector<Fiea::GameEngine::Signature>>* _map;
+        struct Registration {
+            std::span<const Fiea::GameEngine::Signature> Signatures; // the type's static table, or Owned
+            std::vector<Fiea::GameEngine::Signature> Owned; // signatures of a type registered at runtime
+            std::vector<size_t> Ancestry; // root first, ending with the type itself
+            Fiea::GameEngine::AttributeLayout Layout;
+        };
+
+        static void add(size_t typeID, std::span<const Fiea::GameEngine::Signature> s, std::vector<size_t> ancestry,
+            std::vector<Fiea::GameEngine::Signature> owned = {})
+        {
+            auto ret = _map.insert(std::make_pair(typeID, Registration{ s, std::move(owned), std::move(ancestry), {} }));
+
+            assert(ret.second); // avoid double registration
+            Registration& added = ret.first->second;
+            if (!added.Owned.empty()) {
+                added.Signatures = added.Owned;
+            }
+
+            // Compile the layout of the new type and of every registered type derived from it
+            for (auto& [id, registration] : _map) {
+                if (std::find(registration.Ancestry.begin(), registration.Ancestry.end(), typeID) != registration.Ancestry.end()) {
+                    Compile(registration);
+                }
+            }
+        }
+
+        static void Compile(Registration& registration)
+        {
+            registration.Layout = Fiea::GameEngine::AttributeLayout();
+            for (size_t id : registration.Ancestry) {
+                auto ancestor = _map.find(id);
+                if (ancestor != _map.end()) {
+                    registration.Layout.Append(ancestor->second.Signatures, id);
+                }
+            }
+            registration.Layout.Seal();
+        }
+
+        inline static std::unordered_map<size_t, Registration> _map;
 };